@@ -161,11 +161,25 @@ public:
 		setGroups(groups, std::forward<F>(groupVisitor));
 	}
 
-	//! The presence of the temporary interleaved buffer is opt-in. Call this to create it.
+	/**
+	 * The presence of the temporary interleaved buffer is opt-in. Call this to create it.
+	 * Its contents are undefined until written, since it is not updated along with the planar buffers.
+	 */
 	void allocateInterleavedBuffer();
 
 	auto hasInterleavedBuffer() const -> bool { return !m_interleavedBuffer.empty(); }
 
+	/**
+	 * @returns true if the interleaved buffer currently holds the same data as the first channel group.
+	 *
+	 * NOTE: Calling code which writes to the planar buffers of the first channel group from outside of
+	 *       this class must reset this with `setInterleavedInSync(false)`.
+	 */
+	auto interleavedInSync() const -> bool { return m_interleavedInSync; }
+
+	//! Marks whether the interleaved buffer holds the same data as the first channel group
+	void setInterleavedInSync(bool inSync) { m_interleavedInSync = inSync; }
+
 	/**
 	 * @returns the number of bytes needed to allocate buffers with given frame and channel counts.
 	 *          Useful for preallocating a buffer for a shared memory resource.
@@ -395,11 +409,15 @@ private:
 
 	/**
 	 * Interleaved scratch buffer for conversions between interleaved and planar.
+	 * The planar buffers are authoritative, this one is not kept in sync with them.
 	 *
 	 * TODO: Remove once using planar only
 	 */
 	std::pmr::vector<float> m_interleavedBuffer;
 
+	//! Whether `m_interleavedBuffer` holds the same data as the first channel group
+	bool m_interleavedInSync = false;
+
 	//! Divides channels into arbitrary groups
 	ArrayVector<ChannelGroup, MaxGroupsPerAudioBuffer> m_groups;
 
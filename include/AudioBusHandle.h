@@ -31,6 +31,7 @@
 #include <QMutex>
 
 #include "AudioBuffer.h"
+#include "AudioEngineProfiler.h"
 #include "PlayHandle.h"
 
 namespace lmms
@@ -50,6 +51,9 @@ class BoolModel;
 	For processing, it adds all input play handles into an internal buffer,
 	processes the @ref EffectChain (if existing) on that buffer
 	and finally merges the buffer into its @ref MixerChannel.
+
+	Within the processing graph of a period, it gets queued as soon as the last of its
+	play handles has been processed, and in turn counts as an input of its @ref MixerChannel.
 */
 class AudioBusHandle : public ThreadableJob
 {
@@ -71,6 +75,9 @@ public:
 	const QString& name() const { return m_name; }
 	void setName(const QString& newName);
 
+	//! Collects the processing time of the bus handle and its play handles, i.e. of its track
+	AudioEngineProfiler::Node& profilerNode() { return m_profilerNode; }
+
 	EffectChain* effects() { return m_effects.get(); }
 	bool processEffects();
 
@@ -78,13 +85,29 @@ public:
 	void doProcessing() override;
 	bool requiresProcessing() const override { return true; }
 
+	// processing graph stuff
+	//! Resets the input count and registers as input of the mixer channel for the next period
+	void prepareGraph();
+	//! Registers a play handle that has to be processed before this bus handle
+	void addGraphInput() { ++m_graphInputs; }
+	bool hasGraphInputs() const { return m_graphInputs > 0; }
+	//! Called after one of the inputs has been processed. Queues this bus handle after the last one.
+	void graphInputProcessed();
+
 	void addPlayHandle(PlayHandle* handle);
 	void removePlayHandle(PlayHandle* handle);
 
 	//! @returns true if the processing outputted corrupted audio (infs/nans).
 	bool isCorrupted() const { return m_corrupted.load(std::memory_order_relaxed); }
 
+	//! Copy the output of every period (after effects, volume and panning) into @p buffer, which has to hold
+	//! one period. Periods without output are written as silence. Pass nullptr to stop copying.
+	void setOutputTap(SampleFrame* buffer) { m_outputTap = buffer; }
+
 private:
+	//! @returns true if any output was sent to the mixer
+	bool processAudio();
+
 	volatile bool m_bufferUsage;
 
 	AudioBuffer m_buffer;
@@ -92,6 +115,10 @@ private:
 	bool m_extOutputEnabled;
 	mix_ch_t m_nextMixerChannel;
 
+	// mixer channel and number of unprocessed play handles in the current period
+	mix_ch_t m_graphMixerChannel;
+	std::atomic_size_t m_graphInputs;
+
 	QString m_name;
 
 	std::unique_ptr<EffectChain> m_effects;
@@ -105,6 +132,10 @@ private:
 	
 	std::atomic<bool> m_corrupted = false;
 
+	SampleFrame* m_outputTap = nullptr;
+
+	AudioEngineProfiler::Node m_profilerNode{AudioEngineProfiler::NodeType::Track};
+
 	friend class AudioEngine;
 	friend class AudioEngineWorkerThread;
 };
@@ -160,6 +160,8 @@ public:
 
 
 	// play-handle stuff
+	//! Takes ownership of @p handle. Returns false if it was dropped instead, e.g. because
+	//! its buffer or the note play handle itself couldn't be allocated (then @p handle may be nullptr).
 	bool addPlayHandle( PlayHandle* handle );
 
 	void removePlayHandle( PlayHandle* handle );
@@ -358,10 +360,11 @@ private:
 	MidiClient * tryMidiClients();
 
 	void renderStageNoteSetup();
-	void renderStageInstruments();
-	void renderStageEffects();
+	void renderStageAudioGraph();
 	void renderStageMix();
 
+	void removeFinishedPlayHandles();
+
 
 	void swapBuffers();
 
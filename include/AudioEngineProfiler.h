@@ -27,6 +27,9 @@
 
 #include <array>
 #include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
 #include <QFile>
 
 #include "LmmsTypes.h"
@@ -89,6 +92,105 @@ public:
 		const AudioEngineProfiler::DetailType m_type;
 	};
 
+	//! Start timing the processing graph, in which instruments, effects and mixing overlap
+	void startGraph()
+	{
+		m_graphTimer.reset();
+		for (auto& end : m_graphDetailEnd) { end.store(0, std::memory_order_relaxed); }
+	}
+
+	//! Record that a job of the given type finished just now. Thread-safe.
+	void markGraphDetail(const DetailType type)
+	{
+		const auto elapsed = m_graphTimer.elapsed();
+		auto& end = m_graphDetailEnd[static_cast<std::size_t>(type)];
+		auto last = end.load(std::memory_order_relaxed);
+		while (last < elapsed && !end.compare_exchange_weak(last, elapsed, std::memory_order_relaxed)) {}
+	}
+
+	//! Account the graph's time to instruments, effects and mixing: each one
+	//! lasts from the end of the previous one until its last job finished
+	void finishGraph();
+
+	enum class NodeType {
+		Track,
+		Effect,
+		MixerChannel
+	};
+
+	//! Number of periods the per-node statistics are computed over
+	constexpr static auto NodeHistorySize = std::size_t{256};
+
+	//! Processing time of a single track, effect or mixer channel. It is embedded into the
+	//! profiled object, so recording neither allocates nor locks.
+	class Node
+	{
+	public:
+		Node(NodeType type);
+		~Node();
+		Node(const Node&) = delete;
+		Node& operator=(const Node&) = delete;
+
+		//! Set the name used in statistics. Not realtime safe.
+		void setName(const QString& name);
+
+		//! Add time spent processing within the current period. Thread-safe.
+		void addTime(int microseconds)
+		{
+			// time recorded in an earlier period that the profiler couldn't collect is dropped
+			const auto period = std::uint64_t{s_period.load(std::memory_order_relaxed)} << PeriodShift;
+			auto current = m_periodTime.load(std::memory_order_relaxed);
+			auto updated = std::uint64_t{0};
+			do
+			{
+				const auto time = (current & ~TimeMask) == period ? current & TimeMask : 0;
+				updated = period | ((time + microseconds) & TimeMask);
+			}
+			while (!m_periodTime.compare_exchange_weak(current, updated, std::memory_order_relaxed));
+		}
+
+	private:
+		//! The upper half of m_periodTime holds the period the time was recorded in, the lower half the time
+		static constexpr int PeriodShift = 32;
+		static constexpr std::uint64_t TimeMask = (std::uint64_t{1} << PeriodShift) - 1;
+
+		const NodeType m_type;
+		QString m_name;
+		std::atomic<std::uint64_t> m_periodTime = 0;
+		//! processing time of the last periods, indexed by the profiler's history position
+		std::array<std::atomic<int>, NodeHistorySize> m_history{};
+
+		friend class AudioEngineProfiler;
+	};
+
+	//! Adds the time from construction to destruction to a node
+	class NodeProbe
+	{
+	public:
+		NodeProbe(Node& node) : m_node(node) {}
+		~NodeProbe() { m_node.addTime(m_timer.elapsed()); }
+		NodeProbe& operator=(const NodeProbe&) = delete;
+		NodeProbe(const NodeProbe&) = delete;
+		NodeProbe(NodeProbe&&) = delete;
+
+	private:
+		Node& m_node;
+		MicroTimer m_timer;
+	};
+
+	//! Load of a single node in percent of the available time per period
+	struct NodeLoad
+	{
+		NodeType type;
+		QString name;
+		float average;
+		float percentile95;
+		float max;
+	};
+
+	//! @returns the load of all nodes over the last periods, highest maximum first. Not realtime safe.
+	std::vector<NodeLoad> nodeLoads() const;
+
 private:
 	void startDetail(const DetailType type) { m_detailTimer[static_cast<std::size_t>(type)].reset(); }
 	void finishDetail(const DetailType type)
@@ -96,6 +198,16 @@ private:
 		m_detailTime[static_cast<std::size_t>(type)] = m_detailTimer[static_cast<std::size_t>(type)].elapsed();
 	}
 
+	//! Store the time of all nodes in their history. Writes the busy nodes to the output file if the period overran.
+	void finishNodes(bool overrun);
+
+	// All existing nodes. The audio thread only try-locks the mutex and skips
+	// updating the statistics if another thread is (un)registering a node.
+	static std::vector<Node*> s_nodes;
+	static std::mutex s_nodesMutex;
+	//! Number of the current period, used to tag the time recorded by the nodes
+	static std::atomic<std::uint32_t> s_period;
+
 	MicroTimer m_periodTimer;
 	std::atomic<float> m_cpuLoad;
 	QFile m_outputFile;
@@ -104,6 +216,12 @@ private:
 	std::array<MicroTimer, DetailCount> m_detailTimer;
 	std::array<int, DetailCount> m_detailTime{0};
 	std::array<std::atomic<float>, DetailCount> m_detailLoad{0};
+
+	MicroTimer m_graphTimer;
+	std::array<std::atomic<int>, DetailCount> m_graphDetailEnd{};
+
+	std::size_t m_nodeHistoryIndex = 0;
+	std::atomic<int> m_timeLimit = 1;
 };
 
 } // namespace lmms
@@ -27,9 +27,15 @@
 
 #include <QThread>
 
+#include <array>
 #include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
 
-class QWaitCondition;
+#include "Hardware.h"
 
 namespace lmms
 {
@@ -51,29 +57,64 @@ public:
 			Dynamic	// jobs can be added while processing queue
 		} ;
 
+		//! Capacity of each worker's own queue
 		static constexpr size_t JOB_QUEUE_SIZE = 8192;
 
-		JobQueue() :
-			m_items(),
-			m_writeIndex( 0 ),
-			m_itemsDone( 0 ),
-			m_opMode( OperationMode::Static )
-		{
-			std::fill(m_items, m_items + JOB_QUEUE_SIZE, nullptr);
-		}
+		JobQueue() = default;
 
 		void reset( OperationMode _opMode );
 
-		void addJob( ThreadableJob * _job );
+		//! @returns false if the job doesn't require processing or couldn't be queued
+		bool addJob( ThreadableJob * _job );
 
-		void run();
+		//! Process jobs from the queue of @p worker first, then steal from the queues of the other workers
+		void run( std::size_t worker );
+		//! Wait until all jobs are done. The last finishing job wakes the waiting thread up, so after spinning
+		//! for a short while it doesn't need to poll the queue.
 		void wait();
 
+		//! Create a new per-worker queue and return its index. Must not be called while jobs are processed.
+		std::size_t addWorkerQueue();
+
 	private:
-		std::atomic<ThreadableJob*> m_items[JOB_QUEUE_SIZE];
-		std::atomic_size_t m_writeIndex;
-		std::atomic_size_t m_itemsDone;
-		OperationMode m_opMode;
+		//! Bounded queue belonging to a single worker. Jobs are pushed by the owner
+		//! (or distributed round-robin when added from outside the workers) and
+		//! claimed through an atomic head index by the owner and by stealing workers.
+		class WorkerQueue
+		{
+		public:
+			WorkerQueue()
+			{
+				for (auto& item : m_items) { item.store(nullptr, std::memory_order_relaxed); }
+			}
+
+			bool push(ThreadableJob* job);
+			ThreadableJob* pop();
+			void reset();
+
+		private:
+			//! The lower half of head and tail indexes m_items, the upper half counts the resets of the
+			//! queue. This way a worker that is still in pop() from before a reset can't claim a slot
+			//! of the next batch.
+			static constexpr int GENERATION_SHIFT = 32;
+			static constexpr std::uint64_t INDEX_MASK = (std::uint64_t{1} << GENERATION_SHIFT) - 1;
+
+			alignas(hardware_destructive_interference_size) std::atomic<std::uint64_t> m_head = 0;
+			alignas(hardware_destructive_interference_size) std::atomic<std::uint64_t> m_tail = 0;
+			std::array<std::atomic<ThreadableJob*>, JOB_QUEUE_SIZE> m_items;
+		};
+
+		void jobDone();
+
+		std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+		std::atomic_size_t m_nextQueue = 0;
+		alignas(hardware_destructive_interference_size) std::atomic_size_t m_itemsQueued = 0;
+		alignas(hardware_destructive_interference_size) std::atomic_size_t m_itemsDone = 0;
+		std::atomic<OperationMode> m_opMode = OperationMode::Static;
+
+		std::atomic<bool> m_waiting = false;
+		std::mutex m_doneMutex;
+		std::condition_variable m_doneCond;
 	} ;
 
 
@@ -88,9 +129,9 @@ public:
 		globalJobQueue.reset( _opMode );
 	}
 
-	static void addJob( ThreadableJob * _job )
+	static bool addJob( ThreadableJob * _job )
 	{
-		globalJobQueue.addJob( _job );
+		return globalJobQueue.addJob( _job );
 	}
 
 	// a convenient helper function allowing to pass a container with pointers
@@ -112,11 +153,14 @@ public:
 private:
 	void run() override;
 
+	//! Spin for a short while waiting for the next batch of jobs, then park until woken
+	static void waitForJobs( std::size_t& lastBatch );
+
 	static JobQueue globalJobQueue;
-	static QWaitCondition * queueReadyWaitCond;
 	static QList<AudioEngineWorkerThread *> workerThreads;
 
-	volatile bool m_quit;
+	std::size_t m_index;
+	std::atomic<bool> m_quit;
 } ;
 
 } // namespace lmms
@@ -27,6 +27,7 @@
 #ifndef LMMS_AUTOMATION_CLIP_H
 #define LMMS_AUTOMATION_CLIP_H
 
+#include <atomic>
 #include <QMap>
 #include <QPointer>
 
@@ -37,6 +38,7 @@
 namespace lmms
 {
 
+class AutomationCurve;
 class AutomationTrack;
 class TimePos;
 
@@ -65,7 +67,7 @@ public:
 	using TimemapIterator = timeMap::const_iterator;
 
 	AutomationClip( AutomationTrack * _auto_track );
-	~AutomationClip() override = default;
+	~AutomationClip() override;
 
 	bool addObject( AutomatableModel * _obj, bool _search_dup = true );
 
@@ -214,6 +216,13 @@ private:
 	void generateTangents();
 	void generateTangents(timeMap::iterator it, int numToGenerate);
 	float valueAt( timeMap::const_iterator v, int offset ) const;
+	//! Publishes a new curve for valueAt(); must be called after every change to the nodes, the progression or the tension
+	void updateCurve();
+
+	//! Defer rebuilding the curve until the outermost batch ends, so editing many nodes only rebuilds it once.
+	//! Hold m_clipMutex for the whole batch, or other threads' edits are deferred along with it.
+	void beginCurveUpdateBatch();
+	void endCurveUpdateBatch();
 
 	/**
 	 * @brief
@@ -228,6 +237,12 @@ private:
 	// Mutable so we can lock it from const objects
 	mutable QRecursiveMutex m_clipMutex;
 
+	// Snapshot of the nodes read by valueAt(), so playback never waits for the mutex.
+	// Replaced curves are handed to AutomationCurve::retire(), since valueAt() may still be reading them.
+	std::atomic<const AutomationCurve*> m_curve = nullptr;
+	int m_curveUpdateBatchDepth = 0;
+	bool m_curveOutdated = false;
+
 	AutomationTrack * m_autoTrack;
 	std::vector<jo_id_t> m_idsToResolve;
 	objectVector m_objects;
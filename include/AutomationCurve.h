@@ -0,0 +1,86 @@
+/*
+ * AutomationCurve.h - flattened automation clip nodes for lock-free lookups
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_AUTOMATION_CURVE_H
+#define LMMS_AUTOMATION_CURVE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "AutomationClip.h"
+
+namespace lmms
+{
+
+/**
+	The nodes of an automation clip flattened into an array, with the shape of
+	every segment precomputed, for evaluating the clip without locking it.
+
+	A curve is never modified. Whenever the nodes, the progression type or the
+	tension of the clip change, the clip builds a new curve and publishes it
+	atomically, so the audio thread always sees a consistent one. The replaced
+	curve is retired and deleted between two periods of the audio engine.
+*/
+class AutomationCurve
+{
+public:
+	AutomationCurve(const AutomationClip::timeMap& nodes,
+		AutomationClip::ProgressionType progressionType, float tension);
+
+	//! Same result as AutomationClip::valueAt(), O(1) when called with increasing or repeated times
+	float valueAt(int time) const;
+
+	//! Deletes a curve that was replaced, once the audio engine can no longer be reading it.
+	//! Safe to call from any thread; the curves are deleted on the main thread.
+	static void retire(const AutomationCurve* curve);
+
+private:
+	static void deleteRetired();
+
+	struct Node
+	{
+		int pos;
+		float inValue;
+		float outValue;
+		//! Linear slope of the segment to the next node
+		float slope;
+		//! Hermite tangents of the segment to the next node, scaled by its length and the tension
+		float m1;
+		float m2;
+	};
+
+	//! Index of the last node at or before @p time, or -1 if @p time is before the first node
+	std::ptrdiff_t find(int time) const;
+
+	std::vector<Node> m_nodes;
+	AutomationClip::ProgressionType m_progressionType;
+
+	//! Node found by the last lookup. Only a hint, so concurrent lookups may overwrite each other freely.
+	mutable std::atomic<std::size_t> m_cursor = 0;
+};
+
+} // namespace lmms
+
+#endif // LMMS_AUTOMATION_CURVE_H
@@ -38,6 +38,7 @@
 
 #include "lmms_constants.h"
 #include "LmmsTypes.h"
+#include "SampleFrame.h"
 
 
 namespace lmms
@@ -181,8 +182,6 @@ public:
 private:
 	float m_a1, m_a2, m_b0, m_b1, m_b2;
 	float m_z1 [CHANNELS], m_z2 [CHANNELS];
-	
-	friend class BasicFilters<CHANNELS>; // needed for subfilter stuff in BasicFilters
 };
 using StereoBiQuad = BiQuad<2>;
 
@@ -259,20 +258,29 @@ public:
 		return( 0.01f );
 	}
 
+	//! Number of frames after which process() recomputes the coefficients it interpolates
+	static constexpr f_cnt_t CoeffInterpolationFrames = 16;
+
 	inline void setFilterType( const FilterType _idx )
 	{
-		m_doubleFilter = _idx == FilterType::DoubleLowPass || _idx == FilterType::DoubleMoog;
+		const bool doubleFilter = _idx == FilterType::DoubleLowPass || _idx == FilterType::DoubleMoog;
+
+		// Double lowpass mode, backwards-compat for the goofy
+		// Add-NumFilters to signify doubleFilter stuff
+		const FilterType type = !doubleFilter
+			? _idx
+			: _idx == FilterType::DoubleLowPass ? FilterType::LowPass : FilterType::Moog;
+
+		// the coefficients of another filter type mean nothing to this one
+		if (type != m_type) { m_coeffsValid = false; }
+
+		m_type = type;
+		m_doubleFilter = doubleFilter;
 		if( !m_doubleFilter )
 		{
-			m_type = _idx;
 			return;
 		}
 
-		// Double lowpass mode, backwards-compat for the goofy
-		// Add-NumFilters to signify doubleFilter stuff
-		m_type = _idx == FilterType::DoubleLowPass 
-			? FilterType::LowPass
-			: FilterType::Moog;
 		if( m_subFilter == nullptr )
 		{
 			m_subFilter = new BasicFilters<CHANNELS>(
@@ -283,6 +291,7 @@ public:
 	}
 
 	inline BasicFilters( const sample_rate_t _sample_rate ) :
+		m_type( FilterType::LowPass ),
 		m_doubleFilter( false ),
 		m_sampleRate( (float) _sample_rate ),
 		m_sampleRatio( 1.0f / m_sampleRate ),
@@ -298,12 +307,12 @@ public:
 
 	inline void clearHistory()
 	{
-		// reset in/out history for biquads
-		m_biQuad.clearHistory();
-
 		// reset in/out history
 		for( ch_cnt_t _chnl = 0; _chnl < CHANNELS; ++_chnl )
 		{
+			// reset in/out history for biquads
+			m_biQuadZ1[_chnl] = m_biQuadZ2[_chnl] = 0.0f;
+
 			// reset in/out history for moog-filter
 			m_y1[_chnl] = m_y2[_chnl] = m_y3[_chnl] = m_y4[_chnl] =
 					m_oldx[_chnl] = m_oldy1[_chnl] =
@@ -338,27 +347,208 @@ public:
 	}
 
 	inline sample_t update( sample_t _in0, ch_cnt_t _chnl )
+	{
+		return dispatch([&](auto type) { return updateSample<decltype(type)::value>(_in0, _chnl, m_coeffs); });
+	}
+
+	//! Filters @p frames frames of @p buffer in place with the current coefficients
+	inline void process(SampleFrame* buffer, f_cnt_t frames) requires (CHANNELS == DEFAULT_CHANNELS)
+	{
+		dispatch([&](auto type) {
+			processFrames<decltype(type)::value, false>(buffer, frames, m_coeffs, m_coeffs);
+		});
+	}
+
+	//! Filters @p frames frames of @p buffer in place while following the cutoff frequency @p freq
+	//! and resonance @p q given for each frame. Instead of recomputing the coefficients for every
+	//! frame, they are computed every CoeffInterpolationFrames frames and interpolated linearly in between.
+	inline void process(SampleFrame* buffer, f_cnt_t frames, const float* freq, const float* q)
+		requires (CHANNELS == DEFAULT_CHANNELS)
+	{
+		dispatch([&](auto type) {
+			for (f_cnt_t offset = 0; offset < frames; offset += CoeffInterpolationFrames)
+			{
+				const f_cnt_t count = std::min(CoeffInterpolationFrames, frames - offset);
+				const f_cnt_t last = offset + count - 1;
+
+				const bool interpolate = m_coeffsValid;
+				auto coeffs = m_coeffs;
+				calcFilterCoeffs(freq[last], q[last]);
+				if (!interpolate) { coeffs = m_coeffs; }
+
+				using Set = decltype(coeffSetOf<decltype(type)::value>());
+				processFrames<decltype(type)::value, true>(buffer + offset, count, coeffs,
+					Set::step(coeffs, m_coeffs, count));
+			}
+		});
+	}
+
+
+private:
+	//! All coefficients of the filter, of which each type only uses some
+	struct Coefficients
+	{
+		// biquad filter
+		float a1 = 0.0f, a2 = 0.0f, b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+
+		// moog-filter
+		float r = 0.0f, p = 0.0f, k = 0.0f;
+
+		// RC-type-filters
+		float rca = 0.0f, rcb = 0.0f, rcc = 0.0f, rcq = 0.0f;
+
+		// formant-filters
+		std::array<float, 2> vfa = {}, vfb = {}, vfc = {};
+		float vfq = 0.0f;
+
+		// Lowpass_SV (state-variant lowpass)
+		float svf1 = 0.0f, svf2 = 0.0f, svq = 0.0f;
+	};
+
+	//! A set of coefficients which process() interpolates. Only the ones used by the current filter type
+	//! are touched, so the compiler can keep them in registers.
+	template<auto... Members>
+	struct CoeffSet
+	{
+		static inline Coefficients step(const Coefficients& from, const Coefficients& to, f_cnt_t frames)
+		{
+			auto result = Coefficients{};
+			(difference(result.*Members, from.*Members, to.*Members, frames), ...);
+			return result;
+		}
+
+		static inline void advance(Coefficients& coeffs, const Coefficients& step)
+		{
+			(add(coeffs.*Members, step.*Members), ...);
+		}
+	};
+
+	static inline void difference(float& result, float from, float to, f_cnt_t frames)
+	{
+		result = (to - from) / frames;
+	}
+
+	template<std::size_t N>
+	static inline void difference(std::array<float, N>& result, const std::array<float, N>& from,
+		const std::array<float, N>& to, f_cnt_t frames)
+	{
+		for (std::size_t i = 0; i < N; ++i) { difference(result[i], from[i], to[i], frames); }
+	}
+
+	static inline void add(float& coeff, float step)
+	{
+		coeff += step;
+	}
+
+	template<std::size_t N>
+	static inline void add(std::array<float, N>& coeffs, const std::array<float, N>& step)
+	{
+		for (std::size_t i = 0; i < N; ++i) { coeffs[i] += step[i]; }
+	}
+
+	template<FilterType Type>
+	static constexpr auto coeffSetOf()
+	{
+		using C = Coefficients;
+		if constexpr (Type == FilterType::Moog || Type == FilterType::Tripole)
+		{
+			return CoeffSet<&C::r, &C::p, &C::k>{};
+		}
+		else if constexpr (Type == FilterType::Lowpass_RC12 || Type == FilterType::Bandpass_RC12
+			|| Type == FilterType::Highpass_RC12 || Type == FilterType::Lowpass_RC24
+			|| Type == FilterType::Bandpass_RC24 || Type == FilterType::Highpass_RC24)
+		{
+			return CoeffSet<&C::rca, &C::rcb, &C::rcc, &C::rcq>{};
+		}
+		else if constexpr (Type == FilterType::Formantfilter || Type == FilterType::FastFormant)
+		{
+			return CoeffSet<&C::vfa, &C::vfb, &C::vfc, &C::vfq>{};
+		}
+		else if constexpr (Type == FilterType::Lowpass_SV || Type == FilterType::Bandpass_SV
+			|| Type == FilterType::Highpass_SV || Type == FilterType::Notch_SV)
+		{
+			return CoeffSet<&C::svf1, &C::svf2, &C::svq>{};
+		}
+		else
+		{
+			return CoeffSet<&C::a1, &C::a2, &C::b0, &C::b1, &C::b2>{};
+		}
+	}
+
+	//! Calls @p func with the current filter type as std::integral_constant,
+	//! so the per-frame code is compiled for each filter type without branching on it
+	template<typename Func>
+	inline decltype(auto) dispatch(Func&& func)
+	{
+		const auto call = [&]<FilterType Type>() {
+			return func(std::integral_constant<FilterType, Type>{});
+		};
+
+		// the double filters are set up as LowPass or Moog with a sub filter
+		switch (m_type)
+		{
+			case FilterType::HiPass: return call.template operator()<FilterType::HiPass>();
+			case FilterType::BandPass_CSG: return call.template operator()<FilterType::BandPass_CSG>();
+			case FilterType::BandPass_CZPG: return call.template operator()<FilterType::BandPass_CZPG>();
+			case FilterType::Notch: return call.template operator()<FilterType::Notch>();
+			case FilterType::AllPass: return call.template operator()<FilterType::AllPass>();
+			case FilterType::Moog: return call.template operator()<FilterType::Moog>();
+			case FilterType::Lowpass_RC12: return call.template operator()<FilterType::Lowpass_RC12>();
+			case FilterType::Bandpass_RC12: return call.template operator()<FilterType::Bandpass_RC12>();
+			case FilterType::Highpass_RC12: return call.template operator()<FilterType::Highpass_RC12>();
+			case FilterType::Lowpass_RC24: return call.template operator()<FilterType::Lowpass_RC24>();
+			case FilterType::Bandpass_RC24: return call.template operator()<FilterType::Bandpass_RC24>();
+			case FilterType::Highpass_RC24: return call.template operator()<FilterType::Highpass_RC24>();
+			case FilterType::Formantfilter: return call.template operator()<FilterType::Formantfilter>();
+			case FilterType::Lowpass_SV: return call.template operator()<FilterType::Lowpass_SV>();
+			case FilterType::Bandpass_SV: return call.template operator()<FilterType::Bandpass_SV>();
+			case FilterType::Highpass_SV: return call.template operator()<FilterType::Highpass_SV>();
+			case FilterType::Notch_SV: return call.template operator()<FilterType::Notch_SV>();
+			case FilterType::FastFormant: return call.template operator()<FilterType::FastFormant>();
+			case FilterType::Tripole: return call.template operator()<FilterType::Tripole>();
+			default: return call.template operator()<FilterType::LowPass>();
+		}
+	}
+
+	//! Per-frame loop of process(). The channels of a frame are independent, so the compiler can
+	//! vectorize the filters across them.
+	template<FilterType Type, bool Interpolate>
+	inline void processFrames(SampleFrame* buffer, f_cnt_t frames, Coefficients coeffs, const Coefficients& step)
+	{
+		for (f_cnt_t frame = 0; frame < frames; ++frame)
+		{
+			if constexpr (Interpolate) { decltype(coeffSetOf<Type>())::advance(coeffs, step); }
+
+			for (ch_cnt_t ch = 0; ch < CHANNELS; ++ch)
+			{
+				buffer[frame][ch] = updateSample<Type>(buffer[frame][ch], ch, coeffs);
+			}
+		}
+	}
+
+	template<FilterType Type>
+	inline sample_t updateSample(sample_t _in0, ch_cnt_t _chnl, const Coefficients& c)
 	{
 		sample_t out = 0.0f;
-		switch( m_type )
+		switch (Type)
 		{
 			case FilterType::Moog:
 			{
-				sample_t x = _in0 - m_r*m_y4[_chnl];
+				sample_t x = _in0 - c.r*m_y4[_chnl];
 
 				// four cascaded onepole filters
 				// (bilinear transform)
-				m_y1[_chnl] = std::clamp((x + m_oldx[_chnl]) * m_p
-							- m_k * m_y1[_chnl], -10.0f,
+				m_y1[_chnl] = std::clamp((x + m_oldx[_chnl]) * c.p
+							- c.k * m_y1[_chnl], -10.0f,
 								10.0f);
-				m_y2[_chnl] = std::clamp((m_y1[_chnl] + m_oldy1[_chnl]) * m_p
-							- m_k * m_y2[_chnl], -10.0f,
+				m_y2[_chnl] = std::clamp((m_y1[_chnl] + m_oldy1[_chnl]) * c.p
+							- c.k * m_y2[_chnl], -10.0f,
 								10.0f);
-				m_y3[_chnl] = std::clamp((m_y2[_chnl] + m_oldy2[_chnl]) * m_p
-							- m_k * m_y3[_chnl], -10.0f,
+				m_y3[_chnl] = std::clamp((m_y2[_chnl] + m_oldy2[_chnl]) * c.p
+							- c.k * m_y3[_chnl], -10.0f,
 								10.0f );
-				m_y4[_chnl] = std::clamp((m_y3[_chnl] + m_oldy3[_chnl]) * m_p
-							- m_k * m_y4[_chnl], -10.0f,
+				m_y4[_chnl] = std::clamp((m_y3[_chnl] + m_oldy3[_chnl]) * c.p
+							- c.k * m_y4[_chnl], -10.0f,
 								10.0f);
 
 				m_oldx[_chnl] = x;
@@ -378,16 +568,16 @@ public:
 				for( int i = 0; i < 4; ++i )
 				{
 					ip += 0.25f;
-					sample_t x = std::lerp(m_last[_chnl], _in0, ip) - m_r * m_y3[_chnl];
+					sample_t x = std::lerp(m_last[_chnl], _in0, ip) - c.r * m_y3[_chnl];
 					
-					m_y1[_chnl] = std::clamp((x + m_oldx[_chnl]) * m_p
-							- m_k * m_y1[_chnl], -10.0f,
+					m_y1[_chnl] = std::clamp((x + m_oldx[_chnl]) * c.p
+							- c.k * m_y1[_chnl], -10.0f,
 								10.0f);
-					m_y2[_chnl] = std::clamp((m_y1[_chnl] + m_oldy1[_chnl]) * m_p
-								- m_k * m_y2[_chnl], -10.0f,
+					m_y2[_chnl] = std::clamp((m_y1[_chnl] + m_oldy1[_chnl]) * c.p
+								- c.k * m_y2[_chnl], -10.0f,
 									10.0f);
-					m_y3[_chnl] = std::clamp((m_y2[_chnl] + m_oldy2[_chnl]) * m_p
-								- m_k * m_y3[_chnl], -10.0f,
+					m_y3[_chnl] = std::clamp((m_y2[_chnl] + m_oldy2[_chnl]) * c.p
+								- c.k * m_y3[_chnl], -10.0f,
 									10.0f);
 					m_oldx[_chnl] = x;
 					m_oldy1[_chnl] = m_y1[_chnl];
@@ -411,17 +601,17 @@ public:
 				
 				for( int i = 0; i < 2; ++i ) // 2x oversample
 				{
-					m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];				/* delay2/4 = lowpass output */
-					highpass = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
-					m_delay1[_chnl] = m_svf1 * highpass + m_delay1[_chnl];           			/* delay1/3 = bandpass output */
+					m_delay2[_chnl] = m_delay2[_chnl] + c.svf1 * m_delay1[_chnl];				/* delay2/4 = lowpass output */
+					highpass = _in0 - m_delay2[_chnl] - c.svq * m_delay1[_chnl];
+					m_delay1[_chnl] = c.svf1 * highpass + m_delay1[_chnl];           			/* delay1/3 = bandpass output */
 
-					m_delay4[_chnl] = m_delay4[_chnl] + m_svf2 * m_delay3[_chnl];
-					highpass = m_delay2[_chnl] - m_delay4[_chnl] - m_svq * m_delay3[_chnl];
-					m_delay3[_chnl] = m_svf2 * highpass + m_delay3[_chnl];
+					m_delay4[_chnl] = m_delay4[_chnl] + c.svf2 * m_delay3[_chnl];
+					highpass = m_delay2[_chnl] - m_delay4[_chnl] - c.svq * m_delay3[_chnl];
+					m_delay3[_chnl] = c.svf2 * highpass + m_delay3[_chnl];
 				}
 
 				/* mix filter output into output buffer */
-				return m_type == FilterType::Lowpass_SV 
+				return Type == FilterType::Lowpass_SV 
 					? m_delay4[_chnl]
 					: m_delay3[_chnl];
 			}
@@ -431,9 +621,9 @@ public:
 				float hp;
 				for( int i = 0; i < 2; ++i ) // 2x oversample
 				{				
-					m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];
-					hp = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
-					m_delay1[_chnl] = m_svf1 * hp + m_delay1[_chnl];
+					m_delay2[_chnl] = m_delay2[_chnl] + c.svf1 * m_delay1[_chnl];
+					hp = _in0 - m_delay2[_chnl] - c.svq * m_delay1[_chnl];
+					m_delay1[_chnl] = c.svf1 * hp + m_delay1[_chnl];
 				}
 				
 				return hp;
@@ -444,13 +634,13 @@ public:
 				float hp1;
 				for( int i = 0; i < 2; ++i ) // 2x oversample
 				{
-					m_delay2[_chnl] = m_delay2[_chnl] + m_svf1 * m_delay1[_chnl];				/* delay2/4 = lowpass output */
-					hp1 = _in0 - m_delay2[_chnl] - m_svq * m_delay1[_chnl];
-					m_delay1[_chnl] = m_svf1 * hp1 + m_delay1[_chnl];           			/* delay1/3 = bandpass output */
+					m_delay2[_chnl] = m_delay2[_chnl] + c.svf1 * m_delay1[_chnl];				/* delay2/4 = lowpass output */
+					hp1 = _in0 - m_delay2[_chnl] - c.svq * m_delay1[_chnl];
+					m_delay1[_chnl] = c.svf1 * hp1 + m_delay1[_chnl];           			/* delay1/3 = bandpass output */
 
-					m_delay4[_chnl] = m_delay4[_chnl] + m_svf2 * m_delay3[_chnl];
-					float hp2 = m_delay2[_chnl] - m_delay4[_chnl] - m_svq * m_delay3[_chnl];
-					m_delay3[_chnl] = m_svf2 * hp2 + m_delay3[_chnl];
+					m_delay4[_chnl] = m_delay4[_chnl] + c.svf2 * m_delay3[_chnl];
+					float hp2 = m_delay2[_chnl] - m_delay4[_chnl] - c.svq * m_delay3[_chnl];
+					m_delay3[_chnl] = c.svf2 * hp2 + m_delay3[_chnl];
 				}
 
 				/* mix filter output into output buffer */
@@ -468,16 +658,16 @@ public:
 				sample_t lp = 0.0f;
 				for( int n = 4; n != 0; --n )
 				{
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
+					sample_t in = _in0 + m_rcbp0[_chnl] * c.rcq;
 					in = std::clamp(in, -1.0f, 1.0f);
 
-					lp = in * m_rcb + m_rclp0[_chnl] * m_rca;
+					lp = in * c.rcb + m_rclp0[_chnl] * c.rca;
 					lp = std::clamp(lp, -1.0f, 1.0f);
 
-					sample_t hp = m_rcc * (m_rchp0[_chnl] + in - m_rclast0[_chnl]);
+					sample_t hp = c.rcc * (m_rchp0[_chnl] + in - m_rclast0[_chnl]);
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					sample_t bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
+					sample_t bp = hp * c.rcb + m_rcbp0[_chnl] * c.rca;
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_rclast0[_chnl] = in;
@@ -493,20 +683,20 @@ public:
 				sample_t hp, bp;
 				for( int n = 4; n != 0; --n )
 				{
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
+					sample_t in = _in0 + m_rcbp0[_chnl] * c.rcq;
 					in = std::clamp(in, -1.0f, 1.0f);
 
-					hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
+					hp = c.rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
+					bp = hp * c.rcb + m_rcbp0[_chnl] * c.rca;
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_rclast0[_chnl] = in;
 					m_rchp0[_chnl] = hp;
 					m_rcbp0[_chnl] = bp;
 				}
-				return m_type == FilterType::Highpass_RC12 ? hp : bp;
+				return Type == FilterType::Highpass_RC12 ? hp : bp;
 			}
 
 			case FilterType::Lowpass_RC24:
@@ -515,16 +705,16 @@ public:
 				for( int n = 4; n != 0; --n )
 				{
 					// first stage is as for the 12dB case...
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
+					sample_t in = _in0 + m_rcbp0[_chnl] * c.rcq;
 					in = std::clamp(in, -1.0f, 1.0f);
 
-					lp = in * m_rcb + m_rclp0[_chnl] * m_rca;
+					lp = in * c.rcb + m_rclp0[_chnl] * c.rca;
 					lp = std::clamp(lp, -1.0f, 1.0f);
 
-					sample_t hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
+					sample_t hp = c.rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					sample_t bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
+					sample_t bp = hp * c.rcb + m_rcbp0[_chnl] * c.rca;
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_rclast0[_chnl] = in;
@@ -533,16 +723,16 @@ public:
 					m_rchp0[_chnl] = hp;
 
 					// second stage gets the output of the first stage as input...
-					in = lp + m_rcbp1[_chnl] * m_rcq;
+					in = lp + m_rcbp1[_chnl] * c.rcq;
 					in = std::clamp(in, -1.0f, 1.0f );
 
-					lp = in * m_rcb + m_rclp1[_chnl] * m_rca;
+					lp = in * c.rcb + m_rclp1[_chnl] * c.rca;
 					lp = std::clamp(lp, -1.0f, 1.0f);
 
-					hp = m_rcc * ( m_rchp1[_chnl] + in - m_rclast1[_chnl] );
+					hp = c.rcc * ( m_rchp1[_chnl] + in - m_rclast1[_chnl] );
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_rcb + m_rcbp1[_chnl] * m_rca;
+					bp = hp * c.rcb + m_rcbp1[_chnl] * c.rca;
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_rclast1[_chnl] = in;
@@ -559,13 +749,13 @@ public:
 				for( int n = 4; n != 0; --n )
 				{
 					// first stage is as for the 12dB case...
-					sample_t in = _in0 + m_rcbp0[_chnl] * m_rcq;
+					sample_t in = _in0 + m_rcbp0[_chnl] * c.rcq;
 					in = std::clamp(in, -1.0f, 1.0f);
 
-					hp = m_rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
+					hp = c.rcc * ( m_rchp0[_chnl] + in - m_rclast0[_chnl] );
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_rcb + m_rcbp0[_chnl] * m_rca;
+					bp = hp * c.rcb + m_rcbp0[_chnl] * c.rca;
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_rclast0[_chnl] = in;
@@ -573,23 +763,23 @@ public:
 					m_rcbp0[_chnl] = bp;
 
 					// second stage gets the output of the first stage as input...
-					in = m_type == FilterType::Highpass_RC24
-						? hp + m_rcbp1[_chnl] * m_rcq
-						: bp + m_rcbp1[_chnl] * m_rcq;
+					in = Type == FilterType::Highpass_RC24
+						? hp + m_rcbp1[_chnl] * c.rcq
+						: bp + m_rcbp1[_chnl] * c.rcq;
 
 					in = std::clamp(in, -1.0f, 1.0f);
 
-					hp = m_rcc * ( m_rchp1[_chnl] + in - m_rclast1[_chnl] );
+					hp = c.rcc * ( m_rchp1[_chnl] + in - m_rclast1[_chnl] );
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_rcb + m_rcbp1[_chnl] * m_rca;
+					bp = hp * c.rcb + m_rcbp1[_chnl] * c.rca;
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_rclast1[_chnl] = in;
 					m_rchp1[_chnl] = hp;
 					m_rcbp1[_chnl] = bp;
 				}
-				return m_type == FilterType::Highpass_RC24 ? hp : bp;
+				return Type == FilterType::Highpass_RC24 ? hp : bp;
 			}
 
 			case FilterType::Formantfilter:
@@ -597,43 +787,43 @@ public:
 			{
 				if (std::abs(_in0) < F_EPSILON && std::abs(m_vflast[0][_chnl]) < F_EPSILON) { return 0.0f; } // performance hack - skip processing when the numbers get too small
 
-				const int os = m_type == FilterType::FastFormant ? 1 : 4; // no oversampling for fast formant
+				const int os = Type == FilterType::FastFormant ? 1 : 4; // no oversampling for fast formant
 				for( int o = 0; o < os; ++o )
 				{
 					// first formant
-					sample_t in = _in0 + m_vfbp[0][_chnl] * m_vfq;
+					sample_t in = _in0 + m_vfbp[0][_chnl] * c.vfq;
 					in = std::clamp(in, -1.0f, 1.0f);
 
-					sample_t hp = m_vfc[0] * ( m_vfhp[0][_chnl] + in - m_vflast[0][_chnl] );
+					sample_t hp = c.vfc[0] * ( m_vfhp[0][_chnl] + in - m_vflast[0][_chnl] );
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					sample_t bp = hp * m_vfb[0] + m_vfbp[0][_chnl] * m_vfa[0];
+					sample_t bp = hp * c.vfb[0] + m_vfbp[0][_chnl] * c.vfa[0];
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_vflast[0][_chnl] = in;
 					m_vfhp[0][_chnl] = hp;
 					m_vfbp[0][_chnl] = bp;
 
-					in = bp + m_vfbp[2][_chnl] * m_vfq;
+					in = bp + m_vfbp[2][_chnl] * c.vfq;
 					in = std::clamp(in, -1.0f, 1.0f);
 
-					hp = m_vfc[0] * ( m_vfhp[2][_chnl] + in - m_vflast[2][_chnl] );
+					hp = c.vfc[0] * ( m_vfhp[2][_chnl] + in - m_vflast[2][_chnl] );
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_vfb[0] + m_vfbp[2][_chnl] * m_vfa[0];
+					bp = hp * c.vfb[0] + m_vfbp[2][_chnl] * c.vfa[0];
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_vflast[2][_chnl] = in;
 					m_vfhp[2][_chnl] = hp;
 					m_vfbp[2][_chnl] = bp;
 
-					in = bp + m_vfbp[4][_chnl] * m_vfq;
+					in = bp + m_vfbp[4][_chnl] * c.vfq;
 					in = std::clamp(in, -1.0f, 1.0f);
 
-					hp = m_vfc[0] * ( m_vfhp[4][_chnl] + in - m_vflast[4][_chnl] );
+					hp = c.vfc[0] * ( m_vfhp[4][_chnl] + in - m_vflast[4][_chnl] );
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_vfb[0] + m_vfbp[4][_chnl] * m_vfa[0];
+					bp = hp * c.vfb[0] + m_vfbp[4][_chnl] * c.vfa[0];
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_vflast[4][_chnl] = in;
@@ -643,39 +833,39 @@ public:
 					out += bp;
 
 					// second formant
-					in = _in0 + m_vfbp[0][_chnl] * m_vfq;
+					in = _in0 + m_vfbp[0][_chnl] * c.vfq;
 					in = std::clamp(in, -1.0f, 1.0f);
 
-					hp = m_vfc[1] * ( m_vfhp[1][_chnl] + in - m_vflast[1][_chnl] );
+					hp = c.vfc[1] * ( m_vfhp[1][_chnl] + in - m_vflast[1][_chnl] );
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_vfb[1] + m_vfbp[1][_chnl] * m_vfa[1];
+					bp = hp * c.vfb[1] + m_vfbp[1][_chnl] * c.vfa[1];
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_vflast[1][_chnl] = in;
 					m_vfhp[1][_chnl] = hp;
 					m_vfbp[1][_chnl] = bp;
 
-					in = bp + m_vfbp[3][_chnl] * m_vfq;
+					in = bp + m_vfbp[3][_chnl] * c.vfq;
 					in = std::clamp(in, -1.0f, 1.0f);
 
-					hp = m_vfc[1] * ( m_vfhp[3][_chnl] + in - m_vflast[3][_chnl] );
+					hp = c.vfc[1] * ( m_vfhp[3][_chnl] + in - m_vflast[3][_chnl] );
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_vfb[1] + m_vfbp[3][_chnl] * m_vfa[1];
+					bp = hp * c.vfb[1] + m_vfbp[3][_chnl] * c.vfa[1];
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_vflast[3][_chnl] = in;
 					m_vfhp[3][_chnl] = hp;
 					m_vfbp[3][_chnl] = bp;
 
-					in = bp + m_vfbp[5][_chnl] * m_vfq;
+					in = bp + m_vfbp[5][_chnl] * c.vfq;
 					in = std::clamp(in, -1.0f, 1.0f);
 
-					hp = m_vfc[1] * ( m_vfhp[5][_chnl] + in - m_vflast[5][_chnl] );
+					hp = c.vfc[1] * ( m_vfhp[5][_chnl] + in - m_vflast[5][_chnl] );
 					hp = std::clamp(hp, -1.0f, 1.0f);
 
-					bp = hp * m_vfb[1] + m_vfbp[5][_chnl] * m_vfa[1];
+					bp = hp * c.vfb[1] + m_vfbp[5][_chnl] * c.vfa[1];
 					bp = std::clamp(bp, -1.0f, 1.0f);
 
 					m_vflast[5][_chnl] = in;
@@ -684,27 +874,35 @@ public:
 
 					out += bp;
 				}
-            	return m_type == FilterType::FastFormant ? out * 2.0f : out * 0.5f;
+            	return Type == FilterType::FastFormant ? out * 2.0f : out * 0.5f;
 			}
 
 			default:
-				out = m_biQuad.update( _in0, _chnl );
+			{
+				// biquad filter in transposed form
+				out = m_biQuadZ1[_chnl] + c.b0 * _in0;
+				m_biQuadZ1[_chnl] = c.b1 * _in0 + m_biQuadZ2[_chnl] - c.a1 * out;
+				m_biQuadZ2[_chnl] = c.b2 * _in0 - c.a2 * out;
 				break;
+			}
 		}
 
 		if( m_doubleFilter )
 		{
-			return m_subFilter->update( out, _chnl );
+			// the sub filter shares our coefficients
+			return m_subFilter->updateSample<Type>(out, _chnl, c);
 		}
 
 		// Clipper band limited sigmoid
 		return out;
 	}
 
-
+public:
 	inline void calcFilterCoeffs( float _freq, float _q )
 	{
 		using namespace std::numbers;
+		m_coeffsValid = true;
+
 		// temp coef vars
 		_q = std::max(_q, minQ());
 
@@ -719,12 +917,12 @@ public:
 			const float sr = m_sampleRatio * 0.25f;
 			const float f = 1.0f / (_freq * 2 * pi_v<float>);
 			
-			m_rca = 1.0f - sr / ( f + sr );
-			m_rcb = 1.0f - m_rca;
-			m_rcc = f / ( f + sr );
+			m_coeffs.rca = 1.0f - sr / ( f + sr );
+			m_coeffs.rcb = 1.0f - m_coeffs.rca;
+			m_coeffs.rcc = f / ( f + sr );
 
 			// Stretch Q/resonance, as self-oscillation reliably starts at a q of ~2.5 - ~2.6
-			m_rcq = _q * 0.25f;
+			m_coeffs.rcq = _q * 0.25f;
 			return;
 		}
 
@@ -742,7 +940,7 @@ public:
 			static const float freqRatio = 4.0f / 14000.0f;
 
 			// Stretch Q/resonance
-			m_vfq = _q * 0.25f;
+			m_coeffs.vfq = _q * 0.25f;
 
 			// frequency in lmms ranges from 1Hz to 14000Hz
 			const float vowelf = _freq * freqRatio;
@@ -756,12 +954,12 @@ public:
 			// samplerate coeff: depends on oversampling
 			const float sr = m_type == FilterType::FastFormant ? m_sampleRatio : m_sampleRatio * 0.25f;
 
-			m_vfa[0] = 1.0f - sr / ( f0 + sr );
-			m_vfb[0] = 1.0f - m_vfa[0];
-			m_vfc[0] = f0 /	( f0 + sr );
-			m_vfa[1] = 1.0f - sr / ( f1 + sr );
-			m_vfb[1] = 1.0f - m_vfa[1];
-			m_vfc[1] = f1 /	( f1 + sr );
+			m_coeffs.vfa[0] = 1.0f - sr / ( f0 + sr );
+			m_coeffs.vfb[0] = 1.0f - m_coeffs.vfa[0];
+			m_coeffs.vfc[0] = f0 /	( f0 + sr );
+			m_coeffs.vfa[1] = 1.0f - sr / ( f1 + sr );
+			m_coeffs.vfb[1] = 1.0f - m_coeffs.vfa[1];
+			m_coeffs.vfc[1] = f1 /	( f1 + sr );
 			return;
 		}
 
@@ -771,16 +969,10 @@ public:
 			// [ 0 - 0.5 ]
 			const float f = std::clamp(_freq, minFreq(), 20000.0f) * m_sampleRatio;
 			// (Empirical tuning)
-			m_p = ( 3.6f - 3.2f * f ) * f;
-			m_k = 2.0f * m_p - 1;
-			m_r = _q * std::exp((1 - m_p) * 1.386249f);
+			m_coeffs.p = ( 3.6f - 3.2f * f ) * f;
+			m_coeffs.k = 2.0f * m_coeffs.p - 1;
+			m_coeffs.r = _q * std::exp((1 - m_coeffs.p) * 1.386249f);
 
-			if( m_doubleFilter )
-			{
-				m_subFilter->m_r = m_r;
-				m_subFilter->m_p = m_p;
-				m_subFilter->m_k = m_k;
-			}
 			return;
 		}
 		
@@ -788,9 +980,9 @@ public:
 		{
 			const float f = std::clamp(_freq, 20.0f, 20000.0f) * m_sampleRatio * 0.25f;
 			
-			m_p = ( 3.6f - 3.2f * f ) * f;
-			m_k = 2.0f * m_p - 1.0f;
-			m_r = _q * 0.1f * std::exp((1 - m_p) * 1.386249f);
+			m_coeffs.p = ( 3.6f - 3.2f * f ) * f;
+			m_coeffs.k = 2.0f * m_coeffs.p - 1.0f;
+			m_coeffs.r = _q * 0.1f * std::exp((1 - m_coeffs.p) * 1.386249f);
 			
 			return;
 		}
@@ -801,9 +993,9 @@ public:
 			m_type == FilterType::Notch_SV )
 		{
 			const float f = std::sin(std::max(minFreq(), _freq) * m_sampleRatio * pi_v<float>);
-			m_svf1 = std::min(f, 0.825f);
-			m_svf2 = std::min(f * 2.0f, 0.825f);
-			m_svq = std::max(0.0001f, 2.0f - (_q * 0.1995f));
+			m_coeffs.svf1 = std::min(f, 0.825f);
+			m_coeffs.svf2 = std::min(f * 2.0f, 0.825f);
+			m_coeffs.svq = std::max(0.0001f, 2.0f - (_q * 0.1995f));
 			return;
 		}
 
@@ -826,67 +1018,63 @@ public:
 			{
 				const float b1 = ( 1.0f - tcos ) * a0;
 				const float b0 = b1 * 0.5f;
-				m_biQuad.setCoeffs( a1, a2, b0, b1, b0 );
+				setBiQuadCoeffs( a1, a2, b0, b1, b0 );
 				break;
 			}
 			case FilterType::HiPass:
 			{
 				const float b1 = ( -1.0f - tcos ) * a0;
 				const float b0 = b1 * -0.5f;
-				m_biQuad.setCoeffs( a1, a2, b0, b1, b0 );
+				setBiQuadCoeffs( a1, a2, b0, b1, b0 );
 				break;
 			}
 			case FilterType::BandPass_CSG:
 			{
 				const float b0 = tsin * a0;
-				m_biQuad.setCoeffs( a1, a2, b0, 0.0f, -b0 );
+				setBiQuadCoeffs( a1, a2, b0, 0.0f, -b0 );
 				break;
 			}
 			case FilterType::BandPass_CZPG:
 			{
 				const float b0 = alpha * a0;
-				m_biQuad.setCoeffs( a1, a2, b0, 0.0f, -b0 );
+				setBiQuadCoeffs( a1, a2, b0, 0.0f, -b0 );
 				break;
 			}
 			case FilterType::Notch:
 			{
-				m_biQuad.setCoeffs( a1, a2, a0, a1, a0 );
+				setBiQuadCoeffs( a1, a2, a0, a1, a0 );
 				break;
 			}
 			case FilterType::AllPass:
 			{
-				m_biQuad.setCoeffs( a1, a2, a2, a1, 1.0f );
+				setBiQuadCoeffs( a1, a2, a2, a1, 1.0f );
 				break;
 			}
 			default:
 				break;
 		}
-
-		if( m_doubleFilter )
-		{
-			m_subFilter->m_biQuad.setCoeffs( m_biQuad.m_a1, m_biQuad.m_a2, m_biQuad.m_b0, m_biQuad.m_b1, m_biQuad.m_b2 );
-		}
 	}
 
 
 private:
-	// biquad filter
-	BiQuad<CHANNELS> m_biQuad;
-
-	// coeffs for moog-filter
-	float m_r, m_p, m_k;
-
-	// coeffs for RC-type-filters
-	float m_rca, m_rcb, m_rcc, m_rcq;
-
-	// coeffs for formant-filters
-	float m_vfa[4], m_vfb[4], m_vfc[4], m_vfq;
+	inline void setBiQuadCoeffs(float a1, float a2, float b0, float b1, float b2)
+	{
+		m_coeffs.a1 = a1;
+		m_coeffs.a2 = a2;
+		m_coeffs.b0 = b0;
+		m_coeffs.b1 = b1;
+		m_coeffs.b2 = b2;
+	}
 
-	// coeffs for Lowpass_SV (state-variant lowpass)
-	float m_svf1, m_svf2, m_svq;
+	Coefficients m_coeffs;
+	//! Whether m_coeffs were computed for the current filter type, so process() may interpolate from them
+	bool m_coeffsValid = false;
 
 	using frame = std::array<sample_t, CHANNELS>;
 
+	// in/out history for biquad filter
+	frame m_biQuadZ1, m_biQuadZ2;
+
 	// in/out history for moog-filter
 	frame m_y1, m_y2, m_y3, m_y4, m_oldx, m_oldy1, m_oldy2, m_oldy3;
 	// additional one for Tripole filter
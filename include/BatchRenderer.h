@@ -0,0 +1,105 @@
+/*
+ * BatchRenderer.h - renders a queue of projects in a single process
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_BATCH_RENDERER_H
+#define LMMS_BATCH_RENDERER_H
+
+#include <deque>
+#include <memory>
+#include <QTimer>
+
+#include "OutputSettings.h"
+#include "ProjectRenderer.h"
+
+
+class QTextStream;
+
+namespace lmms
+{
+
+class RenderManager;
+
+
+/**
+	Renders a queue of projects one after another without restarting LMMS,
+	so the engine, the plugin caches and the wavetables stay warm between jobs.
+
+	Jobs are read from a text stream, one per line:
+
+		<project> [<tab> <output> [<tab> <format> [<tab> <samplerate>]]]
+
+	Empty fields are replaced by the defaults given to the constructor. If no
+	output is given, the project file name with the format's extension is used.
+	Empty lines and lines starting with '#' are ignored.
+*/
+class BatchRenderer : public QObject
+{
+	Q_OBJECT
+public:
+	struct Job
+	{
+		QString project;
+		QString output;
+		ProjectRenderer::ExportFileFormat format;
+		OutputSettings outputSettings;
+		bool loop;
+	};
+
+	BatchRenderer(QTextStream& input, const Job& defaults);
+	~BatchRenderer() override;
+
+	//! Start rendering, emits finished() once all jobs are done
+	void start();
+
+	//! @returns the number of jobs that could not be parsed, loaded or rendered
+	std::size_t failedJobs() const
+	{
+		return m_failedJobs;
+	}
+
+signals:
+	void finished();
+
+private slots:
+	void renderNextJob();
+	void jobFinished();
+	void updateConsoleProgress();
+
+private:
+	//! @returns false and prints an error if @p line is not a valid job
+	bool parseJob(const QString& line, Job& job) const;
+
+	std::deque<Job> m_jobs;
+	std::size_t m_jobCount = 0;
+	std::size_t m_failedJobs = 0;
+
+	std::unique_ptr<RenderManager> m_renderManager;
+	QString m_currentOutput;
+	QTimer m_progressTimer;
+} ;
+
+
+} // namespace lmms
+
+#endif // LMMS_BATCH_RENDERER_H
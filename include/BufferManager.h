@@ -28,19 +28,38 @@
 
 #include "lmms_export.h"
 #include "LmmsTypes.h"
+#include "SlabPool.h"
 
 namespace lmms
 {
 
 class SampleFrame;
 
+/**
+	Provides the period-sized buffers of play handles.
+
+	The buffers come from a preallocated, cache-line aligned pool, so acquiring and
+	releasing them is lock-free and doesn't touch the heap on the audio threads.
+	Each thread keeps a few free buffers for itself, the rest is shared through
+	lock-free slabs. When the pool runs low, another slab is allocated on a
+	background thread. Only if the pool is exhausted before that, acquiring
+	fails and AudioEngine::addPlayHandle() drops the play handle.
+*/
 class LMMS_EXPORT BufferManager
 {
 public:
+	using Statistics = SlabPool::Statistics;
+
+	//! Creates the pool. Must not be called from an audio thread, nor while buffers are acquired
+	//! if the period size changes.
 	static void init( f_cnt_t fpp );
+	//! @returns an uninitialized buffer of one period (PlayHandle clears it before each period),
+	//! or nullptr if the pool is exhausted
 	static SampleFrame* acquire();
 	static void release( SampleFrame* buf );
 
+	static Statistics statistics();
+
 private:
 	static f_cnt_t s_framesPerPeriod;
 };
@@ -0,0 +1,69 @@
+/*
+ * ClipSchedule.h - immutable, position-sorted snapshot of a track's clips for playback
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_CLIP_SCHEDULE_H
+#define LMMS_CLIP_SCHEDULE_H
+
+#include <vector>
+
+#include "LmmsTypes.h"
+
+namespace lmms
+{
+
+class Clip;
+class TimePos;
+
+/**
+	The clips of a track, sorted by start position, for looking up the clips
+	playing at a given time without scanning all of them.
+
+	A schedule is never modified. When clips are added, removed, moved or
+	resized, the track builds a new schedule outside of the audio thread and
+	swaps it in while the audio engine is locked.
+*/
+class ClipSchedule
+{
+public:
+	explicit ClipSchedule(const std::vector<Clip*>& clips);
+
+	//! Inserts the clips intersecting [@p start, @p end] into @p clips, which stays sorted by start position
+	void clipsInRange(std::vector<Clip*>& clips, const TimePos& start, const TimePos& end) const;
+
+private:
+	struct Entry
+	{
+		tick_t start;
+		tick_t end;
+		//! Maximum end position of this and all previous entries, so the search can stop early
+		tick_t maxEnd;
+		Clip* clip;
+	};
+
+	std::vector<Entry> m_entries;
+};
+
+} // namespace lmms
+
+#endif // LMMS_CLIP_SCHEDULE_H
@@ -27,16 +27,20 @@
 #define LMMS_DATA_FILE_H
 
 #include <map>
+#include <memory>
+#include <utility>
 #include <QDomDocument>
 #include <vector>
 
 #include "lmms_export.h"
 
+class QIODevice;
 class QTextStream;
 
 namespace lmms
 {
 
+class ProjectArchive;
 class ProjectVersion;
 
 
@@ -44,6 +48,19 @@ class LMMS_EXPORT DataFile : public QDomDocument
 {
 
 	using UpgradeMethod = void(DataFile::*)();
+	using ElementUpgradeMethod = void(DataFile::*)(QDomElement&);
+
+	//! An upgrade routine, run either on the whole document or on each element with one of its tag names
+	struct Upgrade
+	{
+		Upgrade(UpgradeMethod method) : documentMethod(method) {}
+		Upgrade(ElementUpgradeMethod method, std::vector<QString> tagNames) :
+			elementMethod(method), tagNames(std::move(tagNames)) {}
+
+		UpgradeMethod documentMethod = nullptr;
+		ElementUpgradeMethod elementMethod = nullptr;
+		std::vector<QString> tagNames;
+	};
 
 public:
 	enum class Type
@@ -101,59 +118,75 @@ private:
 
 	void cleanMetaNodes( QDomElement de );
 
-	void mapSrcAttributeInElementsWithResources(const QMap<QString, QString>& map);
+	static void mapSrcAttributeInElementWithResources(QDomElement& element, const QMap<QString, QString>& map);
+
+	//! Writes the document as ProjectArchive, with the sample data in chunks of its own
+	bool writeArchive(QIODevice& output);
+	//! Replaces references to chunks of the archive the document was loaded from by the base64 encoded chunks
+	void inlineSampleData();
 
 	// helper upgrade routines
-	void upgrade_0_2_1_20070501();
+	void upgrade_0_2_1_20070501(QDomElement& el);
 	void upgrade_0_2_1_20070508();
-	void upgrade_0_3_0_rc2();
-	void upgrade_0_3_0();
-	void upgrade_0_4_0_20080104();
-	void upgrade_0_4_0_20080118();
-	void upgrade_0_4_0_20080129();
-	void upgrade_0_4_0_20080409();
-	void upgrade_0_4_0_20080607();
-	void upgrade_0_4_0_20080622();
-	void upgrade_0_4_0_beta1();
-	void upgrade_0_4_0_rc2();
+	void upgrade_0_3_0_rc2(QDomElement& el);
+	void upgrade_0_3_0(QDomElement& el);
+	void upgrade_0_4_0_20080104(QDomElement& el);
+	void upgrade_0_4_0_20080118(QDomElement& fxchain);
+	void upgrade_0_4_0_20080129(QDomElement& aac);
+	void upgrade_0_4_0_20080409(QDomElement& el);
+	void upgrade_0_4_0_20080607(QDomElement& el);
+	void upgrade_0_4_0_20080622(QDomElement& el);
+	void upgrade_0_4_0_beta1(QDomElement& el);
+	void upgrade_0_4_0_rc2(QDomElement& el);
 	void upgrade_1_0_99();
-	void upgrade_1_1_0();
-	void upgrade_1_1_91();
+	void upgrade_1_1_0(QDomElement& el);
+	void upgrade_1_1_91(QDomElement& el);
 	void upgrade_1_2_0_rc3();
-	void upgrade_1_3_0();
-	void upgrade_noHiddenClipNames();
-	void upgrade_automationNodes();
+	void upgrade_1_3_0(QDomElement& el);
+	void upgrade_noHiddenClipNames(QDomElement& track);
+	void upgrade_automationNodes(QDomElement& autoPattern);
 	void upgrade_extendedNoteRange();
-	void upgrade_defaultTripleOscillatorHQ();
-	void upgrade_mixerRename();
-	void upgrade_bbTcoRename();
-	void upgrade_sampleAndHold();
-	void upgrade_midiCCIndexing();
-	void upgrade_loopsRename();
-	void upgrade_noteTypes();
-	void upgrade_fixCMTDelays();
-	void upgrade_fixBassLoopsTypo();
-	void findProblematicLadspaPlugins();
+	void upgrade_defaultTripleOscillatorHQ(QDomElement& tripleoscillator);
+	void upgrade_mixerRename(QDomElement& item);
+	void upgrade_bbTcoRename(QDomElement& e);
+	void upgrade_sampleAndHold(QDomElement& e);
+	void upgrade_midiCCIndexing(QDomElement& element);
+	void upgrade_loopsRename(QDomElement& element);
+	void upgrade_noteTypes(QDomElement& note);
+	void upgrade_fixCMTDelays(QDomElement& effect);
+	void upgrade_fixBassLoopsTypo(QDomElement& element);
+	void findProblematicLadspaPlugins(QDomElement& ladspacontrol);
 	void upgrade_noHiddenAutomationTracks();
 
 	// List of all upgrade methods
-	static const std::vector<UpgradeMethod> UPGRADE_METHODS;
+	static const std::vector<Upgrade> UPGRADE_METHODS;
 	// List of ProjectVersions for the legacyFileVersion method
 	static const std::vector<ProjectVersion> UPGRADE_VERSIONS;
 
 	// Map with DOM elements that access resources (for making bundles)
 	using ResourcesMap = std::map<QString, std::vector<QString>>;
 	static const ResourcesMap ELEMENTS_WITH_RESOURCES;
+	// Map with DOM elements holding base64 encoded sample data (moved to chunks of their own in archives)
+	static const ResourcesMap ELEMENTS_WITH_SAMPLE_DATA;
 
 	void upgrade();
+	//! Runs the element upgrades first to last (inclusive) in a single traversal of the document
+	void upgradeElements(std::size_t first, std::size_t last);
 
 	void loadData( const QByteArray & _data, const QString & _sourceFile );
 
 	QString m_fileName; //!< The origin file name or "" if this DataFile didn't originate from a file
+	std::shared_ptr<const ProjectArchive> m_archive; //!< The archive the document was loaded from, if any
 	QDomElement m_content;
 	QDomElement m_head;
 	Type m_type;
 	unsigned int m_fileVersion;
+	unsigned int m_problematicLadspaPlugins = 0; //!< Counted by findProblematicLadspaPlugins() while upgrading
+
+#ifdef LMMS_TESTING
+	//! Lets the tests run the upgrades one traversal per upgrade, to compare that with upgrade()
+	friend struct DataFileTestAccess;
+#endif
 } ;
 
 
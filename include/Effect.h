@@ -28,6 +28,7 @@
 
 #include <span>
 
+#include "AudioBufferView.h"
 #include "AudioEngine.h"
 #include "AutomatableModel.h"
 #include "Engine.h"
@@ -68,6 +69,16 @@ public:
 	//! Returns true if audio was processed and should continue being processed
 	bool processAudioBuffer(AudioBuffer& inOut);
 
+	/**
+	 * Returns true for a `PlanarEffect`, which works on the planar buffers directly. Other
+	 * effects implement `processImpl`, which needs the buffer to be converted to interleaved
+	 * and back around every call.
+	 */
+	virtual bool processesPlanar() const
+	{
+		return false;
+	}
+
 	inline bool isOkay() const
 	{
 		return m_okay;
@@ -202,6 +213,8 @@ private:
 	bool m_awake;
 	std::atomic<bool> m_corrupted = false;
 
+	AudioEngineProfiler::Node m_profilerNode{AudioEngineProfiler::NodeType::Effect};
+
 	//! The number of consecutive periods where output buffers remain below the silence threshold
 	f_cnt_t m_quietBufferCount = 0;
 
@@ -216,6 +229,36 @@ private:
 
 } ;
 
+/**
+ * Base class of effects that work on the planar channel buffers directly. They implement
+ * `processPlanarImpl` instead of `processImpl`.
+ */
+class LMMS_EXPORT PlanarEffect : public Effect
+{
+public:
+	using Effect::Effect;
+
+	bool processesPlanar() const final
+	{
+		return true;
+	}
+
+protected:
+	/**
+	 * Same as `processImpl`, but works on the planar channel buffers
+	 */
+	virtual ProcessStatus processPlanarImpl(PlanarBufferView<sample_t, 2> inOut) = 0;
+
+private:
+	//! Never called, `Effect::processAudioBuffer` calls `processPlanarImpl` instead
+	ProcessStatus processImpl(SampleFrame*, const f_cnt_t) final
+	{
+		return ProcessStatus::Sleep;
+	}
+
+	friend class Effect;
+} ;
+
 using EffectKey = Effect::Descriptor::SubPluginFeatures::Key;
 using EffectKeyList = Effect::Descriptor::SubPluginFeatures::KeyList;
 
@@ -25,7 +25,9 @@
 #ifndef LMMS_ENVELOPE_AND_LFO_PARAMETERS_H
 #define LMMS_ENVELOPE_AND_LFO_PARAMETERS_H
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include "JournallingObject.h"
 #include "AutomatableModel.h"
@@ -59,6 +61,8 @@ public:
 			return m_lfos.isEmpty();
 		}
 
+		// Only called by the audio thread. add() and remove() change the list while the
+		// audio engine is locked, so these don't need a lock of their own.
 		void trigger();
 		void reset();
 
@@ -66,7 +70,6 @@ public:
 		void remove( EnvelopeAndLfoParameters * lfo );
 
 	private:
-		QMutex m_lfoListMutex;
 		using LfoList = QList<EnvelopeAndLfoParameters*>;
 		LfoList m_lfos;
 
@@ -83,6 +86,9 @@ public:
 		Count
 	};
 
+	//! fillLevel() evaluates the envelope and the LFO every ControlRateFrames frames and interpolates in between
+	static constexpr f_cnt_t ControlRateFrames = 16;
+
 	EnvelopeAndLfoParameters( float _value_for_zero_amount,
 							Model * _parent );
 	~EnvelopeAndLfoParameters() override;
@@ -103,7 +109,7 @@ public:
 
 	inline bool isUsed() const
 	{
-		return m_used;
+		return m_used.load(std::memory_order_relaxed);
 	}
 
 
@@ -116,12 +122,12 @@ public:
 
 	inline f_cnt_t PAHD_Frames() const
 	{
-		return m_pahdFrames;
+		return m_pahdFrames.load(std::memory_order_relaxed);
 	}
 
 	inline f_cnt_t releaseFrames() const
 	{
-		return m_rFrames;
+		return m_rFrames.load(std::memory_order_relaxed);
 	}
 
 	// Envelope
@@ -136,9 +142,9 @@ public:
 
 
 	// LFO
-	inline f_cnt_t getLfoPredelayFrames() const { return m_lfoPredelayFrames; }
-	inline f_cnt_t getLfoAttackFrames() const { return m_lfoAttackFrames; }
-	inline f_cnt_t getLfoOscillationFrames() const { return m_lfoOscillationFrames; }
+	inline f_cnt_t getLfoPredelayFrames() const { return snapshot().lfoPredelayFrames; }
+	inline f_cnt_t getLfoAttackFrames() const { return snapshot().lfoAttackFrames; }
+	inline f_cnt_t getLfoOscillationFrames() const { return snapshot().lfoOscillationFrames; }
 
 	const FloatModel& getLfoAmountModel() const { return m_lfoAmountModel; }
 	FloatModel& getLfoAmountModel() { return m_lfoAmountModel; }
@@ -151,15 +157,46 @@ public slots:
 	void updateSampleVars();
 
 
-protected:
-	void fillLfoLevel( float * _buf, f_cnt_t _frame, const f_cnt_t _frames );
-
-
 private:
+	//! Everything fillLevel() needs, computed by updateSampleVars() as a whole. The envelope
+	//! is piecewise linear, so only its segments are stored. This keeps the snapshot small
+	//! enough to be copied by value, so neither publishing nor taking it allocates.
+	struct Snapshot
+	{
+		f_cnt_t predelayFrames = 0;
+		f_cnt_t attackFrames = 1;
+		f_cnt_t holdFrames = 0;
+		f_cnt_t decayFrames = 1;
+		f_cnt_t releaseFrames = 1;
+		float predelayLevel = 0.0f;
+		float attackStep = 0.0f;
+		float holdLevel = 0.0f;
+		float decayStep = 0.0f;
+		float releaseStep = 0.0f;
+		float sustainLevel = 0.0f;
+		bool controlEnvAmount = false;
+
+		f_cnt_t lfoPredelayFrames = 0;
+		f_cnt_t lfoAttackFrames = 0;
+		f_cnt_t lfoOscillationFrames = 1;
+		float lfoAmount = 0.0f;
+		bool lfoAmountIsZero = true;
+		LfoShape lfoShape = LfoShape::SineWave;
+		//! Owned by m_userWave, which is only replaced while the audio engine is locked
+		const SampleBuffer* userWave = nullptr;
+	};
+
 	static LfoInstances * s_lfoInstances;
-	bool m_used;
+	std::atomic<bool> m_used;
 
-	QMutex m_paramMutex;
+	//! Latest parameters, published by updateSampleVars() from any thread
+	Snapshot m_snapshot;
+	//! Sequence lock of m_snapshot: odd while it is being written, incremented twice per write
+	std::atomic<unsigned> m_snapshotSequence = 0;
+	//! Set when the parameters have changed, so the thread currently publishing computes them again
+	std::atomic<bool> m_snapshotOutdated = false;
+	//! Parameters of the current period, copied from m_snapshot by the audio thread before each period
+	Snapshot m_periodSnapshot;
 
 	FloatModel m_predelayModel;
 	FloatModel m_attackModel;
@@ -169,16 +206,9 @@ private:
 	FloatModel m_releaseModel;
 	FloatModel m_amountModel;
 
-	float  m_sustainLevel;
-	float  m_amount;
 	float  m_valueForZeroAmount;
-	float  m_amountAdd;
-	f_cnt_t m_pahdFrames;
-	f_cnt_t m_rFrames;
-	sample_t * m_pahdEnv;
-	sample_t * m_rEnv;
-	f_cnt_t m_pahdBufSize;
-	f_cnt_t m_rBufSize;
+	std::atomic<f_cnt_t> m_pahdFrames;
+	std::atomic<f_cnt_t> m_rFrames;
 
 
 	FloatModel m_lfoPredelayModel;
@@ -191,21 +221,33 @@ private:
 	BoolModel m_controlEnvAmountModel;
 
 
-	f_cnt_t m_lfoPredelayFrames;
-	f_cnt_t m_lfoAttackFrames;
-	f_cnt_t m_lfoOscillationFrames;
+	// LFO state of the audio thread
 	f_cnt_t m_lfoFrame;
-	float m_lfoAmount;
-	bool m_lfoAmountIsZero;
-	sample_t * m_lfoShapeData;
+	std::vector<sample_t> m_lfoShapeData;
 	sample_t m_random;
-	bool m_bad_lfoShapeData;
+	f_cnt_t m_randomCycle;
 	std::shared_ptr<const SampleBuffer> m_userWave = SampleBuffer::emptyBuffer();
 
 	constexpr static auto NumLfoShapes = static_cast<std::size_t>(LfoShape::Count);
 
+	//! Computes the parameters from the models
+	Snapshot computeSnapshot();
+	//! Copies m_snapshot into @p params without waiting. @returns false and leaves @p params
+	//! unchanged if it is being written at the moment.
+	bool tryReadSnapshot(Snapshot& params) const;
+	//! Copies m_snapshot, retrying while it is being written. Not for the audio threads.
+	Snapshot snapshot() const;
+	//! Computes and publishes the parameters. Never waits for another thread doing the same.
+	void publishSnapshot();
+	//! Replaces the user wave while the audio engine is locked, so no snapshot refers to the previous one
+	void setUserWave(std::shared_ptr<const SampleBuffer> wave);
+
 	sample_t lfoShapeSample( f_cnt_t _frame_offset );
 	void updateLfoShapeData();
+	void startPeriod();
+	//! @returns the level of the pre-delay, attack, hold and decay stages, or the sustain level after them
+	static float pahdLevel(const Snapshot& params, f_cnt_t frame);
+	float levelAt(f_cnt_t frame, f_cnt_t releaseBegin, f_cnt_t offset) const;
 
 
 	friend class gui::EnvelopeAndLfoView;
@@ -24,6 +24,7 @@
 #ifndef LMMS_HARDWARE_H
 #define LMMS_HARDWARE_H
 
+#include <array>
 #include <cstdint>
 #include <new>
 #if __cpp_lib_hardware_interference_size >= 201703L
@@ -35,6 +36,9 @@
 #include "lmmsconfig.h"
 #if defined(LMMS_HOST_X86_64) || defined(LMMS_HOST_X86)
 	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#endif
 #elif defined(LMMS_HOST_ARM64) || defined(LMMS_HOST_ARM32)
 	#if defined(__ARM_ACLE)
 		#include <arm_acle.h>
@@ -158,6 +162,59 @@ inline void disableDenormals()
 #endif
 }
 
+
+
+//! @brief SIMD instruction set extensions which may be used by code that dispatches at runtime.
+struct CpuFeatures
+{
+	bool sse2 = false;
+	bool avx2 = false;
+	bool avx512f = false;
+	bool neon = false;
+};
+
+//! @brief Detects the SIMD instruction set extensions supported by the CPU (and enabled by the OS).
+//! The detection runs once, later calls return the cached result.
+//! @see [x86 `cpuid`](https://www.felixcloutier.com/x86/cpuid)
+inline const CpuFeatures& cpuFeatures()
+{
+	static const CpuFeatures features = [] {
+		auto detected = CpuFeatures{};
+#if defined(LMMS_HOST_X86_64) || defined(LMMS_HOST_X86)
+	#if defined(_MSC_VER)
+		auto info = std::array<int, 4>{};
+		__cpuid(info.data(), 0);
+		const int maxLeaf = info[0];
+
+		__cpuid(info.data(), 1);
+		detected.sse2 = info[3] & (1 << 26);
+		// the OS has to save the AVX (and AVX-512) registers on context switches
+		const bool osxsave = info[2] & (1 << 27);
+		const auto xcr0 = osxsave ? _xgetbv(0) : 0;
+		const bool osAvx = (xcr0 & 0x06) == 0x06;
+		const bool osAvx512 = (xcr0 & 0xe6) == 0xe6;
+
+		if (maxLeaf >= 7)
+		{
+			__cpuidex(info.data(), 7, 0);
+			detected.avx2 = osAvx && (info[1] & (1 << 5));
+			detected.avx512f = osAvx512 && (info[1] & (1 << 16));
+		}
+	#else
+		__builtin_cpu_init();
+		detected.sse2 = __builtin_cpu_supports("sse2");
+		detected.avx2 = __builtin_cpu_supports("avx2");
+		detected.avx512f = __builtin_cpu_supports("avx512f");
+	#endif
+#elif defined(LMMS_HOST_ARM64) || (defined(LMMS_HOST_ARM32) && defined(__ARM_NEON))
+		// NEON is part of the ARMv8 baseline, on ARM32 it has to be enabled when compiling
+		detected.neon = true;
+#endif
+		return detected;
+	}();
+	return features;
+}
+
 } // namespace lmms
 
 #endif // LMMS_HARDWARE_H
@@ -36,16 +36,29 @@ namespace lmms
 class LocklessAllocator
 {
 public:
-	LocklessAllocator( size_t nmemb, size_t size );
+	//! @param alignment alignment of each element, must be a power of two
+	LocklessAllocator( size_t nmemb, size_t size, size_t alignment = sizeof( void * ) );
 	virtual ~LocklessAllocator();
 	void * alloc();
+	//! Same as alloc(), but doesn't complain if the pool is exhausted
+	void * tryAlloc();
 	void free( void * ptr );
 
+	//! @returns true if @p ptr points into the pool
+	bool contains( const void * ptr ) const
+	{
+		return ptr >= m_pool && ptr < m_pool + m_capacity * m_elementSize;
+	}
+
+	size_t capacity() const { return m_capacity; }
+	size_t available() const { return m_available.load(std::memory_order_relaxed); }
+
 
 private:
 	char * m_pool;
 	size_t m_capacity;
 	size_t m_elementSize;
+	size_t m_alignment;
 
 	std::atomic_int * m_freeState;
 	size_t m_freeStateSets;
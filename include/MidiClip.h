@@ -26,6 +26,9 @@
 #ifndef LMMS_MIDI_CLIP_H
 #define LMMS_MIDI_CLIP_H
 
+#include <span>
+#include <vector>
+
 #include "Clip.h"
 #include "Note.h"
 
@@ -75,6 +78,16 @@ public:
 		return m_notes;
 	}
 
+	/**
+		@returns the notes starting at @p pos, looked up in an index of the note
+		start positions. The index is rebuilt by the editing thread whenever the notes
+		change, and it remembers the last position, so looking up consecutive positions
+		only costs O(number of started notes). Must only be called with the track locked.
+	*/
+	std::span<Note* const> notesStartingAt(TimePos pos) const;
+	//! @returns the notes starting before @p pos, ordered by start position. Must only be called with the track locked.
+	std::span<Note* const> notesStartingBefore(TimePos pos) const;
+
 	Note * addStepNote( int step );
 	void setStep( int step, bool enabled );
 
@@ -147,6 +160,17 @@ private:
 
 	void resizeToFirstTrack();
 
+	//! Rebuild the start index from the notes and swap it in under the track lock
+	void updateStartIndex();
+	//! Insert a newly added note into the start index. Locks the track itself.
+	void insertIntoStartIndex(Note* note);
+	//! Remove a note that is about to be deleted from the start index. Must only be called with the track locked.
+	void removeFromStartIndex(const Note* note);
+	//! Emit dataChanged() after the start index has already been updated, so it isn't rebuilt
+	void emitDataChangedKeepingStartIndex();
+	//! @returns the first index entry at or after @p pos
+	std::size_t seekStartIndex(tick_t pos) const;
+
 	InstrumentTrack * m_instrumentTrack;
 
 	Type m_clipType;
@@ -155,6 +179,15 @@ private:
 	NoteVector m_notes;
 	int m_steps;
 
+	// Index of the notes ordered by start position for playback. The positions are stored
+	// separately, so the notes don't need to be dereferenced when seeking.
+	NoteVector m_startIndexNotes;
+	std::vector<tick_t> m_startIndexPositions;
+	//! The entry following the last looked up position
+	mutable std::size_t m_startIndexCursor = 0;
+	//! Set while emitting dataChanged() for a change the start index already reflects
+	bool m_startIndexUpToDate = false;
+
 	MidiClip * adjacentMidiClipByOffset(int offset) const;
 
 	friend class gui::MidiClipView;
@@ -25,6 +25,8 @@
 #ifndef LMMS_MIX_HELPERS_H
 #define LMMS_MIX_HELPERS_H
 
+#include <vector>
+
 #include "AudioBufferView.h"
 
 namespace lmms
@@ -36,6 +38,29 @@ class SampleFrame;
 namespace MixHelpers
 {
 
+//! Instruction sets the helpers can be vectorized with
+enum class Implementation
+{
+	Scalar,
+	SSE2,
+	AVX2,
+	AVX512,
+	NEON
+};
+
+//! @returns the implementations usable on this CPU, from the slowest (`Scalar`) to the fastest
+std::vector<Implementation> supportedImplementations();
+
+//! @returns the implementation currently in use. Defaults to the fastest supported one.
+Implementation implementation();
+
+/*! \brief Selects the implementation used by all helpers (meant for tests and benchmarks)
+ *
+ * Must not be called while audio is being processed.
+ * @returns false if @p impl is not supported on this CPU
+ */
+bool setImplementation(Implementation impl);
+
 bool isSilent(const SampleFrame* src, int frames);
 
 bool isSilent(std::span<const sample_t> buffer);
@@ -46,21 +71,38 @@ void add( SampleFrame* dst, const SampleFrame* src, int frames );
 /*! \brief Add samples from src to dst */
 void add(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src);
 
+/*! \brief Add samples from the interleaved src to the planar dst */
+void add(PlanarBufferView<sample_t> dst, InterleavedBufferView<const sample_t, 2> src);
+
 /*! \brief Multiply samples from `dst` by `coeff` */
 void multiply(SampleFrame* dst, float coeff, int frames);
 
+/*! \brief Multiply samples from `dst` by `coeff` */
+void multiply(PlanarBufferView<sample_t> dst, float coeff);
+
 /*! \brief Add samples from src multiplied by coeffSrc to dst */
 void addMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames );
 
+/*! \brief Add samples from src multiplied by coeffSrc to dst */
+void addMultiplied(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src, float coeffSrc);
+
 /*! \brief Add samples from src multiplied by coeffSrc to dst, swap inputs */
 void addSwappedMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames );
 
 /*! \brief Add samples from src multiplied by coeffSrc and coeffSrcBuf to dst */
 void addMultipliedByBuffer( SampleFrame* dst, const SampleFrame* src, float coeffSrc, ValueBuffer * coeffSrcBuf, int frames );
 
+/*! \brief Add samples from src multiplied by coeffSrc and coeffSrcBuf to dst */
+void addMultipliedByBuffer(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src, float coeffSrc,
+	const ValueBuffer* coeffSrcBuf);
+
 /*! \brief Add samples from src multiplied by coeffSrc and coeffSrcBuf to dst */
 void addMultipliedByBuffers( SampleFrame* dst, const SampleFrame* src, ValueBuffer * coeffSrcBuf1, ValueBuffer * coeffSrcBuf2, int frames );
 
+/*! \brief Add samples from src multiplied by coeffSrcBuf1 and coeffSrcBuf2 to dst */
+void addMultipliedByBuffers(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src,
+	const ValueBuffer* coeffSrcBuf1, const ValueBuffer* coeffSrcBuf2);
+
 /*! \brief Add samples from src multiplied by coeffSrcLeft/coeffSrcRight to dst */
 void addMultipliedStereo( SampleFrame* dst, const SampleFrame* src, float coeffSrcLeft, float coeffSrcRight, int frames );
 
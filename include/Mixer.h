@@ -26,6 +26,7 @@
 #define LMMS_MIXER_H
 
 #include "AudioBuffer.h"
+#include "AudioEngineProfiler.h"
 #include "EffectChain.h"
 #include "JournallingObject.h"
 #include "Model.h"
@@ -61,6 +62,7 @@ public:
 	BoolModel m_soloModel;
 	FloatModel m_volumeModel;
 	QString m_name;
+	AudioEngineProfiler::Node m_profilerNode{AudioEngineProfiler::NodeType::MixerChannel};
 	QMutex m_lock;
 	bool m_queued; // are we queued up for rendering yet?
 	bool m_muted; // are we muted? updated per period so we don't have to call m_muteModel.value() twice
@@ -71,6 +73,12 @@ public:
 	// pointers to other channels that send to this one
 	MixerRouteVector m_receives;
 
+	void setName(const QString& name)
+	{
+		m_name = name;
+		m_profilerNode.setName(name);
+	}
+
 	int index() const { return m_channelIndex; }
 	void setIndex(int index) { m_channelIndex = index; }
 
@@ -85,8 +93,20 @@ public:
 	void setColor(const std::optional<QColor>& color) { m_color = color; }
 
 	std::atomic_size_t m_dependenciesMet;
-	void incrementDeps();
-	void processed();
+	// number of audio bus handles sending to this channel in the current period
+	std::size_t m_busDependencies;
+	void addBusDependency() { ++m_busDependencies; }
+	//! Counts one more processed input. @returns true if it was the last one, i.e. the channel is ready now.
+	bool incrementDeps();
+	//! Counts this channel as processed input of all of its receivers.
+	//! @returns a receiver that became ready and has to be processed by the caller, all others get queued
+	MixerChannel* processed();
+	//! Processes this ready channel right away on the current thread instead of queueing it
+	void processAsContinuation()
+	{
+		queue();
+		process();
+	}
 
 private:
 	void doProcessing() override;
@@ -145,6 +165,13 @@ public:
 	void mixToChannel(const AudioBuffer& buffer, mix_ch_t dest);
 
 	void prepareMasterMix();
+
+	//! Resets the dependency counting of all channels for the next period's processing graph
+	void prepareGraph();
+	//! Queues all channels that don't wait for any inputs. Must be called after all inputs are registered.
+	void startGraph();
+
+	//! Writes the master channel's output to @p _buf once the processing graph has finished
 	void masterMix( SampleFrame* _buf );
 
 	void saveSettings( QDomDocument & _doc, QDomElement & _parent ) override;
@@ -31,10 +31,9 @@
 #include "BasicFilters.h"
 #include "Note.h"
 #include "PlayHandle.h"
+#include "SlabPool.h"
 #include "Track.h"
 
-class QReadWriteLock;
-
 namespace lmms
 {
 
@@ -333,13 +332,23 @@ private:
 } ;
 
 
+//! Number of note play handles per slab of the pool
 const int INITIAL_NPH_CACHE = 256;
-const int NPH_CACHE_INCREMENT = 16;
 
+/**
+	Allocates note play handles from a SlabPool, so they are contiguous in memory and
+	acquiring and releasing them is lock-free. The pool grows in the background;
+	if it is exhausted before that, acquire() returns nullptr and the note is dropped.
+	Failed acquisitions are counted in the statistics.
+*/
 class NotePlayHandleManager
 {
 public:
+	using Statistics = SlabPool::Statistics;
+
 	static void init();
+	//! @returns nullptr if the pool is exhausted. AudioEngine::addPlayHandle() accepts
+	//! and drops nullptr, other callers have to skip the note.
 	static NotePlayHandle * acquire( InstrumentTrack* instrumentTrack,
 					const f_cnt_t offset,
 					const f_cnt_t frames,
@@ -348,14 +357,12 @@ public:
 					int midiEventChannel = -1,
 					NotePlayHandle::Origin origin = NotePlayHandle::Origin::MidiClip );
 	static void release( NotePlayHandle * nph );
-	static void extend( int i );
 	static void free();
 
+	static Statistics statistics();
+
 private:
-	static NotePlayHandle ** s_available;
-	static QReadWriteLock s_mutex;
-	static std::atomic_int s_availableIndex;
-	static int s_size;
+	static SlabPool s_pool;
 };
 
 
@@ -26,6 +26,7 @@
 #ifndef LMMS_OSCILLATOR_H
 #define LMMS_OSCILLATOR_H
 
+#include <array>
 #include <cassert>
 #include <fftw3.h>
 #include <memory>
@@ -77,6 +78,7 @@ public:
 	} ;
 	constexpr static auto NumModulationAlgos = static_cast<std::size_t>(ModulationAlgo::Count);
 
+	//! @param m_subOsc modulates this oscillator, not owned by it
 	Oscillator( const IntModel *wave_shape_model,
 			const IntModel *mod_algo_model,
 			const float &freq,
@@ -84,13 +86,14 @@ public:
 			const float &phase_offset,
 			const float &volume,
 			Oscillator *m_subOsc = nullptr);
-	virtual ~Oscillator()
-	{
-		delete m_subOsc;
-	}
+	virtual ~Oscillator() = default;
 
+	//! Creates the FFT plans and starts loading the band-limited wave tables on demand
 	static void waveTableInit();
+	//! Stops loading wave tables and destroys the FFT plans
 	static void destroyFFTPlans();
+	//! Blocks until the band-limited tables of all wave shapes are available
+	static void waitForWaveTables();
 	static std::unique_ptr<OscillatorConstants::waveform_t> generateAntiAliasUserWaveTable(const SampleBuffer* sampleBuffer);
 
 	inline void setUseWaveTable(bool n)
@@ -190,8 +193,7 @@ public:
 		control.f2 = control.f1 < OscillatorConstants::WAVETABLE_LENGTH - 1 ?
 					control.f1 + 1 :
 					0;
-		control.band = waveTableBandFromFreq(
-			m_freq * m_detuning_div_samplerate * Engine::audioEngine()->outputSampleRate());
+		control.band = m_waveTableBand;
 		return control;
 	}
 
@@ -256,6 +258,10 @@ private:
 	// There are many update*() variants; the modulator flag is stored as a member variable to avoid
 	// adding more explicit parameters to all of them. Can be converted to a parameter if needed.
 	bool m_isModulator;
+	// The frequency only changes between periods, so everything derived from it is updated once per period
+	// instead of for every sample
+	int m_waveTableBand = 1;
+	bool m_aboveMaxFreq = false;
 
 	/* Multiband WaveTable */
 	static sample_t s_waveTables[NumWaveShapeTables][OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT][OscillatorConstants::WAVETABLE_LENGTH];
@@ -268,51 +274,61 @@ private:
 	static void generateTriangleWaveTable(int bands, sample_t* table, int firstBand = 1);
 	static void generateSquareWaveTable(int bands, sample_t* table, int firstBand = 1);
 	static void generateFromFFT(int bands, sample_t* table);
-	static void generateWaveTables();
+	static void generateWaveTable(WaveShape shape);
 	static void createFFTPlans();
 
-	/* End Multiband wavetable */
+	// The band-limited tables of a wave shape are loaded by a background thread when first needed
+	//! @returns whether the tables of @p shape can be used, requesting them if not
+	static bool waveTableAvailable(WaveShape shape);
+	static void requestWaveTable(std::size_t table);
+	static void waitForWaveTable(std::size_t table);
+	static void runWaveTableLoader();
+	static void loadWaveTable(std::size_t table);
+	static bool readWaveTableCache(WaveShape shape);
+	static void writeWaveTableCache(WaveShape shape);
 
+	/* End Multiband wavetable */
 
-	void updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
-	void updatePM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
-	void updateAM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
-	void updateMix( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
-	void updateSync( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
-	void updateFM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl );
 
 	float syncInit( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl );
 	inline bool syncOk( float _osc_coeff );
 
-	template<WaveShape W>
+	//! @returns whether the band-limited variant of @p shape is used in this period
+	bool usesWaveTable(WaveShape shape) const;
+
+	template<WaveShape W, bool WaveTable>
 	void updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl );
-	template<WaveShape W>
+	template<WaveShape W, bool WaveTable>
 	void updatePM( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl );
-	template<WaveShape W>
+	template<WaveShape W, bool WaveTable>
 	void updateAM( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl );
-	template<WaveShape W>
+	template<WaveShape W, bool WaveTable>
 	void updateMix( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl );
-	template<WaveShape W>
+	template<WaveShape W, bool WaveTable>
 	void updateSync( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl );
-	template<WaveShape W>
+	template<WaveShape W, bool WaveTable>
 	void updateFM( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl );
 
-	template<WaveShape W>
+	template<WaveShape W, bool WaveTable>
 	inline sample_t getSample( const float _sample );
 
+	using UpdateKernel = void (Oscillator::*)(SampleFrame*, const f_cnt_t, const ch_cnt_t);
+	//! Indexed by [modulation algorithm, or NumModulationAlgos without sub oscillator][wave shape][wavetable]
+	using KernelTable = std::array<std::array<std::array<UpdateKernel, 2>, NumWaveShapes>, NumModulationAlgos + 1>;
+
+	template<WaveShape W, bool WaveTable>
+	static constexpr auto kernelsFor() -> std::array<UpdateKernel, NumModulationAlgos + 1>;
+	static constexpr auto makeKernelTable() -> KernelTable;
+
+	static const KernelTable s_kernels;
+
 	inline void recalcPhase();
 
 } ;
@@ -133,6 +133,12 @@ public:
 	{
 		m_usesBuffer = b;
 	}
+
+	//! @returns false if no buffer could be acquired because the BufferManager's pool was exhausted
+	bool hasBuffer() const
+	{
+		return m_playHandleBuffer != nullptr;
+	}
 	
 	AudioBusHandle* audioBusHandle()
 	{
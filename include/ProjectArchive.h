@@ -0,0 +1,132 @@
+/*
+ * ProjectArchive.h - indexed, chunked container for projects
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_PROJECT_ARCHIVE_H
+#define LMMS_PROJECT_ARCHIVE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QString>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "lmms_export.h"
+
+class QIODevice;
+
+namespace lmms
+{
+
+/**
+	A project stored as an indexed archive of chunks, saved with the "mmpc" extension.
+
+	The project XML and the sample data embedded in it are stored in separate chunks, so opening a project does not
+	need to read, inflate or base64-decode any audio. Attributes holding sample data in .mmp projects instead hold
+	a reference to their chunk, see isChunkReference(), which is only read when the sample is restored.
+
+	Layout, all integers little endian:
+	  - header: magic "LMPA", version (u32), offset of the index (u64)
+	  - the chunks' data
+	  - index: number of chunks (u32), and per chunk its name (QDataStream QString), compression (u32),
+	    offset (u64), stored size (u64) and decompressed size (u64)
+*/
+class LMMS_EXPORT ProjectArchive
+{
+public:
+	enum class Compression : quint32
+	{
+		None,
+		Zlib
+	};
+
+	struct Chunk
+	{
+		QString name;
+		Compression compression = Compression::None;
+		quint64 offset = 0;
+		quint64 size = 0; //!< Bytes stored in the archive
+		quint64 rawSize = 0; //!< Bytes after decompression
+	};
+
+	//! Writes the chunks of an archive to a seekable device one after the other, so they need not be held in memory
+	class LMMS_EXPORT Writer
+	{
+	public:
+		explicit Writer(QIODevice& output);
+
+		void add(const QString& name, const QByteArray& data, Compression compression);
+		//! Writes the index, and returns whether all data was written successfully
+		auto finish() -> bool;
+
+	private:
+		QIODevice& m_output;
+		std::vector<Chunk> m_chunks;
+		bool m_ok;
+	};
+
+	//! Name of the chunk holding the project XML
+	static inline const auto DocumentChunk = QStringLiteral("project.xml");
+	//! Attribute of the document element of a project loaded from an archive, holding the archive's path
+	static inline const auto PathAttribute = QStringLiteral("archive");
+
+	//! Whether @p device holds an archive, without consuming any data
+	static auto isArchive(QIODevice& device) -> bool;
+
+	/**
+		Opens the archive at @p path and reads its index, or returns nullptr if it isn't a valid archive.
+		While an archive of the unchanged file is open, it is returned instead.
+	*/
+	static auto open(const QString& path) -> std::shared_ptr<const ProjectArchive>;
+
+	//! Attribute value referring to the chunk @p name
+	static auto chunkReference(const QString& name) -> QString;
+	//! Whether @p value refers to a chunk instead of holding base64 encoded data
+	static auto isChunkReference(const QString& value) -> bool;
+	static auto chunkName(const QString& reference) -> QString;
+
+	auto path() const -> const QString& { return m_path; }
+	auto chunks() const -> const std::vector<Chunk>& { return m_chunks; }
+	auto find(const QString& name) const -> const Chunk*;
+
+	//! Reads and decompresses only the chunk @p name. Returns an empty array if it is missing or corrupted.
+	auto read(const QString& name) const -> QByteArray;
+
+private:
+	ProjectArchive(const QString& path);
+
+	auto readIndex() -> bool;
+
+	QString m_path;
+	QDateTime m_lastModified;
+	std::vector<Chunk> m_chunks;
+
+	mutable std::mutex m_fileMutex;
+	mutable QFile m_file;
+};
+
+} // namespace lmms
+
+#endif // LMMS_PROJECT_ARCHIVE_H
@@ -0,0 +1,82 @@
+/*
+ * ProjectPrefetcher.h - loads the files of a project in the background
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_PROJECT_PREFETCHER_H
+#define LMMS_PROJECT_PREFETCHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class QDomElement;
+
+namespace lmms
+{
+
+class SampleBuffer;
+
+/**
+	Loads the files a project refers to on the ThreadPool, while Song::loadProject() restores the project.
+
+	Samples are decoded with SampleBuffer::fromFile(), whose cache hands them to the clips and instruments when
+	they are restored, or lets them wait for a decode still in progress. Other files, like soundfonts, are read
+	once so the plugins restoring them find them in the operating system's file cache.
+*/
+class ProjectPrefetcher
+{
+public:
+	//! Starts loading the files referenced by @p project, in document order
+	explicit ProjectPrefetcher(const QDomElement& project);
+	//! Waits for the files still loading
+	~ProjectPrefetcher();
+
+	ProjectPrefetcher(const ProjectPrefetcher&) = delete;
+	auto operator=(const ProjectPrefetcher&) -> ProjectPrefetcher& = delete;
+
+	auto total() const -> std::size_t { return m_tasks.size(); }
+	auto done() const -> std::size_t;
+
+	//! Waits until all files are loaded or @p timeout passed, and returns whether all are loaded
+	auto waitFor(std::chrono::milliseconds timeout) -> bool;
+	void wait();
+
+private:
+	void finishTask();
+
+	std::vector<std::future<void>> m_tasks;
+	//! Keeps the decoded samples in the cache until the project took them over
+	std::vector<std::shared_ptr<const SampleBuffer>> m_samples;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_finished;
+	std::size_t m_done = 0;
+};
+
+} // namespace lmms
+
+#endif // LMMS_PROJECT_PREFETCHER_H
@@ -25,6 +25,10 @@
 #ifndef LMMS_PROJECT_RENDERER_H
 #define LMMS_PROJECT_RENDERER_H
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "AudioFileDevice.h"
 #include "AudioEngine.h"
 #include "OutputSettings.h"
@@ -59,8 +63,28 @@ public:
 		AudioFileDeviceInstantiaton m_getDevInst;
 	} ;
 
+	//! Output file of a single audio bus handle when rendering stems
+	using Stem = std::pair<AudioBusHandle*, QString>;
+
+	//! Timings of a finished export, in seconds
+	struct Statistics
+	{
+		double audioLength = 0.0; //!< length of the rendered audio
+		double total = 0.0; //!< wall-clock time of the whole export
+		double rendering = 0.0; //!< time spent rendering periods
+		double encoding = 0.0; //!< time spent encoding and writing (runs in parallel to rendering)
+		double encoderWait = 0.0; //!< time rendering had to wait for the encoder to catch up
+
+		double realtimeFactor() const { return total > 0.0 ? audioLength / total : 0.0; }
+	};
+
 	ProjectRenderer(const OutputSettings& _os, ExportFileFormat _file_format, const QString& _out_file);
-	~ProjectRenderer() override = default;
+
+	//! Render the song once and write the output of each of the given audio bus handles
+	//! (instead of the master output) into its own file
+	ProjectRenderer(const OutputSettings& _os, ExportFileFormat _file_format, const std::vector<Stem>& stems);
+
+	~ProjectRenderer() override;
 
 	bool isReady() const
 	{
@@ -74,6 +98,19 @@ public:
 
 	static const std::array<FileEncodeDevice, 5> fileEncodeDevices;
 
+	//! @returns the timings of the export, valid once the renderer has finished
+	const Statistics& statistics() const
+	{
+		return m_statistics;
+	}
+
+	//! @returns whether the whole song has been rendered without being aborted,
+	//! valid once the renderer has finished
+	bool hasSucceeded() const
+	{
+		return m_succeeded;
+	}
+
 public slots:
 	void startProcessing();
 	void abortProcessing();
@@ -86,10 +123,24 @@ signals:
 
 
 private:
+	class Encoder;
+	class StemWriter;
+
+	static AudioFileDevice* createFileDevice(const OutputSettings& outputSettings,
+		ExportFileFormat fileFormat, const QString& outputFilename);
+
 	void run() override;
+	void writeStems();
 
+	//! Device the audio engine renders to. Ownership is passed to the audio engine.
 	AudioFileDevice * m_fileDev;
 
+	std::vector<std::unique_ptr<StemWriter>> m_stems;
+	std::unique_ptr<Encoder> m_encoder;
+
+	Statistics m_statistics;
+	bool m_succeeded = false;
+
 	volatile int m_progress;
 	volatile bool m_abort;
 
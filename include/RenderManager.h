@@ -27,6 +27,7 @@
 #define LMMS_RENDER_MANAGER_H
 
 #include <memory>
+#include <vector>
 
 #include "ProjectRenderer.h"
 #include "OutputSettings.h"
@@ -47,33 +48,62 @@ public:
 	/// Export all unmuted tracks into a single file
 	void renderProject();
 
-	/// Export all unmuted tracks into individual file
-	void renderTracks();
+	//! What the file of each track contains when rendering tracks individually
+	enum class StemSource
+	{
+		//! The master output with all other tracks muted, including mixer and master effects.
+		//! The song is rendered once per track.
+		Master,
+		//! The output of the track itself, i.e. after its effects, volume and panning, but
+		//! without any mixer processing. All tracks are rendered in a single pass.
+		Track
+	};
+
+	/// Export all unmuted tracks into individual files
+	void renderTracks(StemSource source = StemSource::Master);
 
 	void abortProcessing();
 
+	//! @returns the timings of the last finished render
+	const ProjectRenderer::Statistics& statistics() const
+	{
+		return m_statistics;
+	}
+
+	//! @returns whether the last render finished without errors
+	bool succeeded() const
+	{
+		return m_succeeded;
+	}
+
+	//! Print the timings of the last finished render to the console
+	void printStatistics() const;
+
 signals:
 	void progressChanged( int );
 	void finished();
 
 private slots:
-	void renderNextTrack();
+	void renderFinished();
 	void updateConsoleProgress();
 
 private:
 	QString pathForTrack( const Track *track, int num );
+	void renderNextTrack();
 	void restoreMutedState();
 
-	void render( QString outputPath );
+	void render(std::unique_ptr<ProjectRenderer> renderer);
 
 	const OutputSettings m_outputSettings;
 	ProjectRenderer::ExportFileFormat m_format;
 	QString m_outputPath;
 
-	std::unique_ptr<ProjectRenderer> m_activeRenderer;
-
 	std::vector<Track*> m_tracksToRender;
 	std::vector<Track*> m_unmuted;
+
+	std::unique_ptr<ProjectRenderer> m_activeRenderer;
+	ProjectRenderer::Statistics m_statistics;
+	bool m_succeeded = false;
 } ;
 
 
@@ -33,6 +33,8 @@
 #include "lmms_export.h"
 
 namespace lmms {
+class SampleStream;
+
 class LMMS_EXPORT Sample
 {
 public:
@@ -73,13 +75,22 @@ public:
 	Sample(const Sample& other);
 	Sample(Sample&& other) noexcept;
 	explicit Sample(std::shared_ptr<const SampleBuffer> buffer);
+	~Sample();
 
 	auto operator=(const Sample&) -> Sample&;
 	auto operator=(Sample&&) noexcept -> Sample&;
 
+	/**
+	 * Renders the sample from @p state on. Memory-mapped samples are read ahead by a stream following the position
+	 * played last, so they should only be played at one position at a time. Frames not read ahead in time are
+	 * rendered as silence instead of waiting for the disk, unless the song is being exported.
+	 */
 	auto play(SampleFrame* dst, PlaybackState* state, size_t numFrames, Loop loopMode = Loop::Off,
 		double ratio = 1.0) const -> bool;
 
+	//! Reads a memory-mapped sample ahead of @p frameIndex before it is played from there. Not real-time safe.
+	void prefetch(int frameIndex) const;
+
 	auto sampleDuration() const -> std::chrono::milliseconds;
 	auto sampleFile() const -> const QString& { return m_buffer->audioFile(); }
 	auto sampleRate() const -> int { return m_buffer->sampleRate(); }
@@ -107,7 +118,15 @@ public:
 	void setReversed(bool reversed) { m_reversed.store(reversed, std::memory_order_relaxed); }
 
 private:
+	//! Opens the stream reading a memory-mapped buffer ahead, off the audio thread
+	void openStream();
+	void closeStream();
+	//! The frame of the buffer that is played at @p frameIndex
+	auto bufferFrame(int frameIndex) const -> f_cnt_t;
+
 	f_cnt_t render(SampleFrame* dst, f_cnt_t size, PlaybackState* state, Loop loop) const;
+	template<typename Source>
+	f_cnt_t render(SampleFrame* dst, f_cnt_t size, PlaybackState* state, Loop loop, Source&& source) const;
 	std::shared_ptr<const SampleBuffer> m_buffer = SampleBuffer::emptyBuffer();
 	std::atomic<int> m_startFrame = 0;
 	std::atomic<int> m_endFrame = 0;
@@ -116,6 +135,8 @@ private:
 	std::atomic<float> m_amplification = 1.0f;
 	std::atomic<float> m_frequency = DefaultBaseFreq;
 	std::atomic<bool> m_reversed = false;
+	//! Reads m_buffer ahead of playback if it is memory-mapped
+	SampleStream* m_stream = nullptr;
 };
 } // namespace lmms
 #endif
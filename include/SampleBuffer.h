@@ -26,7 +26,9 @@
 #define LMMS_SAMPLE_BUFFER_H
 
 #include <QString>
+#include <iterator>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "AudioEngine.h"
@@ -34,6 +36,8 @@
 #include "LmmsTypes.h"
 #include "lmms_export.h"
 
+class QDomElement;
+
 namespace lmms {
 class LMMS_EXPORT SampleBuffer
 {
@@ -41,12 +45,12 @@ public:
 	using value_type = SampleFrame;
 	using reference = SampleFrame&;
 	using const_reference = const SampleFrame&;
-	using iterator = std::vector<SampleFrame>::iterator;
-	using const_iterator = std::vector<SampleFrame>::const_iterator;
-	using difference_type = std::vector<SampleFrame>::difference_type;
-	using size_type = std::vector<SampleFrame>::size_type;
-	using reverse_iterator = std::vector<SampleFrame>::reverse_iterator;
-	using const_reverse_iterator = std::vector<SampleFrame>::const_reverse_iterator;
+	using iterator = SampleFrame*;
+	using const_iterator = const SampleFrame*;
+	using difference_type = std::ptrdiff_t;
+	using size_type = std::size_t;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
 	SampleBuffer() = default;
 	SampleBuffer(std::vector<SampleFrame> data, int sampleRate, const QString& audioFile = "");
@@ -59,36 +63,69 @@ public:
 	auto audioFile() const -> const QString& { return m_audioFile; }
 	auto sampleRate() const -> sample_rate_t { return m_sampleRate; }
 
-	auto begin() -> iterator { return m_data.begin(); }
-	auto end() -> iterator { return m_data.end(); }
+	// Mapped buffers are read-only, the non-const iterators only cover frames held in memory
+	auto begin() -> iterator { return m_data.data(); }
+	auto end() -> iterator { return m_data.data() + m_data.size(); }
+
+	auto begin() const -> const_iterator { return data(); }
+	auto end() const -> const_iterator { return data() + size(); }
 
-	auto begin() const -> const_iterator { return m_data.begin(); }
-	auto end() const -> const_iterator { return m_data.end(); }
+	auto cbegin() const -> const_iterator { return begin(); }
+	auto cend() const -> const_iterator { return end(); }
 
-	auto cbegin() const -> const_iterator { return m_data.cbegin(); }
-	auto cend() const -> const_iterator { return m_data.cend(); }
+	auto rbegin() -> reverse_iterator { return reverse_iterator{end()}; }
+	auto rend() -> reverse_iterator { return reverse_iterator{begin()}; }
 
-	auto rbegin() -> reverse_iterator { return m_data.rbegin(); }
-	auto rend() -> reverse_iterator { return m_data.rend(); }
+	auto rbegin() const -> const_reverse_iterator { return const_reverse_iterator{end()}; }
+	auto rend() const -> const_reverse_iterator { return const_reverse_iterator{begin()}; }
 
-	auto rbegin() const -> const_reverse_iterator { return m_data.rbegin(); }
-	auto rend() const -> const_reverse_iterator { return m_data.rend(); }
+	auto crbegin() const -> const_reverse_iterator { return rbegin(); }
+	auto crend() const -> const_reverse_iterator { return rend(); }
 
-	auto crbegin() const -> const_reverse_iterator { return m_data.crbegin(); }
-	auto crend() const -> const_reverse_iterator { return m_data.crend(); }
+	auto data() const -> const SampleFrame* { return m_mapping ? m_mappedData.data() : m_data.data(); }
+	auto size() const -> size_type { return m_mapping ? m_mappedData.size() : m_data.size(); }
+	auto empty() const -> bool { return size() == 0; }
 
-	auto data() const -> const SampleFrame* { return m_data.data(); }
-	auto size() const -> size_type { return m_data.size(); }
-	auto empty() const -> bool { return m_data.empty(); }
+	//! Whether the frames are memory-mapped from the decoded sample cache instead of being held in memory
+	auto isMapped() const -> bool { return m_mapping != nullptr; }
 
 	static auto emptyBuffer() -> std::shared_ptr<const SampleBuffer>;
 
-	static std::shared_ptr<const SampleBuffer> fromFile(const QString& path);
+	/**
+	 * Decodes the audio file at @p path. While a buffer decoded from the same unchanged file is alive, it is
+	 * returned instead, and concurrent calls for the same file wait for a single decode.
+	 *
+	 * If @p streamable, long files are decoded into the sample cache on disk and memory-mapped from there instead
+	 * of being loaded into memory, see isMapped(). Sample streams mapped buffers ahead of a single position, so
+	 * only pass it for samples played at one position at a time, like the ones of sample clips.
+	 */
+	static std::shared_ptr<const SampleBuffer> fromFile(const QString& path, bool streamable = false);
 	static std::shared_ptr<const SampleBuffer> fromBase64(
 		const QString& str, int sampleRate = Engine::audioEngine()->outputSampleRate());
+	/**
+	 * Loads the sample data saved in @p attribute of @p element. It is either base64 encoded, or refers to a chunk
+	 * of the ProjectArchive the element was loaded from, which is then read without reading the rest of the archive.
+	 */
+	static std::shared_ptr<const SampleBuffer> fromAttribute(const QDomElement& element, const QString& attribute,
+		int sampleRate = Engine::audioEngine()->outputSampleRate());
+
+	//! Size in bytes of the sample data currently shared by fromFile(), not counting memory-mapped samples
+	static auto cachedMemoryUsage() -> std::size_t;
 
 private:
+	SampleBuffer(std::shared_ptr<const void> mapping, std::span<const SampleFrame> data, int sampleRate,
+		const QString& audioFile);
+
+	static std::shared_ptr<const SampleBuffer> fromBytes(const QByteArray& bytes, int sampleRate);
+	static auto decodeFile(const QString& absolutePath, const QString& storedPath, bool streamable)
+		-> std::shared_ptr<const SampleBuffer>;
+	static auto mapDecodedFile(const QString& absolutePath, const QString& storedPath)
+		-> std::shared_ptr<const SampleBuffer>;
+
 	std::vector<SampleFrame> m_data;
+	//! Keeps the mapping of m_mappedData alive, if the buffer is memory-mapped
+	std::shared_ptr<const void> m_mapping;
+	std::span<const SampleFrame> m_mappedData;
 	QString m_audioFile;
 	sample_rate_t m_sampleRate = Engine::audioEngine()->outputSampleRate();
 };
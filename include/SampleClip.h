@@ -97,6 +97,10 @@ public slots:
 protected:
 	SampleClip( const SampleClip& orig );
 
+private slots:
+	//! Reads a memory-mapped sample ahead of where the song starts playing it
+	void prefetchSample();
+
 private:
 	Sample m_sample;
 	BoolModel m_recordModel;
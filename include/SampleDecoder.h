@@ -25,11 +25,13 @@
 #ifndef LMMS_SAMPLE_DECODER_H
 #define LMMS_SAMPLE_DECODER_H
 
+#include <QIODevice>
 #include <QString>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "LmmsTypes.h"
 #include "SampleFrame.h"
 
 namespace lmms {
@@ -48,7 +50,21 @@ public:
 		std::string extension;
 	};
 
+	//! Length and sample rate of an audio file
+	struct Info
+	{
+		f_cnt_t frames;
+		int sampleRate;
+	};
+
 	static auto decode(const QString& audioFile) -> std::optional<Result>;
+	//! Reads the length and sample rate of @p audioFile without decoding it. Only formats libsndfile reads are supported.
+	static auto info(const QString& audioFile) -> std::optional<Info>;
+	/**
+	 * Decodes @p audioFile like decode(), but writes the frames to @p output in chunks, so the decoded file never has
+	 * to fit into memory. Only formats libsndfile reads are supported.
+	 */
+	static auto decode(const QString& audioFile, QIODevice& output) -> std::optional<Info>;
 	static auto supportedAudioTypes() -> const std::vector<AudioType>&;
 };
 } // namespace lmms
@@ -0,0 +1,149 @@
+/*
+ * SampleStream.h - reads memory-mapped samples ahead of playback
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SAMPLE_STREAM_H
+#define LMMS_SAMPLE_STREAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "LmmsTypes.h"
+#include "SampleFrame.h"
+
+namespace lmms {
+
+class SampleBuffer;
+
+/**
+	Reads a memory-mapped SampleBuffer ahead of one playback position on a background I/O thread, so the audio
+	thread never waits for the disk when playing long samples.
+
+	The frames are copied into a ring holding a contiguous window of the buffer, which the I/O thread keeps ahead of
+	the position the audio thread published last, in either direction. Frames outside of the window, e.g. right
+	after a jump to the loop start, are not read from the mapping on the audio thread. They are rendered as silence
+	and counted as an underrun until the I/O thread has caught up.
+
+	Streams are opened and pre-filled off the audio thread. The audio thread only publishes positions, reads views
+	and closes streams, all without locking or allocating, and the I/O thread deletes closed streams.
+*/
+class SampleStream
+{
+public:
+	//! Frames read ahead at most
+	static constexpr auto Capacity = f_cnt_t{1} << 16;
+
+	/**
+	 * Starts reading @p buffer ahead of @p frame, towards its end or its start. The window is filled before the
+	 * stream is returned. Not real-time safe.
+	 */
+	static auto open(std::shared_ptr<const SampleBuffer> buffer, f_cnt_t frame = 0, bool backwards = false)
+		-> SampleStream*;
+	//! Stops reading ahead. The stream must not be used afterwards.
+	void close();
+
+	auto buffer() const -> const SampleBuffer* { return m_buffer.get(); }
+
+	//! Tells the I/O thread that playback continues at @p frame of the buffer, towards its end or its start
+	void setPosition(f_cnt_t frame, bool backwards)
+	{
+		m_backwards.store(backwards, std::memory_order_relaxed);
+		m_position.store(frame, std::memory_order_release);
+	}
+
+	//! Like setPosition(), but waits until the I/O thread has read the frames following @p frame. Not real-time safe.
+	void prefetch(f_cnt_t frame, bool backwards);
+
+	//! Number of chunks rendered as silence because their frames had not been read ahead in time
+	auto underruns() const -> std::size_t { return m_underruns.load(std::memory_order_relaxed); }
+
+	//! The frames read ahead when it was created, for rendering one chunk on the audio thread
+	class View
+	{
+	public:
+		explicit View(const SampleStream& stream);
+
+		auto operator[](f_cnt_t frame) -> const SampleFrame&
+		{
+			if (frame < m_begin || frame >= m_end)
+			{
+				m_missed = true;
+				return s_silence;
+			}
+			m_firstRead = std::min(m_firstRead, frame);
+			m_lastRead = std::max(m_lastRead, frame);
+			return m_ring[frame % Capacity];
+		}
+
+		/**
+		 * Whether all frames returned so far had been read ahead and were left untouched by the I/O thread.
+		 * Otherwise, an underrun is counted, and the frames must be replaced with silence.
+		 */
+		auto complete() const -> bool;
+
+	private:
+		static inline const auto s_silence = SampleFrame{};
+
+		const SampleStream& m_stream;
+		const SampleFrame* m_ring;
+		f_cnt_t m_sequence;
+		f_cnt_t m_begin;
+		f_cnt_t m_end;
+		f_cnt_t m_firstRead;
+		f_cnt_t m_lastRead = 0;
+		bool m_missed = false;
+	};
+
+private:
+	class ReadAheadThread;
+
+	explicit SampleStream(std::shared_ptr<const SampleBuffer> buffer);
+
+	static auto readAheadThread() -> ReadAheadThread&;
+
+	//! Moves the window towards the published position, called on the I/O thread
+	void readAhead();
+	void copyToRing(f_cnt_t begin, f_cnt_t end);
+	//! Whether the window holds the @p frames following @p position in the direction of playback
+	auto isReadAhead(f_cnt_t position, bool backwards, f_cnt_t frames) const -> bool;
+
+	const std::shared_ptr<const SampleBuffer> m_buffer;
+	const std::unique_ptr<SampleFrame[]> m_ring;
+
+	std::atomic<f_cnt_t> m_position = 0;
+	std::atomic<bool> m_backwards = false;
+	std::atomic<bool> m_closed = false;
+	mutable std::atomic<std::size_t> m_underruns = 0;
+
+	//! The frames in the ring. Only written by the I/O thread, or by open() before the stream is shared.
+	std::atomic<f_cnt_t> m_begin = 0;
+	std::atomic<f_cnt_t> m_end = 0;
+	//! Odd while the window jumps to a new position, so views can tell that frames were replaced
+	std::atomic<f_cnt_t> m_sequence = 0;
+};
+
+} // namespace lmms
+
+#endif // LMMS_SAMPLE_STREAM_H
@@ -0,0 +1,121 @@
+/*
+ * SlabPool.h - realtime-safe pool of fixed-size elements which grows in the background
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SLAB_POOL_H
+#define LMMS_SLAB_POOL_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+#include "LmmsSemaphore.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class LocklessAllocator;
+
+/**
+	Pool of fixed-size elements for the audio threads.
+
+	The elements live in contiguous slabs, each managed by a LocklessAllocator, so
+	allocating and freeing is lock-free. When the last slab is running low, another
+	slab is allocated on a background thread. If the pool is exhausted nevertheless,
+	the allocation fails instead of touching the heap on the audio thread. Failed
+	allocations are counted in the statistics, so the pool can be sized accordingly.
+*/
+class LMMS_EXPORT SlabPool
+{
+public:
+	struct Statistics
+	{
+		std::size_t capacity = 0; //!< number of elements in the slabs
+		std::size_t inUse = 0; //!< number of currently allocated elements
+		std::size_t highWaterMark = 0; //!< maximum of `inUse` since the pool was created
+		std::size_t failedAllocations = 0; //!< allocations which failed because the pool was exhausted
+	};
+
+	//! @param slabSize number of elements per slab
+	explicit SlabPool(std::size_t slabSize);
+	~SlabPool();
+
+	SlabPool(const SlabPool&) = delete;
+	SlabPool& operator=(const SlabPool&) = delete;
+
+	/**
+		(Re)creates the pool with a single slab and starts the background thread.
+		Not realtime-safe. Elements allocated from a previous pool become invalid.
+	*/
+	void create(std::size_t elementSize, std::size_t alignment);
+
+	//! Frees all slabs and stops the background thread
+	void destroy();
+
+	//! @returns uninitialized memory for one element, or nullptr if the pool is exhausted. Lock-free.
+	void* allocate();
+
+	//! Frees an element returned by allocate(). Lock-free.
+	void deallocate(void* element);
+
+	Statistics statistics() const;
+
+	//! Incremented whenever the pool is recreated, so cached elements of an old pool can be detected
+	unsigned generation() const { return m_generation.load(std::memory_order_acquire); }
+
+private:
+	static constexpr std::size_t MaxSlabs = 32;
+
+	void addSlab();
+	void clear();
+	void requestGrowth();
+	void runGrower();
+
+	const std::size_t m_slabSize;
+	//! Another slab is allocated once fewer elements are available in the last one
+	const std::size_t m_lowWaterMark;
+
+	std::array<std::atomic<LocklessAllocator*>, MaxSlabs> m_slabs = {};
+	std::atomic<std::size_t> m_slabCount = 0;
+	std::size_t m_elementSize = 0;
+	std::size_t m_alignment = 0;
+	std::atomic<unsigned> m_generation = 0;
+
+	std::atomic<std::size_t> m_inUse = 0;
+	std::atomic<std::size_t> m_highWaterMark = 0;
+	std::atomic<std::size_t> m_failedAllocations = 0;
+
+	//! Serializes adding and removing slabs, never locked by the audio threads
+	std::mutex m_slabMutex;
+	Semaphore m_growRequest{0};
+	std::atomic<bool> m_growthRequested = false;
+	std::atomic<bool> m_quit = false;
+	std::thread m_grower;
+};
+
+} // namespace lmms
+
+#endif // LMMS_SLAB_POOL_H
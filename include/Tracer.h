@@ -0,0 +1,100 @@
+/*
+ * Tracer.h - records render events for viewing them in a trace viewer
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_TRACER_H
+#define LMMS_TRACER_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "lmms_export.h"
+
+class QString;
+
+namespace lmms
+{
+
+/**
+	Opt-in recording of timed events (render stages, worker jobs, effects, ...)
+	which can be written to a Chrome trace JSON file, viewable in Perfetto or
+	chrome://tracing.
+
+	Each thread records into its own ring buffer, which is allocated by start().
+	Recording an event neither allocates nor locks, so it is realtime safe. If a
+	ring buffer is full, its oldest events get overwritten.
+*/
+class LMMS_EXPORT Tracer
+{
+public:
+	//! Allocate the buffers and start recording. Not realtime safe, and nothing may be
+	//! recording events while it runs, e.g. call it before starting to render.
+	static void start();
+
+	//! Stop recording and write all recorded events to @p fileName. Not realtime safe.
+	//! @returns false if the file couldn't be written
+	static bool stop(const QString& fileName);
+
+	static bool isRecording() { return s_recording.load(std::memory_order_relaxed); }
+
+	//! Name the calling thread in the trace, e.g. "Worker 2" for @p name "Worker" and @p index 2.
+	//! Call this before recording any event from the thread.
+	static void setThreadName(const char* name, int index = -1);
+
+	//! Records an event lasting from construction to destruction. Names have to be string
+	//! literals or otherwise outlive the tracer, as only the pointers are stored.
+	class Scope
+	{
+	public:
+		Scope(const char* name, const char* detail = nullptr)
+		{
+			if (!isRecording()) { return; }
+			m_name = name;
+			m_detail = detail;
+			m_begin = now();
+		}
+		~Scope()
+		{
+			if (m_name) { record(m_name, m_detail, m_begin, now()); }
+		}
+		Scope& operator=(const Scope&) = delete;
+		Scope(const Scope&) = delete;
+		Scope(Scope&&) = delete;
+
+	private:
+		const char* m_name = nullptr;
+		const char* m_detail = nullptr;
+		std::int64_t m_begin = 0;
+	};
+
+private:
+	//! @returns the time in nanoseconds
+	static std::int64_t now();
+	static void record(const char* name, const char* detail, std::int64_t begin, std::int64_t end);
+
+	static std::atomic<bool> s_recording;
+};
+
+} // namespace lmms
+
+#endif // LMMS_TRACER_H
@@ -25,6 +25,7 @@
 #ifndef LMMS_TRACK_H
 #define LMMS_TRACK_H
 
+#include <memory>
 #include <vector>
 
 #include <QColor>
@@ -41,6 +42,7 @@ namespace lmms
 class TimePos;
 class TrackContainer;
 class Clip;
+class ClipSchedule;
 
 
 namespace gui
@@ -132,6 +134,8 @@ public:
 	{
 		return m_clips;
 	}
+	//! Looks up the clips in a schedule which is kept up to date on edits, so it is cheap enough to be called
+	//! for every tick
 	void getClipsInRange( clipVector & clipV, const TimePos & start,
 							const TimePos & end );
 	void swapPositionOfClips( int clipNum1, int clipNum2 );
@@ -211,6 +215,17 @@ private:
 	void saveTrack(QDomDocument& doc, QDomElement& element, bool presetMode);
 	void loadTrack(const QDomElement& element, bool presetMode);
 
+	//! Marks the clip schedule as out of date after clips were added, removed, moved or resized
+	void invalidateClipSchedule();
+	//! Rebuilds the clip schedule if it is out of date
+	void updateClipSchedule();
+
+	//! Defer rebuilding the clip schedule until the outermost batch ends, so changing many clips
+	//! only rebuilds it once. The audio engine stays locked meanwhile, so playback never sees a
+	//! schedule that still contains removed clips.
+	void beginClipScheduleBatch();
+	void endClipScheduleBatch();
+
 private:
 	TrackContainer* m_trackContainer;
 	Type m_type;
@@ -225,6 +240,10 @@ private:
 	bool m_mutedBeforeSolo;
 
 	clipVector m_clips;
+	//! Snapshot of m_clips for playback, only replaced while the audio engine is locked
+	std::unique_ptr<const ClipSchedule> m_clipSchedule;
+	bool m_clipScheduleDirty = false;
+	int m_clipScheduleBatchDepth = 0;
 
 	QMutex m_processingLock;
 	
@@ -51,13 +51,13 @@ Plugin::Descriptor PLUGIN_EXPORT amplifier_plugin_descriptor =
 
 
 AmplifierEffect::AmplifierEffect(Model* parent, const Descriptor::SubPluginFeatures::Key* key) :
-	Effect(&amplifier_plugin_descriptor, parent, key),
+	PlanarEffect(&amplifier_plugin_descriptor, parent, key),
 	m_ampControls(this)
 {
 }
 
 
-Effect::ProcessStatus AmplifierEffect::processImpl(SampleFrame* buf, const f_cnt_t frames)
+Effect::ProcessStatus AmplifierEffect::processPlanarImpl(PlanarBufferView<sample_t, 2> inOut)
 {
 	const float d = dryLevel();
 	const float w = wetLevel();
@@ -67,7 +67,9 @@ Effect::ProcessStatus AmplifierEffect::processImpl(SampleFrame* buf, const f_cnt
 	const ValueBuffer* leftBuf = m_ampControls.m_leftModel.valueBuffer();
 	const ValueBuffer* rightBuf = m_ampControls.m_rightModel.valueBuffer();
 
-	for (f_cnt_t f = 0; f < frames; ++f)
+	auto* leftChannel = inOut.bufferPtr<0>();
+	auto* rightChannel = inOut.bufferPtr<1>();
+	for (f_cnt_t f = 0; f < inOut.frames(); ++f)
 	{
 		const float volume = (volumeBuf ? volumeBuf->value(f) : m_ampControls.m_volumeModel.value()) * 0.01f;
 		const float pan = (panBuf ? panBuf->value(f) : m_ampControls.m_panModel.value()) * 0.01f;
@@ -77,12 +79,12 @@ Effect::ProcessStatus AmplifierEffect::processImpl(SampleFrame* buf, const f_cnt
 		const float panLeft = std::min(1.0f, 1.0f - pan);
 		const float panRight = std::min(1.0f, 1.0f + pan);
 
-		auto& currentFrame = buf[f];
-
-		const auto s = currentFrame * SampleFrame(left * panLeft, right * panRight) * volume;
+		const float sLeft = leftChannel[f] * (left * panLeft) * volume;
+		const float sRight = rightChannel[f] * (right * panRight) * volume;
 
 		// Dry/wet mix
-		currentFrame = currentFrame * d + s * w;
+		leftChannel[f] = leftChannel[f] * d + sLeft * w;
+		rightChannel[f] = rightChannel[f] * d + sRight * w;
 	}
 
 	return ProcessStatus::ContinueIfNotQuiet;
@@ -32,13 +32,13 @@
 namespace lmms
 {
 
-class AmplifierEffect : public Effect
+class AmplifierEffect : public PlanarEffect
 {
 public:
 	AmplifierEffect(Model* parent, const Descriptor::SubPluginFeatures::Key* key);
 	~AmplifierEffect() override = default;
 
-	ProcessStatus processImpl(SampleFrame* buf, const f_cnt_t frames) override;
+	ProcessStatus processPlanarImpl(PlanarBufferView<sample_t, 2> inOut) override;
 
 	EffectControls* controls() override
 	{
@@ -222,9 +222,9 @@ void AudioFileProcessor::loadSettings(const QDomElement& elem)
 		}
 		else { Engine::getSong()->collectError(QString("%1: %2").arg(tr("Sample not found"), srcFile)); }
 	}
-	else if (auto sampleData = elem.attribute("sampledata"); !sampleData.isEmpty())
+	else if (!elem.attribute("sampledata").isEmpty())
 	{
-		m_sample = Sample(SampleBuffer::fromBase64(sampleData));
+		m_sample = Sample(SampleBuffer::fromAttribute(elem, "sampledata"));
 	}
 
 	m_loopModel.loadSettings(elem, "looped");
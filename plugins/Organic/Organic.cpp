@@ -228,10 +228,9 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 
 	if (!_n->m_pluginData)
 	{
-		auto oscs_l = std::array<Oscillator*, NUM_OSCILLATORS>{};
-		auto oscs_r = std::array<Oscillator*, NUM_OSCILLATORS>{};
-
-		auto newOsc = new oscPtr;
+		auto newOsc = new oscPtr{};
+		auto& oscs_l = newOsc->oscLeft;
+		auto& oscs_r = newOsc->oscRight;
 		_n->m_pluginData = newOsc;
 
 		for (int i = m_numOscillators - 1; i >= 0; --i)
@@ -281,13 +280,11 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 					oscs_r[i + 1]);
 			}
 		}
-		newOsc->oscLeft = oscs_l[0];
-		newOsc->oscRight = oscs_r[0];
 	}
 
 	auto osc = static_cast<oscPtr*>(_n->m_pluginData);
-	osc->oscLeft->update(_working_buffer + offset, frames, 0);
-	osc->oscRight->update(_working_buffer + offset, frames, 1);
+	osc->oscLeft[0]->update(_working_buffer + offset, frames, 0);
+	osc->oscRight[0]->update(_working_buffer + offset, frames, 1);
 
 	// -- fx section --
 
@@ -310,12 +307,14 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 
 void OrganicInstrument::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscLeft );
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscRight );
-
-	delete static_cast<oscPtr *>( _n->m_pluginData );
+	auto osc = static_cast<oscPtr*>(_n->m_pluginData);
+	// oscillators don't own their sub oscillators
+	for (int i = 0; i < NUM_OSCILLATORS; ++i)
+	{
+		delete osc->oscLeft[i];
+		delete osc->oscRight[i];
+	}
+	delete osc;
 }
 
 /*float inline OrganicInstrument::foldback(float in, float threshold)
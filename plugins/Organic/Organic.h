@@ -155,8 +155,9 @@ private:
 
 	struct oscPtr
 	{
-		Oscillator * oscLeft;
-		Oscillator * oscRight;
+		//! The first oscillator is modulated by the following ones
+		Oscillator * oscLeft[NUM_OSCILLATORS];
+		Oscillator * oscRight[NUM_OSCILLATORS];
 		float phaseOffsetLeft[NUM_OSCILLATORS];
 		float phaseOffsetRight[NUM_OSCILLATORS];		
 	} ;
@@ -360,9 +360,9 @@ void SlicerT::loadSettings(const QDomElement& element)
 			Engine::getSong()->collectError(message);
 		}
 	}
-	else if (auto sampleData = element.attribute("sampledata"); !sampleData.isEmpty())
+	else if (!element.attribute("sampledata").isEmpty())
 	{
-		auto buffer = SampleBuffer::fromBase64(sampleData);
+		auto buffer = SampleBuffer::fromAttribute(element, "sampledata");
 		m_originalSample = Sample(std::move(buffer));
 	}
 
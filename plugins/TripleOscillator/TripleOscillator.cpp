@@ -23,6 +23,9 @@
  */
 
 
+#include <array>
+#include <optional>
+
 #include <QDomElement>
 #include <QFileInfo>
 
@@ -67,6 +70,19 @@ Plugin::Descriptor PLUGIN_EXPORT tripleoscillator_plugin_descriptor =
 }
 
 
+namespace
+{
+
+//! The oscillators of a note, allocated at once. Each oscillator is modulated by the following one.
+struct NoteOscillators
+{
+	std::array<std::optional<Oscillator>, NUM_OF_OSCILLATORS> left;
+	std::array<std::optional<Oscillator>, NUM_OF_OSCILLATORS> right;
+};
+
+} // namespace
+
+
 
 OscillatorObject::OscillatorObject( Model * _parent, int _idx ) :
 	Model( _parent ),
@@ -308,74 +324,48 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 {
 	if (!_n->m_pluginData)
 	{
-		auto oscs_l = std::array<Oscillator*, NUM_OF_OSCILLATORS>{};
-		auto oscs_r = std::array<Oscillator*, NUM_OF_OSCILLATORS>{};
+		auto newOscs = new NoteOscillators;
 
-		for( int i = NUM_OF_OSCILLATORS - 1; i >= 0; --i )
+		for (int i = NUM_OF_OSCILLATORS - 1; i >= 0; --i)
 		{
-
-			// the last oscs needs no sub-oscs...
-			if( i == NUM_OF_OSCILLATORS - 1 )
+			// the last oscillator has no sub oscillator
+			const bool last = i == NUM_OF_OSCILLATORS - 1;
+
+			auto& osc_l = newOscs->left[i].emplace(
+					&m_osc[i]->m_waveShapeModel,
+					&m_osc[i]->m_modulationAlgoModel,
+					_n->frequency(),
+					m_osc[i]->m_detuningLeft,
+					m_osc[i]->m_phaseOffsetLeft,
+					m_osc[i]->m_volumeLeft,
+					last ? nullptr : &*newOscs->left[i + 1] );
+			auto& osc_r = newOscs->right[i].emplace(
+					&m_osc[i]->m_waveShapeModel,
+					&m_osc[i]->m_modulationAlgoModel,
+					_n->frequency(),
+					m_osc[i]->m_detuningRight,
+					m_osc[i]->m_phaseOffsetRight,
+					m_osc[i]->m_volumeRight,
+					last ? nullptr : &*newOscs->right[i + 1] );
+
+			for (auto osc : {&osc_l, &osc_r})
 			{
-				oscs_l[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningLeft,
-						m_osc[i]->m_phaseOffsetLeft,
-						m_osc[i]->m_volumeLeft );
-				oscs_l[i]->setUseWaveTable(m_osc[i]->m_useWaveTable);
-				oscs_r[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningRight,
-						m_osc[i]->m_phaseOffsetRight,
-						m_osc[i]->m_volumeRight );
-				oscs_r[i]->setUseWaveTable(m_osc[i]->m_useWaveTable);
+				osc->setUseWaveTable(m_osc[i]->m_useWaveTable);
+				osc->setUserWave(m_osc[i]->m_sampleBuffer);
+				osc->setUserAntiAliasWaveTable(m_osc[i]->m_userAntiAliasWaveTable);
 			}
-			else
-			{
-				oscs_l[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningLeft,
-						m_osc[i]->m_phaseOffsetLeft,
-						m_osc[i]->m_volumeLeft,
-						oscs_l[i + 1] );
-				oscs_l[i]->setUseWaveTable(m_osc[i]->m_useWaveTable);
-				oscs_r[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningRight,
-						m_osc[i]->m_phaseOffsetRight,
-						m_osc[i]->m_volumeRight,
-						oscs_r[i + 1] );
-				oscs_r[i]->setUseWaveTable(m_osc[i]->m_useWaveTable);
-			}
-
-			oscs_l[i]->setUserWave( m_osc[i]->m_sampleBuffer );
-			oscs_r[i]->setUserWave( m_osc[i]->m_sampleBuffer );
-			oscs_l[i]->setUserAntiAliasWaveTable(m_osc[i]->m_userAntiAliasWaveTable);
-			oscs_r[i]->setUserAntiAliasWaveTable(m_osc[i]->m_userAntiAliasWaveTable);
 		}
 
-		_n->m_pluginData = new oscPtr;
-		static_cast<oscPtr *>( _n->m_pluginData )->oscLeft = oscs_l[0];
-		static_cast< oscPtr *>( _n->m_pluginData )->oscRight =
-								oscs_r[0];
+		_n->m_pluginData = newOscs;
 	}
 
-	Oscillator * osc_l = static_cast<oscPtr *>( _n->m_pluginData )->oscLeft;
-	Oscillator * osc_r = static_cast<oscPtr *>( _n->m_pluginData )->oscRight;
+	auto oscs = static_cast<NoteOscillators*>(_n->m_pluginData);
 
 	const f_cnt_t frames = _n->framesLeftForCurrentPeriod();
 	const f_cnt_t offset = _n->noteOffset();
 
-	osc_l->update( _working_buffer + offset, frames, 0 );
-	osc_r->update( _working_buffer + offset, frames, 1 );
+	oscs->left[0]->update( _working_buffer + offset, frames, 0 );
+	oscs->right[0]->update( _working_buffer + offset, frames, 1 );
 
 	applyFadeIn(_working_buffer, _n);
 	applyRelease( _working_buffer, _n );
@@ -386,11 +376,7 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 
 void TripleOscillator::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscLeft );
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscRight );
-	delete static_cast<oscPtr *>( _n->m_pluginData );
+	delete static_cast<NoteOscillators*>( _n->m_pluginData );
 }
 
 
@@ -135,12 +135,6 @@ protected slots:
 private:
 	OscillatorObject * m_osc[NUM_OF_OSCILLATORS];
 
-	struct oscPtr
-	{
-		Oscillator * oscLeft;
-		Oscillator * oscRight;
-	} ;
-
 
 	friend class gui::TripleOscillatorView;
 
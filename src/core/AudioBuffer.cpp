@@ -81,6 +81,7 @@ AudioBuffer::AudioBuffer(f_cnt_t frames, ch_cnt_t channels,
 void AudioBuffer::allocateInterleavedBuffer()
 {
 	m_interleavedBuffer.resize(2 * m_frames);
+	m_interleavedInSync = false;
 }
 
 auto AudioBuffer::allocationSize(f_cnt_t frames, ch_cnt_t channels, bool withInterleavedBuffer) -> std::size_t
@@ -144,6 +145,7 @@ auto AudioBuffer::addGroup(ch_cnt_t channels) -> ChannelGroup*
 	{
 		m_interleavedBuffer.resize(2 * m_frames);
 	}
+	m_interleavedInSync = false;
 
 	// Fix channel buffers
 	float* ptr = m_sourceBuffer.data();
@@ -221,10 +223,9 @@ auto AudioBuffer::sanitize(const ChannelFlags& channels, ch_cnt_t upperBound) ->
 		}
 	}
 
-	if (changesMade && hasInterleavedBuffer() && (channels[0] || channels[1]))
+	if (changesMade && (channels[0] || channels[1]))
 	{
-		// Keep the temporary interleaved buffer in sync
-		toInterleaved(groupBuffers(0), interleavedBuffer());
+		m_interleavedInSync = false;
 	}
 
 	return changesMade;
@@ -244,10 +245,9 @@ auto AudioBuffer::sanitizeAll() -> bool
 		}
 	}
 
-	if (changesMade && hasInterleavedBuffer())
+	if (changesMade)
 	{
-		// Keep the temporary interleaved buffer in sync
-		toInterleaved(groupBuffers(0), interleavedBuffer());
+		m_interleavedInSync = false;
 	}
 
 	return changesMade;
@@ -331,10 +331,9 @@ void AudioBuffer::silenceChannels(const ChannelFlags& channels, ch_cnt_t upperBo
 		}
 	}
 
-	if (hasInterleavedBuffer() && (needSilenced[0] || needSilenced[1]))
+	if (needSilenced[0] || needSilenced[1])
 	{
-		// Keep the temporary interleaved buffer in sync
-		toInterleaved(groupBuffers(0), interleavedBuffer());
+		m_interleavedInSync = false;
 	}
 
 	m_silenceFlags |= channels;
@@ -343,8 +342,8 @@ void AudioBuffer::silenceChannels(const ChannelFlags& channels, ch_cnt_t upperBo
 void AudioBuffer::silenceAllChannels()
 {
 	std::ranges::fill(m_sourceBuffer, 0);
-	std::ranges::fill(m_interleavedBuffer, 0);
 
+	m_interleavedInSync = false;
 	m_silenceFlags.set();
 }
 
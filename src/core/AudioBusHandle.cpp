@@ -29,10 +29,12 @@
 
 #include "AudioDevice.h"
 #include "AudioEngine.h"
+#include "AudioEngineWorkerThread.h"
 #include "EffectChain.h"
 #include "Mixer.h"
 #include "Engine.h"
 #include "MixHelpers.h"
+#include "Tracer.h"
 
 namespace lmms
 {
@@ -44,13 +46,17 @@ AudioBusHandle::AudioBusHandle(const QString& name, bool hasEffectChain,
 	m_buffer(Engine::audioEngine()->framesPerPeriod()),
 	m_extOutputEnabled(false),
 	m_nextMixerChannel(0),
+	m_graphMixerChannel(0),
+	m_graphInputs(0),
 	m_name(name),
 	m_effects(hasEffectChain ? new EffectChain(nullptr) : nullptr),
 	m_volumeModel(volumeModel),
 	m_panningModel(panningModel),
 	m_mutedModel(mutedModel)
 {
-	m_buffer.allocateInterleavedBuffer();
+	// Only needed for effects which can't process planar buffers
+	if (m_effects) { m_buffer.allocateInterleavedBuffer(); }
+	m_profilerNode.setName(name);
 
 	Engine::audioEngine()->addAudioBusHandle(this);
 	setExtOutputEnabled(true);
@@ -90,6 +96,7 @@ void AudioBusHandle::setExtOutputEnabled(bool enabled)
 void AudioBusHandle::setName(const QString& newName)
 {
 	m_name = newName;
+	m_profilerNode.setName(newName);
 	Engine::audioEngine()->audioDev()->renamePort(this);
 }
 
@@ -107,13 +114,55 @@ bool AudioBusHandle::processEffects()
 }
 
 
+void AudioBusHandle::prepareGraph()
+{
+	m_graphInputs = 0;
+	// the channel might be changed while we're processing, so stick to one for this period
+	m_graphMixerChannel = m_nextMixerChannel;
+	Engine::mixer()->mixerChannel(m_graphMixerChannel)->addBusDependency();
+}
+
+
+
+
+void AudioBusHandle::graphInputProcessed()
+{
+	if (--m_graphInputs == 0)
+	{
+		AudioEngineWorkerThread::addJob(this);
+	}
+}
+
+
+
+
 void AudioBusHandle::doProcessing()
 {
-	if (m_mutedModel && m_mutedModel->value())
+	const bool hasOutput = (!m_mutedModel || !m_mutedModel->value()) && processAudio();
+
+	if (m_outputTap)
 	{
-		return;
+		const f_cnt_t fpp = Engine::audioEngine()->framesPerPeriod();
+		if (hasOutput) { toInterleaved(m_buffer.groupBuffers(0), InterleavedBufferView{m_outputTap, fpp}); }
+		else { zeroSampleFrames(m_outputTap, fpp); }
 	}
 
+	Engine::audioEngine()->profiler().markGraphDetail(AudioEngineProfiler::DetailType::Effects);
+
+	// the mixer channel can be processed once all of its inputs are done.
+	// If we were the last one, continue with it on this thread.
+	MixerChannel* channel = Engine::mixer()->mixerChannel(m_graphMixerChannel);
+	if (channel->incrementDeps()) { channel->processAsContinuation(); }
+}
+
+
+
+
+bool AudioBusHandle::processAudio()
+{
+	AudioEngineProfiler::NodeProbe profilerProbe(m_profilerNode);
+	Tracer::Scope traceScope("Audio bus handle");
+
 	const f_cnt_t fpp = Engine::audioEngine()->framesPerPeriod();
 
 	// clear the buffer
@@ -130,8 +179,9 @@ void AudioBusHandle::doProcessing()
 			{
 				m_bufferUsage = true;
 
-				// Writing to temporary interleaved buffer until PlayHandle and MixHelpers switch to planar
-				MixHelpers::add(m_buffer.interleavedBuffer().asSampleFrames().data(), ph->buffer(), fpp);
+				// PlayHandles still render interleaved, deinterleave while mixing
+				const auto phBuffer = InterleavedBufferView<const sample_t, 2>{ph->buffer(), fpp};
+				MixHelpers::add(m_buffer.groupBuffers(0), phBuffer);
 			}
 			ph->releaseBuffer(); 	// gets rid of playhandle's buffer and sets
 									// pointer to null, so if it doesn't get re-acquired we know to skip it next time
@@ -140,8 +190,8 @@ void AudioBusHandle::doProcessing()
 
 	if (m_bufferUsage)
 	{
-		// PlayHandle buffers were written to the temporary interleaved buffer
-		auto buffer = m_buffer.interleavedBuffer();
+		float* left = m_buffer.buffer(0).data();
+		float* right = m_buffer.buffer(1).data();
 
 		// handle volume and panning
 		// has both vol and pan models
@@ -157,8 +207,8 @@ void AudioBusHandle::doProcessing()
 				{
 					float v = volBuf->values()[f] * 0.01f;
 					float p = panBuf->values()[f] * 0.01f;
-					buffer[f][0] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
-					buffer[f][1] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
+					left[f] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
+					right[f] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
 				}
 			}
 
@@ -171,8 +221,8 @@ void AudioBusHandle::doProcessing()
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
 					float v = volBuf->values()[f] * 0.01f;
-					buffer[f][0] *= v * l;
-					buffer[f][1] *= v * r;
+					left[f] *= v * l;
+					right[f] *= v * r;
 				}
 			}
 
@@ -183,8 +233,8 @@ void AudioBusHandle::doProcessing()
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
 					float p = panBuf->values()[f] * 0.01f;
-					buffer[f][0] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
-					buffer[f][1] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
+					left[f] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
+					right[f] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
 				}
 			}
 
@@ -195,8 +245,8 @@ void AudioBusHandle::doProcessing()
 				float v = m_volumeModel->value() * 0.01f;
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
-					buffer[f][0] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
-					buffer[f][1] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
+					left[f] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
+					right[f] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
 				}
 			}
 		}
@@ -211,25 +261,16 @@ void AudioBusHandle::doProcessing()
 				for (f_cnt_t f = 0; f < fpp; ++f)
 				{
 					float v = volBuf->values()[f] * 0.01f;
-					buffer[f][0] *= v;
-					buffer[f][1] *= v;
+					left[f] *= v;
+					right[f] *= v;
 				}
 			}
 			else
 			{
-				float v = m_volumeModel->value() * 0.01f;
-				for (f_cnt_t f = 0; f < fpp; ++f)
-				{
-					buffer[f][0] *= v;
-					buffer[f][1] *= v;
-				}
+				MixHelpers::multiply(m_buffer.groupBuffers(0), m_volumeModel->value() * 0.01f);
 			}
 		}
 
-		// Copy from temporary interleaved buffer to the main planar buffer
-		// so they stay in sync
-		toPlanar(buffer, m_buffer.groupBuffers(0));
-
 		const auto sanitized = Engine::audioEngine()->sanitizationEnabled() ? m_buffer.sanitizeAll() : false;
 		m_corrupted.store(sanitized, std::memory_order_relaxed);
 
@@ -244,9 +285,11 @@ void AudioBusHandle::doProcessing()
 	if (anyOutputAfterEffects || m_bufferUsage)
 	{
 		// TODO: improve the flow here - convert to pull model
-		Engine::mixer()->mixToChannel(m_buffer, m_nextMixerChannel); // send output to mixer
+		Engine::mixer()->mixToChannel(m_buffer, m_graphMixerChannel); // send output to mixer
 		m_bufferUsage = false;
+		return true;
 	}
+	return false;
 }
 
 
@@ -59,6 +59,7 @@
 #include "MidiDummy.h"
 
 #include "BufferManager.h"
+#include "Tracer.h"
 
 namespace lmms
 {
@@ -104,14 +105,15 @@ AudioEngine::AudioEngine(bool renderOnly)
 	m_outputBufferWrite = std::make_unique<SampleFrame[]>(m_framesPerPeriod);
 
 
+	// create all workers before starting any of them, so the job queue
+	// doesn't get any new worker queues while workers are already running
 	for( int i = 0; i < m_numWorkers+1; ++i )
 	{
-		auto wt = new AudioEngineWorkerThread(this);
-		if( i < m_numWorkers )
-		{
-			wt->start( QThread::TimeCriticalPriority );
-		}
-		m_workers.push_back( wt );
+		m_workers.push_back(new AudioEngineWorkerThread(this));
+	}
+	for( int i = 0; i < m_numWorkers; ++i )
+	{
+		m_workers[i]->start( QThread::TimeCriticalPriority );
 	}
 }
 
@@ -201,6 +203,7 @@ void AudioEngine::pushInputFrames( SampleFrame* _ab, const f_cnt_t _frames )
 void AudioEngine::renderStageNoteSetup()
 {
 	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::NoteSetup);
+	Tracer::Scope traceScope("Note setup");
 
 	if( m_clearSignal )
 	{
@@ -251,25 +254,59 @@ void AudioEngine::renderStageNoteSetup()
 
 
 
-void AudioEngine::renderStageInstruments()
+void AudioEngine::renderStageAudioGraph()
 {
-	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Instruments);
+	// Play handles, the effect chains of their audio bus handles and the mixer
+	// channels are processed as one dependency graph: every node gets queued as
+	// soon as all of its inputs are done, so a slow instrument only delays the
+	// nodes that actually depend on it.
+	Tracer::Scope traceScope("Audio graph");
+	m_profiler.startGraph();
+
+	Mixer* mixer = Engine::mixer();
+	AudioEngineWorkerThread::resetJobQueue(AudioEngineWorkerThread::JobQueue::OperationMode::Dynamic);
+
+	// count the inputs of every node before anything gets queued, so that no
+	// node can become ready while the graph is still being set up
+	mixer->prepareGraph();
+	for (AudioBusHandle* busHandle : m_audioBusHandles)
+	{
+		busHandle->prepareGraph();
+	}
+	for (PlayHandle* playHandle : m_playHandles)
+	{
+		// InstrumentPlayHandle waits for all note play handles of its track which
+		// aren't done yet, so none of them may look done from the previous period
+		playHandle->reset();
+		if (playHandle->audioBusHandle()) { playHandle->audioBusHandle()->addGraphInput(); }
+	}
+
+	// queue the nodes without inputs - all others get queued by their last input
+	mixer->startGraph();
+	for (AudioBusHandle* busHandle : m_audioBusHandles)
+	{
+		if (!busHandle->hasGraphInputs()) { AudioEngineWorkerThread::addJob(busHandle); }
+	}
+	for (PlayHandle* playHandle : m_playHandles)
+	{
+		if (!AudioEngineWorkerThread::addJob(playHandle) && playHandle->audioBusHandle())
+		{
+			// finished play handles won't be processed, but still count as input
+			playHandle->audioBusHandle()->graphInputProcessed();
+		}
+	}
 
-	AudioEngineWorkerThread::fillJobQueue(m_playHandles);
 	AudioEngineWorkerThread::startAndWaitForJobs();
-}
 
+	m_profiler.finishGraph();
 
+	removeFinishedPlayHandles();
+}
 
-void AudioEngine::renderStageEffects()
-{
-	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Effects);
 
-	// STAGE 2: process effects of all instrument- and sampletracks
-	AudioEngineWorkerThread::fillJobQueue(m_audioBusHandles);
-	AudioEngineWorkerThread::startAndWaitForJobs();
 
-	// removed all play handles which are done
+void AudioEngine::removeFinishedPlayHandles()
+{
 	for( PlayHandleList::Iterator it = m_playHandles.begin();
 						it != m_playHandles.end(); )
 	{
@@ -301,6 +338,7 @@ void AudioEngine::renderStageEffects()
 void AudioEngine::renderStageMix()
 {
 	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Mixing);
+	Tracer::Scope traceScope("Master mix");
 
 	Mixer *mixer = Engine::mixer();
 	mixer->masterMix(m_outputBufferWrite.get());
@@ -320,14 +358,14 @@ void AudioEngine::renderStageMix()
 std::span<const SampleFrame> AudioEngine::renderNextPeriod()
 {
 	const auto lock = std::lock_guard{m_changeMutex};
+	Tracer::Scope traceScope("Period");
 
 	m_profiler.startPeriod();
 	s_renderingThread = true;
 
 	renderStageNoteSetup();     // STAGE 0: clear old play handles and buffers, setup new play handles
-	renderStageInstruments();   // STAGE 1: run and render all play handles
-	renderStageEffects();       // STAGE 2: process effects of all instrument- and sampletracks
-	renderStageMix();           // STAGE 3: do master mix in mixer
+	renderStageAudioGraph();    // STAGE 1: render play handles, process effects and mix channels as they get ready
+	renderStageMix();           // STAGE 2: write master output
 
 	s_renderingThread = false;
 	m_profiler.finishPeriod(outputSampleRate(), m_framesPerPeriod);
@@ -461,10 +499,15 @@ void AudioEngine::removeAudioBusHandle(AudioBusHandle* busHandle)
 
 bool AudioEngine::addPlayHandle( PlayHandle* handle )
 {
+	// The pools of note play handles and play handle buffers don't fall back to
+	// the heap when exhausted, so the new play handle is dropped then
+	if (!handle) { return false; }
+	const bool hasBuffer = !handle->usesBuffer() || handle->hasBuffer();
+
 	// Only add play handles if we have the CPU capacity to process them.
 	// Instrument play handles are not added during playback, but when the
 	// associated instrument is created, so add those unconditionally.
-	if (handle->type() == PlayHandle::Type::InstrumentPlayHandle || !criticalXRuns())
+	if (hasBuffer && (handle->type() == PlayHandle::Type::InstrumentPlayHandle || !criticalXRuns()))
 	{
 		m_newPlayHandles.push( handle );
 		handle->audioBusHandle()->addPlayHandle(handle);
@@ -24,11 +24,18 @@
 
 #include "AudioEngineProfiler.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <numeric>
 
 namespace lmms
 {
 
+std::vector<AudioEngineProfiler::Node*> AudioEngineProfiler::s_nodes;
+std::mutex AudioEngineProfiler::s_nodesMutex;
+std::atomic<std::uint32_t> AudioEngineProfiler::s_period = 0;
+
+
 AudioEngineProfiler::AudioEngineProfiler() :
 	m_periodTimer(),
 	m_cpuLoad( 0 ),
@@ -44,6 +51,7 @@ void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, f_cnt_t frames
 	const unsigned int periodElapsed = m_periodTimer.elapsed();
 	// Maximum time the processing can take before causing buffer underflow. Convert to us.
 	const uint64_t timeLimit = static_cast<uint64_t>(1000000) * framesPerPeriod / sampleRate;
+	m_timeLimit.store(static_cast<int>(timeLimit), std::memory_order_relaxed);
 
 	// Compute new overall CPU load and apply exponential averaging.
 	// The result is used for overload detection in AudioEngine::criticalXRuns()
@@ -63,6 +71,124 @@ void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, f_cnt_t frames
 	{
 		m_outputFile.write( QString( "%1\n" ).arg( periodElapsed ).toLatin1() );
 	}
+
+	finishNodes(periodElapsed > timeLimit);
+}
+
+
+
+void AudioEngineProfiler::finishNodes(bool overrun)
+{
+	// No jobs are running between periods. Anything recorded from now on belongs to the next
+	// period, so if the nodes can't be collected below, this period's times are simply dropped.
+	const auto period = std::uint64_t{s_period.fetch_add(1, std::memory_order_relaxed)} << Node::PeriodShift;
+
+	const auto lock = std::unique_lock{s_nodesMutex, std::try_to_lock};
+	if (!lock.owns_lock()) { return; }
+
+	m_nodeHistoryIndex = (m_nodeHistoryIndex + 1) % NodeHistorySize;
+	for (const auto node : s_nodes)
+	{
+		const auto value = node->m_periodTime.load(std::memory_order_relaxed);
+		const auto time = (value & ~Node::TimeMask) == period ? static_cast<int>(value & Node::TimeMask) : 0;
+		node->m_history[m_nodeHistoryIndex].store(time, std::memory_order_relaxed);
+
+		// list the nodes that were busy in an overrun period below it
+		if (overrun && time > 0 && m_outputFile.isOpen())
+		{
+			static constexpr auto typeNames = std::array{"track", "effect", "channel"};
+			m_outputFile.write(QString("\t%1\t%2\t%3\n")
+				.arg(typeNames[static_cast<std::size_t>(node->m_type)]).arg(node->m_name).arg(time).toUtf8());
+		}
+	}
+}
+
+
+
+auto AudioEngineProfiler::nodeLoads() const -> std::vector<NodeLoad>
+{
+	struct NodeHistory
+	{
+		NodeType type;
+		QString name;
+		std::array<int, NodeHistorySize> history;
+	};
+
+	// Only copy the histories while holding the lock, so the audio thread rarely fails to get it
+	auto histories = std::vector<NodeHistory>{};
+	{
+		const auto lock = std::lock_guard{s_nodesMutex};
+		histories.resize(s_nodes.size());
+		for (std::size_t i = 0; i < s_nodes.size(); ++i)
+		{
+			histories[i].type = s_nodes[i]->m_type;
+			histories[i].name = s_nodes[i]->m_name;
+			for (std::size_t j = 0; j < NodeHistorySize; ++j)
+			{
+				histories[i].history[j] = s_nodes[i]->m_history[j].load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	const auto timeLimit = static_cast<float>(m_timeLimit.load(std::memory_order_relaxed));
+	auto loads = std::vector<NodeLoad>{};
+	loads.reserve(histories.size());
+	for (auto& [type, name, history] : histories)
+	{
+		const auto percentile = history.begin() + NodeHistorySize * 95 / 100;
+		std::nth_element(history.begin(), percentile, history.end());
+
+		const auto sum = std::accumulate(history.begin(), history.end(), 0.f);
+		loads.push_back(NodeLoad{
+			type,
+			name,
+			100.f * sum / NodeHistorySize / timeLimit,
+			100.f * *percentile / timeLimit,
+			100.f * *std::max_element(percentile, history.end()) / timeLimit
+		});
+	}
+
+	std::sort(loads.begin(), loads.end(), [](const auto& a, const auto& b) { return a.max > b.max; });
+	return loads;
+}
+
+
+
+void AudioEngineProfiler::finishGraph()
+{
+	auto previousEnd = 0;
+	for (const auto type : {DetailType::Instruments, DetailType::Effects, DetailType::Mixing})
+	{
+		const auto index = static_cast<std::size_t>(type);
+		const auto end = std::max(previousEnd, m_graphDetailEnd[index].load(std::memory_order_relaxed));
+		m_detailTime[index] = end - previousEnd;
+		previousEnd = end;
+	}
+}
+
+
+
+AudioEngineProfiler::Node::Node(NodeType type) :
+	m_type(type)
+{
+	const auto lock = std::lock_guard{s_nodesMutex};
+	s_nodes.push_back(this);
+}
+
+
+
+AudioEngineProfiler::Node::~Node()
+{
+	const auto lock = std::lock_guard{s_nodesMutex};
+	s_nodes.erase(std::find(s_nodes.begin(), s_nodes.end(), this));
+}
+
+
+
+void AudioEngineProfiler::Node::setName(const QString& name)
+{
+	const auto lock = std::lock_guard{s_nodesMutex};
+	m_name = name;
 }
 
 
@@ -25,25 +25,93 @@
 #include "AudioEngineWorkerThread.h"
 
 #include <QDebug>
-#include <QMutex>
-#include <QWaitCondition>
 
 #include "AudioEngine.h"
-#include "Hardware.h"
 #include "ThreadableJob.h"
+#include "Tracer.h"
 
 
 namespace lmms
 {
 
 AudioEngineWorkerThread::JobQueue AudioEngineWorkerThread::globalJobQueue;
-QWaitCondition * AudioEngineWorkerThread::queueReadyWaitCond = nullptr;
 QList<AudioEngineWorkerThread *> AudioEngineWorkerThread::workerThreads;
 
+//! Number of busy-wait iterations an idle worker spends looking for a new batch
+//! of jobs before parking. Several batches are started per period, so most of
+//! them are picked up without having to go through the condition variable.
+static constexpr int WORKER_SPIN_COUNT = 4096;
+
+//! Index of the worker queue owned by the current thread, if any
+static constexpr auto NO_WORKER = static_cast<std::size_t>(-1);
+static thread_local std::size_t s_workerIndex = NO_WORKER;
+
+static std::atomic_size_t s_batch = 0;
+static std::atomic_int s_parkedWorkers = 0;
+static std::mutex s_parkMutex;
+static std::condition_variable s_parkCond;
+
+
+
+
+// implementation of the per-worker queues
+bool AudioEngineWorkerThread::JobQueue::WorkerQueue::push(ThreadableJob* job)
+{
+	auto tail = m_tail.load();
+	do
+	{
+		if ((tail & INDEX_MASK) >= JOB_QUEUE_SIZE) { return false; }
+	}
+	while (!m_tail.compare_exchange_weak(tail, tail + 1));
+
+	m_items[tail & INDEX_MASK].store(job, std::memory_order_release);
+	return true;
+}
+
+
+
+
+ThreadableJob* AudioEngineWorkerThread::JobQueue::WorkerQueue::pop()
+{
+	auto head = m_head.load();
+	do
+	{
+		// a tail of another generation means that the queue has been reset since head was read
+		const auto tail = m_tail.load();
+		if ((tail >> GENERATION_SHIFT) != (head >> GENERATION_SHIFT) || head >= tail) { return nullptr; }
+	}
+	while (!m_head.compare_exchange_weak(head, head + 1));
+
+	// the slot has been claimed, but the producer may not have stored the job yet
+	ThreadableJob* job;
+	while ((job = m_items[head & INDEX_MASK].exchange(nullptr, std::memory_order_acquire)) == nullptr) { busyWaitHint(); }
+	return job;
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::WorkerQueue::reset()
+{
+	// Both indices start over in a new generation, so compare-exchanges on values read before the
+	// reset fail. The tail has to be reset first so that a worker still looking at the old head
+	// never sees a non-empty range of stale slots.
+	const auto generation = (m_head.load() >> GENERATION_SHIFT) + 1;
+	m_tail = generation << GENERATION_SHIFT;
+	m_head = generation << GENERATION_SHIFT;
+}
+
+
+
+
 // implementation of internal JobQueue
 void AudioEngineWorkerThread::JobQueue::reset( OperationMode _opMode )
 {
-	m_writeIndex = 0;
+	for (auto& queue : m_queues)
+	{
+		queue->reset();
+	}
+	m_itemsQueued = 0;
 	m_itemsDone = 0;
 	m_opMode = _opMode;
 }
@@ -51,43 +119,55 @@ void AudioEngineWorkerThread::JobQueue::reset( OperationMode _opMode )
 
 
 
-void AudioEngineWorkerThread::JobQueue::addJob( ThreadableJob * _job )
+bool AudioEngineWorkerThread::JobQueue::addJob( ThreadableJob * _job )
 {
 	if( _job->requiresProcessing() )
 	{
 		// update job state
 		_job->queue();
-		// actually queue the job via atomic operations
-		auto index = m_writeIndex++;
-		if (index < JOB_QUEUE_SIZE) {
-			m_items[index] = _job;
-		} else {
-			qWarning() << "Job queue is full!";
-			++m_itemsDone;
+		// count the job before it becomes visible so that wait() can't return early
+		++m_itemsQueued;
+
+		// jobs added by a worker (e.g. mixer channels becoming ready) stay
+		// local to it, all other jobs are spread over all workers
+		const auto count = m_queues.size();
+		const auto first = s_workerIndex != NO_WORKER ? s_workerIndex : m_nextQueue++ % std::max<std::size_t>(count, 1);
+		for (auto i = std::size_t{0}; i < count; ++i)
+		{
+			if (m_queues[(first + i) % count]->push(_job)) { return true; }
 		}
+
+		qWarning() << "Job queue is full!";
+		_job->done();
+		jobDone();
 	}
+	return false;
 }
 
 
 
-void AudioEngineWorkerThread::JobQueue::run()
+void AudioEngineWorkerThread::JobQueue::run( std::size_t worker )
 {
-	bool processedJob = true;
-	while (processedJob && m_itemsDone < m_writeIndex)
+	const auto count = m_queues.size();
+	while (m_itemsDone < m_itemsQueued)
 	{
-		processedJob = false;
-		for (auto i = std::size_t{0}; i < m_writeIndex && i < JOB_QUEUE_SIZE; ++i)
+		ThreadableJob* job = m_queues[worker]->pop();
+		for (auto i = std::size_t{1}; job == nullptr && i < count; ++i)
+		{
+			job = m_queues[(worker + i) % count]->pop();
+		}
+
+		if (job)
 		{
-			ThreadableJob * job = m_items[i].exchange(nullptr);
-			if( job )
-			{
-				job->process();
-				processedJob = true;
-				++m_itemsDone;
-			}
+			job->process();
+			jobDone();
+			continue;
 		}
-		// always exit loop if we're not in dynamic mode
-		processedJob = processedJob && ( m_opMode == OperationMode::Dynamic );
+
+		// nothing left to claim - the remaining jobs are being processed by
+		// other workers. Only in dynamic mode can they still add new jobs.
+		if (m_opMode == OperationMode::Static) { break; }
+		busyWaitHint();
 	}
 }
 
@@ -96,7 +176,39 @@ void AudioEngineWorkerThread::JobQueue::run()
 
 void AudioEngineWorkerThread::JobQueue::wait()
 {
-	while (m_itemsDone < m_writeIndex) { busyWaitHint(); }
+	for (int i = 0; i < WORKER_SPIN_COUNT; ++i)
+	{
+		if (m_itemsDone >= m_itemsQueued) { return; }
+		busyWaitHint();
+	}
+
+	auto lock = std::unique_lock{m_doneMutex};
+	m_waiting = true;
+	m_doneCond.wait(lock, [this] { return m_itemsDone >= m_itemsQueued; });
+	m_waiting = false;
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::jobDone()
+{
+	// jobs can only be added by the thread that starts the queue or by jobs
+	// that are still in progress, so once all are done, no more will follow
+	if (++m_itemsDone == m_itemsQueued && m_waiting)
+	{
+		{ const auto lock = std::lock_guard{m_doneMutex}; }
+		m_doneCond.notify_one();
+	}
+}
+
+
+
+
+std::size_t AudioEngineWorkerThread::JobQueue::addWorkerQueue()
+{
+	m_queues.push_back(std::make_unique<WorkerQueue>());
+	return m_queues.size() - 1;
 }
 
 
@@ -107,14 +219,9 @@ void AudioEngineWorkerThread::JobQueue::wait()
 
 AudioEngineWorkerThread::AudioEngineWorkerThread( AudioEngine* audioEngine ) :
 	QThread( audioEngine ),
+	m_index( globalJobQueue.addWorkerQueue() ),
 	m_quit( false )
 {
-	// initialize global static data
-	if( queueReadyWaitCond == nullptr )
-	{
-		queueReadyWaitCond = new QWaitCondition;
-	}
-
 	// keep track of all instantiated worker threads - this is used for
 	// processing the last worker thread "inline", see comments in
 	// AudioEngineWorkerThread::startAndWaitForJobs() for details
@@ -145,28 +252,62 @@ void AudioEngineWorkerThread::quit()
 
 void AudioEngineWorkerThread::startAndWaitForJobs()
 {
-	queueReadyWaitCond->wakeAll();
+	++s_batch;
+	if (s_parkedWorkers > 0)
+	{
+		// taking the lock makes sure a worker that is about to park either
+		// sees the new batch or is already waiting and receives the notification
+		{ const auto lock = std::lock_guard{s_parkMutex}; }
+		s_parkCond.notify_all();
+	}
+
 	// The last worker-thread is never started. Instead it's processed "inline"
 	// i.e. within the global AudioEngine thread. This way we can reduce latencies
 	// that otherwise would be caused by synchronizing with another thread.
-	globalJobQueue.run();
+	const auto previousIndex = s_workerIndex;
+	s_workerIndex = workerThreads.back()->m_index;
+	globalJobQueue.run(s_workerIndex);
+	s_workerIndex = previousIndex;
+
 	globalJobQueue.wait();
 }
 
 
 
 
+void AudioEngineWorkerThread::waitForJobs( std::size_t& lastBatch )
+{
+	for (int i = 0; i < WORKER_SPIN_COUNT; ++i)
+	{
+		if (s_batch != lastBatch)
+		{
+			lastBatch = s_batch;
+			return;
+		}
+		busyWaitHint();
+	}
+
+	auto lock = std::unique_lock{s_parkMutex};
+	++s_parkedWorkers;
+	s_parkCond.wait(lock, [&lastBatch] { return s_batch != lastBatch; });
+	--s_parkedWorkers;
+	lastBatch = s_batch;
+}
+
+
+
+
 void AudioEngineWorkerThread::run()
 {
 	disableDenormals();
+	Tracer::setThreadName("Worker", static_cast<int>(m_index));
 
-	QMutex m;
+	s_workerIndex = m_index;
+	auto lastBatch = s_batch.load();
 	while( m_quit == false )
 	{
-		m.lock();
-		queueReadyWaitCond->wait( &m );
-		globalJobQueue.run();
-		m.unlock();
+		waitForJobs(lastBatch);
+		globalJobQueue.run(m_index);
 	}
 }
 
@@ -26,6 +26,9 @@
 
 #include "AutomationClip.h"
 
+#include <cassert>
+
+#include "AutomationCurve.h"
 #include "AutomationNode.h"
 #include "AutomationClipView.h"
 #include "AutomationTrack.h"
@@ -55,6 +58,7 @@ AutomationClip::AutomationClip( AutomationTrack * _auto_track ) :
 	m_isRecording( false ),
 	m_lastRecordedValue( 0 )
 {
+	updateCurve();
 	changeLength( TimePos( 1, 0 ) );
 }
 
@@ -83,8 +87,20 @@ AutomationClip::AutomationClip( const AutomationClip & _clip_to_copy ) :
 		// Sets the node's clip to this one
 		m_timeMap[POS(it)].setClip(this);
 	}
+	updateCurve();
+}
+
+
+
+
+AutomationClip::~AutomationClip()
+{
+	AutomationCurve::retire(m_curve.load(std::memory_order_relaxed));
 }
 
+
+
+
 bool AutomationClip::addObject( AutomatableModel * _obj, bool _search_dup )
 {
 	QMutexLocker m(&m_clipMutex);
@@ -125,6 +141,7 @@ void AutomationClip::setProgressionType(
 		_new_progression_type == ProgressionType::CubicHermite )
 	{
 		m_progressionType = _new_progression_type;
+		updateCurve();
 		emit dataChanged();
 	}
 }
@@ -142,6 +159,7 @@ void AutomationClip::setTension( QString _new_tension )
 	if( ok && nt > -0.01 && nt < 1.01 )
 	{
 		m_tension = nt;
+		updateCurve();
 	}
 }
 
@@ -236,6 +254,8 @@ TimePos AutomationClip::putValue(
 	TimePos newTime = quantPos ? Note::quantized(time, quantization()) : time;
 	newTime = std::max(TimePos(0), newTime);
 
+	beginCurveUpdateBatch();
+
 	// Create a node or replace the existing one on newTime
 	m_timeMap[newTime] = AutomationNode(this, value, newTime);
 
@@ -256,6 +276,7 @@ TimePos AutomationClip::putValue(
 	}
 	if (it != m_timeMap.begin()) { --it; }
 	generateTangents(it, 3);
+	endCurveUpdateBatch();
 
 	updateLength();
 
@@ -292,6 +313,8 @@ TimePos AutomationClip::putValues(
 	TimePos newTime = quantPos ? Note::quantized(time, quantization()) : time;
 	newTime = std::max(TimePos(0), newTime);
 
+	beginCurveUpdateBatch();
+
 	// Create a node or replace the existing one on newTime
 	m_timeMap[newTime] = AutomationNode(this, inValue, outValue, newTime);
 
@@ -312,6 +335,7 @@ TimePos AutomationClip::putValues(
 	}
 	if (it != m_timeMap.begin()) { --it; }
 	generateTangents(it, 3);
+	endCurveUpdateBatch();
 
 	updateLength();
 
@@ -358,6 +382,8 @@ void AutomationClip::removeNodes(const int tick0, const int tick1)
 		return;
 	}
 
+	QMutexLocker m(&m_clipMutex);
+
 	auto start = TimePos(std::min(tick0, tick1));
 	auto end = TimePos(std::max(tick0, tick1));
 
@@ -371,10 +397,12 @@ void AutomationClip::removeNodes(const int tick0, const int tick1)
 		nodesToRemove.push_back(POS(it));
 	}
 
+	beginCurveUpdateBatch();
 	for (auto node: nodesToRemove)
 	{
 		removeNode(node);
 	}
+	endCurveUpdateBatch();
 }
 
 
@@ -394,13 +422,17 @@ void AutomationClip::resetNodes(const int tick0, const int tick1)
 		return;
 	}
 
+	QMutexLocker m(&m_clipMutex);
+
 	auto start = TimePos(std::min(tick0, tick1));
 	auto end = TimePos(std::max(tick0, tick1));
 
+	beginCurveUpdateBatch();
 	for (auto it = m_timeMap.lowerBound(start), endIt = m_timeMap.upperBound(end); it != endIt; ++it)
 	{
 		it.value().resetOutValue();
 	}
+	endCurveUpdateBatch();
 }
 
 
@@ -419,14 +451,18 @@ void AutomationClip::resetTangents(const int tick0, const int tick1)
 		return;
 	}
 
+	QMutexLocker m(&m_clipMutex);
+
 	TimePos start = TimePos(std::min(tick0, tick1));
 	TimePos end = TimePos(std::max(tick0, tick1));
 
+	beginCurveUpdateBatch();
 	for (auto it = m_timeMap.lowerBound(start), endIt = m_timeMap.upperBound(end); it != endIt; ++it)
 	{
 		it.value().setLockedTangents(false);
 		generateTangents(it, 1);
 	}
+	endCurveUpdateBatch();
 }
 
 
@@ -509,6 +545,8 @@ TimePos AutomationClip::setDragValue(
 		m_dragging = true;
 	}
 
+	beginCurveUpdateBatch();
+
 	//Restore to the state before it the point were being dragged
 	m_timeMap = m_oldTimeMap;
 
@@ -535,9 +573,12 @@ TimePos AutomationClip::setDragValue(
 			it.value().setInTangent(m_dragInTan);
 			it.value().setOutTangent(m_dragOutTan);
 			it.value().setLockedTangents(true);
+			updateCurve();
 		}
 	}
 
+	endCurveUpdateBatch();
+
 	return returnedPos;
 }
 
@@ -559,39 +600,9 @@ void AutomationClip::applyDragValue()
 
 float AutomationClip::valueAt( const TimePos & _time ) const
 {
-	QMutexLocker m(&m_clipMutex);
-
-	if( m_timeMap.isEmpty() )
-	{
-		return 0;
-	}
-
-	// If we have a node at that time, just return its value
-	if (m_timeMap.contains(_time))
-	{
-		// When the time is exactly the node's time, we want the inValue
-		return m_timeMap[_time].getInValue();
-	}
-
-	// lowerBound returns next value with equal or greater key. Since we already
-	// checked if the key contains a node, we know the returned node has a greater
-	// key than _time. Therefore we take the previous element to calculate the current value
-	timeMap::const_iterator v = m_timeMap.lowerBound(_time);
-
-	if( v == m_timeMap.begin() )
-	{
-		return 0;
-	}
-
-	const auto pv = std::prev(v);
-
-	if( v == m_timeMap.end() )
-	{
-		// When the time is after the last node, we want the outValue of it
-		return OUTVAL(pv);
-	}
-
-	return valueAt(pv, _time - POS(pv));
+	// Called from the audio threads for every automated model and note, so
+	// this reads the published curve instead of locking the clip
+	return m_curve.load(std::memory_order_acquire)->valueAt(_time);
 }
 
 
@@ -680,6 +691,7 @@ void AutomationClip::flipY(int min, int max)
 
 	bool changedTimeMap = false;
 
+	beginCurveUpdateBatch();
 	for (auto it = m_timeMap.begin(); it != m_timeMap.end(); ++it)
 	{
 		// Get distance from IN/OUT values to max value
@@ -694,11 +706,10 @@ void AutomationClip::flipY(int min, int max)
 		changedTimeMap = true;
 	}
 
-	if (changedTimeMap)
-	{
-		generateTangents();
-		emit dataChanged();
-	}
+	if (changedTimeMap) { generateTangents(); }
+	endCurveUpdateBatch();
+
+	if (changedTimeMap) { emit dataChanged(); }
 }
 
 
@@ -836,6 +847,8 @@ void AutomationClip::loadSettings( const QDomElement & _this )
 	// we will generate the tangents
 	bool shouldGenerateTangents = false;
 
+	beginCurveUpdateBatch();
+
 	clear();
 
 	movePosition( _this.attribute( "pos" ).toInt() );
@@ -902,6 +915,9 @@ void AutomationClip::loadSettings( const QDomElement & _this )
 	}
 
 	if (shouldGenerateTangents) { generateTangents(); }
+	else { updateCurve(); }
+
+	endCurveUpdateBatch();
 }
 
 
@@ -1086,6 +1102,7 @@ void AutomationClip::clear()
 	QMutexLocker m(&m_clipMutex);
 
 	m_timeMap.clear();
+	updateCurve();
 
 	emit dataChanged();
 }
@@ -1211,6 +1228,50 @@ void AutomationClip::generateTangents(timeMap::iterator it, int numToGenerate)
 			}
 		}
 	}
+
+	updateCurve();
+}
+
+
+
+
+void AutomationClip::updateCurve()
+{
+	QMutexLocker m(&m_clipMutex);
+
+	if (m_curveUpdateBatchDepth > 0)
+	{
+		m_curveOutdated = true;
+		return;
+	}
+
+	const auto curve = new AutomationCurve(m_timeMap, m_progressionType, m_tension);
+	AutomationCurve::retire(m_curve.exchange(curve, std::memory_order_acq_rel));
+	m_curveOutdated = false;
+}
+
+
+
+
+void AutomationClip::beginCurveUpdateBatch()
+{
+	QMutexLocker m(&m_clipMutex);
+
+	++m_curveUpdateBatchDepth;
+}
+
+
+
+
+void AutomationClip::endCurveUpdateBatch()
+{
+	QMutexLocker m(&m_clipMutex);
+
+	assert(m_curveUpdateBatchDepth > 0);
+	if (--m_curveUpdateBatchDepth == 0 && m_curveOutdated)
+	{
+		updateCurve();
+	}
 }
 
 std::vector<Track*> AutomationClip::combineAllTracks()
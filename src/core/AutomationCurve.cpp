@@ -0,0 +1,186 @@
+/*
+ * AutomationCurve.cpp - flattened automation clip nodes for lock-free lookups
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AutomationCurve.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include <QCoreApplication>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+std::mutex s_retiredMutex;
+std::vector<const AutomationCurve*> s_retiredCurves;
+bool s_deletionScheduled = false;
+
+} // namespace
+
+
+AutomationCurve::AutomationCurve(const AutomationClip::timeMap& nodes,
+	AutomationClip::ProgressionType progressionType, float tension) :
+	m_progressionType(progressionType)
+{
+	m_nodes.reserve(nodes.size());
+	for (auto it = nodes.begin(); it != nodes.end(); ++it)
+	{
+		m_nodes.push_back({POS(it), INVAL(it), OUTVAL(it), 0.f, 0.f, 0.f});
+
+		const auto nit = std::next(it);
+		if (nit == nodes.end()) { break; }
+
+		const int length = POS(nit) - POS(it);
+		auto& node = m_nodes.back();
+		node.slope = (INVAL(nit) - OUTVAL(it)) / length;
+		node.m1 = OUTTAN(it) * length * tension;
+		node.m2 = INTAN(nit) * length * tension;
+	}
+}
+
+
+
+
+float AutomationCurve::valueAt(int time) const
+{
+	const auto index = find(time);
+	if (index < 0) { return 0; }
+
+	const auto& node = m_nodes[index];
+	// When the time is exactly the node's time, we want the inValue
+	if (time == node.pos) { return node.inValue; }
+	// When the time is after the last node, we want the outValue of it
+	if (static_cast<std::size_t>(index) + 1 == m_nodes.size()) { return node.outValue; }
+
+	const int offset = time - node.pos;
+	switch (m_progressionType)
+	{
+	case AutomationClip::ProgressionType::Discrete:
+		return node.outValue;
+	case AutomationClip::ProgressionType::Linear:
+		return node.outValue + offset * node.slope;
+	case AutomationClip::ProgressionType::CubicHermite:
+	default:
+	{
+		// See AutomationClip::valueAt() for how the Hermite spline is mapped to the segment
+		const auto& next = m_nodes[index + 1];
+		const float t = static_cast<float>(offset) / static_cast<float>(next.pos - node.pos);
+		const auto t2 = t * t, t3 = t2 * t;
+		return (2 * t3 - 3 * t2 + 1) * node.outValue
+			+ (t3 - 2 * t2 + t) * node.m1
+			+ (-2 * t3 + 3 * t2) * next.inValue
+			+ (t3 - t2) * node.m2;
+	}
+	}
+}
+
+
+
+
+std::ptrdiff_t AutomationCurve::find(int time) const
+{
+	const auto size = m_nodes.size();
+	if (size == 0 || time < m_nodes.front().pos) { return -1; }
+
+	// Playback asks for increasing times, so the answer is almost always the
+	// node found last time or the one after it
+	auto index = m_cursor.load(std::memory_order_relaxed);
+	if (index >= size || m_nodes[index].pos > time)
+	{
+		index = size;
+	}
+	else if (index + 1 < size && m_nodes[index + 1].pos <= time)
+	{
+		++index;
+		if (index + 1 < size && m_nodes[index + 1].pos <= time) { index = size; }
+	}
+
+	if (index == size)
+	{
+		const auto it = std::upper_bound(m_nodes.begin(), m_nodes.end(), time,
+			[](int t, const Node& node) { return t < node.pos; });
+		index = static_cast<std::size_t>(std::distance(m_nodes.begin(), it)) - 1;
+	}
+
+	m_cursor.store(index, std::memory_order_relaxed);
+	return static_cast<std::ptrdiff_t>(index);
+}
+
+
+
+
+void AutomationCurve::retire(const AutomationCurve* curve)
+{
+	if (curve == nullptr) { return; }
+
+	auto app = QCoreApplication::instance();
+	if (app == nullptr)
+	{
+		// Shutting down, nothing is playing anymore
+		delete curve;
+		return;
+	}
+
+	const auto lock = std::lock_guard{s_retiredMutex};
+	s_retiredCurves.push_back(curve);
+	if (!s_deletionScheduled)
+	{
+		// Deleting them in one go after the GUI has finished its current work
+		// keeps the audio engine from being locked for every single edit
+		s_deletionScheduled = true;
+		QMetaObject::invokeMethod(app, &AutomationCurve::deleteRetired, Qt::QueuedConnection);
+	}
+}
+
+
+
+
+void AutomationCurve::deleteRetired()
+{
+	auto curves = std::vector<const AutomationCurve*>{};
+	{
+		const auto lock = std::lock_guard{s_retiredMutex};
+		curves.swap(s_retiredCurves);
+		s_deletionScheduled = false;
+	}
+
+	if (const auto audioEngine = Engine::audioEngine())
+	{
+		// Wait for the current period, which may still be evaluating these curves
+		const auto guard = audioEngine->requestChangesGuard();
+	}
+
+	for (const auto curve : curves)
+	{
+		delete curve;
+	}
+}
+
+} // namespace lmms
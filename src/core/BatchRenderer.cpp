@@ -0,0 +1,208 @@
+/*
+ * BatchRenderer.cpp - renders a queue of projects in a single process
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "BatchRenderer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include "Engine.h"
+#include "RenderManager.h"
+#include "Song.h"
+
+
+namespace lmms
+{
+
+
+BatchRenderer::BatchRenderer(QTextStream& input, const Job& defaults)
+{
+	int lineNumber = 0;
+	while (!input.atEnd())
+	{
+		const QString line = input.readLine();
+		++lineNumber;
+
+		if (line.trimmed().isEmpty() || line.startsWith('#')) { continue; }
+
+		Job job = defaults;
+		if (parseJob(line, job))
+		{
+			m_jobs.push_back(job);
+		}
+		else
+		{
+			fprintf(stderr, "Skipping line %d of the job list\n", lineNumber);
+			++m_failedJobs;
+		}
+	}
+	m_jobCount = m_jobs.size();
+
+	connect(&m_progressTimer, SIGNAL(timeout()), this, SLOT(updateConsoleProgress()));
+}
+
+
+
+
+BatchRenderer::~BatchRenderer() = default;
+
+
+
+
+void BatchRenderer::start()
+{
+	m_progressTimer.start(200);
+
+	// let the event loop start before the first job
+	QTimer::singleShot(0, this, SLOT(renderNextJob()));
+}
+
+
+
+
+void BatchRenderer::renderNextJob()
+{
+	while (!m_jobs.empty())
+	{
+		const Job job = m_jobs.front();
+		m_jobs.pop_front();
+
+		printf("[%zu/%zu] Loading project %s...\n", m_jobCount - m_jobs.size(), m_jobCount,
+			job.project.toUtf8().constData());
+
+		// clear the song first - a project that fails to load would
+		// otherwise leave the previous project in place
+		Engine::getSong()->clearProject();
+		Engine::getSong()->loadProject(job.project);
+		if (Engine::getSong()->isEmpty())
+		{
+			printf("The project %s is empty, skipping!\n", job.project.toUtf8().constData());
+			++m_failedJobs;
+			continue;
+		}
+		Engine::getSong()->setExportLoop(job.loop);
+
+		// an output left over from an earlier run must not be mistaken for this one
+		QFile::remove(job.output);
+
+		m_currentOutput = job.output;
+		m_renderManager = std::make_unique<RenderManager>(job.outputSettings, job.format, job.output);
+
+		// the render manager is destroyed in jobFinished(), so don't do that while it emits the signal
+		connect(m_renderManager.get(), SIGNAL(finished()), this, SLOT(jobFinished()), Qt::QueuedConnection);
+		m_renderManager->renderProject();
+		return;
+	}
+
+	m_progressTimer.stop();
+	emit finished();
+}
+
+
+
+
+void BatchRenderer::jobFinished()
+{
+	if (m_renderManager->succeeded())
+	{
+		m_renderManager->printStatistics();
+	}
+	else
+	{
+		fprintf(stderr, "\nCould not render %s\n", m_currentOutput.toUtf8().constData());
+		++m_failedJobs;
+	}
+
+	m_renderManager.reset(); // restores the previous audio device, which finalizes the file
+
+	renderNextJob();
+}
+
+
+
+
+void BatchRenderer::updateConsoleProgress()
+{
+	if (m_renderManager) { m_renderManager->updateConsoleProgress(); }
+}
+
+
+
+
+bool BatchRenderer::parseJob(const QString& line, Job& job) const
+{
+	const QStringList fields = line.split('\t');
+	if (fields.size() > 4)
+	{
+		fprintf(stderr, "Too many fields in job \"%s\"\n", line.toUtf8().constData());
+		return false;
+	}
+
+	job.project = fields[0].trimmed();
+	if (!QFileInfo(job.project).isFile())
+	{
+		fprintf(stderr, "The project %s does not exist\n", job.project.toUtf8().constData());
+		return false;
+	}
+
+	if (fields.size() > 2 && !fields[2].trimmed().isEmpty())
+	{
+		const QString extension = "." + fields[2].trimmed();
+		const auto& devices = ProjectRenderer::fileEncodeDevices;
+		const auto device = std::find_if(devices.begin(), devices.end(), [&](const auto& encodeDevice) {
+			return encodeDevice.m_getDevInst && extension == encodeDevice.m_extension;
+		});
+		if (device == devices.end())
+		{
+			fprintf(stderr, "Invalid output format %s\n", fields[2].toUtf8().constData());
+			return false;
+		}
+		job.format = device->m_fileFormat;
+	}
+
+	if (fields.size() > 3 && !fields[3].trimmed().isEmpty())
+	{
+		const sample_rate_t sampleRate = fields[3].trimmed().toUInt();
+		if (sampleRate < 44100 || sampleRate > 192000)
+		{
+			fprintf(stderr, "Invalid samplerate %s\n", fields[3].toUtf8().constData());
+			return false;
+		}
+		job.outputSettings.setSampleRate(sampleRate);
+	}
+
+	// like the "render" action, always use the extension of the format
+	const QString output = fields.size() > 1 && !fields[1].trimmed().isEmpty() ? fields[1].trimmed() : job.project;
+	const QFileInfo outputInfo(output);
+	job.output = outputInfo.absolutePath() + "/" + outputInfo.completeBaseName()
+		+ ProjectRenderer::getFileExtensionFromFormat(job.format);
+
+	return true;
+}
+
+
+} // namespace lmms
@@ -26,30 +26,125 @@
 
 #include "BufferManager.h"
 
+#include <array>
+#include <atomic>
+#include <cassert>
+
+#include "Hardware.h"
 #include "SampleFrame.h"
+#include "SlabPool.h"
 
 
 namespace lmms
 {
 
-f_cnt_t BufferManager::s_framesPerPeriod;
+namespace
+{
+
+//! Number of buffers per slab. The pool starts with one slab.
+constexpr std::size_t SlabSize = 256;
+//! Number of free buffers each thread keeps for itself
+constexpr std::size_t ThreadCacheSize = 16;
+
+SlabPool s_pool{SlabSize};
+
+// Buffers cached by the threads are still allocated from the pool, so the buffers acquired by the play handles are
+// counted separately
+std::atomic<std::size_t> s_inUse = 0;
+std::atomic<std::size_t> s_highWaterMark = 0;
+
+
+//! Free buffers owned by the current thread, so most acquire/release pairs don't need any atomic operations
+class ThreadCache
+{
+public:
+	~ThreadCache()
+	{
+		if (m_generation != s_pool.generation()) { return; }
+		while (m_count > 0) { s_pool.deallocate(m_buffers[--m_count]); }
+	}
+
+	SampleFrame* pop()
+	{
+		validate();
+		return m_count > 0 ? m_buffers[--m_count] : nullptr;
+	}
+
+	//! @returns false if the cache is full
+	bool push(SampleFrame* buffer)
+	{
+		validate();
+		if (m_count == ThreadCacheSize) { return false; }
+		m_buffers[m_count++] = buffer;
+		return true;
+	}
+
+private:
+	void validate()
+	{
+		// buffers from a previous pool have been freed along with it
+		const auto generation = s_pool.generation();
+		if (m_generation != generation)
+		{
+			m_count = 0;
+			m_generation = generation;
+		}
+	}
+
+	std::array<SampleFrame*, ThreadCacheSize> m_buffers = {};
+	std::size_t m_count = 0;
+	unsigned m_generation = 0;
+};
+
+thread_local ThreadCache t_cache;
+
+} // namespace
+
+
+f_cnt_t BufferManager::s_framesPerPeriod = 0;
 
 void BufferManager::init( f_cnt_t fpp )
 {
+	// the engine may be recreated (e.g. in tests), keep the pool if the buffers still fit
+	if (fpp == s_framesPerPeriod) { return; }
+
+	assert(s_inUse == 0);
 	s_framesPerPeriod = fpp;
+	s_pool.create(fpp * sizeof(SampleFrame), hardware_destructive_interference_size);
 }
 
 
 SampleFrame* BufferManager::acquire()
 {
-	return new SampleFrame[s_framesPerPeriod];
+	SampleFrame* buffer = t_cache.pop();
+	if (!buffer) { buffer = static_cast<SampleFrame*>(s_pool.allocate()); }
+	if (!buffer) { return nullptr; }
+
+	const auto inUse = s_inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+	auto peak = s_highWaterMark.load(std::memory_order_relaxed);
+	while (inUse > peak && !s_highWaterMark.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {}
+
+	return buffer;
 }
 
 
 
 void BufferManager::release( SampleFrame* buf )
 {
-	delete[] buf;
+	if (!buf) { return; }
+
+	s_inUse.fetch_sub(1, std::memory_order_relaxed);
+	if (!t_cache.push(buf)) { s_pool.deallocate(buf); }
+}
+
+
+
+BufferManager::Statistics BufferManager::statistics()
+{
+	auto statistics = s_pool.statistics();
+	statistics.inUse = s_inUse.load(std::memory_order_relaxed);
+	statistics.highWaterMark = s_highWaterMark.load(std::memory_order_relaxed);
+	return statistics;
 }
 
 } // namespace lmms
@@ -0,0 +1,73 @@
+/*
+ * ClipSchedule.cpp - immutable, position-sorted snapshot of a track's clips for playback
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ClipSchedule.h"
+
+#include <algorithm>
+
+#include "Clip.h"
+
+namespace lmms
+{
+
+ClipSchedule::ClipSchedule(const std::vector<Clip*>& clips)
+{
+	m_entries.reserve(clips.size());
+	for (const auto clip : clips)
+	{
+		m_entries.push_back({clip->startPosition(), clip->endPosition(), 0, clip});
+	}
+
+	std::stable_sort(m_entries.begin(), m_entries.end(),
+		[](const Entry& lhs, const Entry& rhs) { return lhs.start < rhs.start; });
+
+	tick_t maxEnd = 0;
+	for (auto& entry : m_entries)
+	{
+		maxEnd = std::max(maxEnd, entry.end);
+		entry.maxEnd = maxEnd;
+	}
+}
+
+
+
+
+void ClipSchedule::clipsInRange(std::vector<Clip*>& clips, const TimePos& start, const TimePos& end) const
+{
+	// Only the clips starting at or before the end of the range can intersect it. Walk them backwards until
+	// none of the remaining ones ends within the range.
+	auto last = std::upper_bound(m_entries.begin(), m_entries.end(), end.getTicks(),
+		[](tick_t pos, const Entry& entry) { return pos < entry.start; });
+
+	auto first = last;
+	while (first != m_entries.begin() && std::prev(first)->maxEnd >= start.getTicks()) { --first; }
+
+	for (auto it = first; it != last; ++it)
+	{
+		if (it->end < start.getTicks()) { continue; }
+		clips.insert(std::upper_bound(clips.begin(), clips.end(), it->clip, Clip::comparePosition), it->clip);
+	}
+}
+
+} // namespace lmms
@@ -33,6 +33,7 @@
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QDir>
 #include <QMessageBox>
 #include <QRegularExpression>
@@ -47,6 +48,7 @@
 #include "LocaleHelper.h"
 #include "Note.h"
 #include "PluginFactory.h"
+#include "ProjectArchive.h"
 #include "ProjectVersion.h"
 #include "SongEditor.h"
 #include "TextFloat.h"
@@ -69,24 +71,44 @@ const DataFile::ResourcesMap DataFile::ELEMENTS_WITH_RESOURCES = {
 { "audiofileprocessor", {"src"} },
 };
 
-// Vector with all the upgrade methods
-const std::vector<DataFile::UpgradeMethod> DataFile::UPGRADE_METHODS = {
-	&DataFile::upgrade_0_2_1_20070501   ,   &DataFile::upgrade_0_2_1_20070508,
-	&DataFile::upgrade_0_3_0_rc2        ,   &DataFile::upgrade_0_3_0,
-	&DataFile::upgrade_0_4_0_20080104   ,   &DataFile::upgrade_0_4_0_20080118,
-	&DataFile::upgrade_0_4_0_20080129   ,   &DataFile::upgrade_0_4_0_20080409,
-	&DataFile::upgrade_0_4_0_20080607   ,   &DataFile::upgrade_0_4_0_20080622,
-	&DataFile::upgrade_0_4_0_beta1      ,   &DataFile::upgrade_0_4_0_rc2,
-	&DataFile::upgrade_1_0_99           ,   &DataFile::upgrade_1_1_0,
-	&DataFile::upgrade_1_1_91           ,   &DataFile::upgrade_1_2_0_rc3,
-	&DataFile::upgrade_1_3_0            ,   &DataFile::upgrade_noHiddenClipNames,
-	&DataFile::upgrade_automationNodes  ,   &DataFile::upgrade_extendedNoteRange,
-	&DataFile::upgrade_defaultTripleOscillatorHQ,
-	&DataFile::upgrade_mixerRename      ,   &DataFile::upgrade_bbTcoRename,
-	&DataFile::upgrade_sampleAndHold    ,   &DataFile::upgrade_midiCCIndexing,
-	&DataFile::upgrade_loopsRename      ,   &DataFile::upgrade_noteTypes,
-	&DataFile::upgrade_fixCMTDelays     ,   &DataFile::upgrade_fixBassLoopsTypo,
-	&DataFile::findProblematicLadspaPlugins,
+const DataFile::ResourcesMap DataFile::ELEMENTS_WITH_SAMPLE_DATA = {
+{ "sampleclip", {"data"} },
+{ "audiofileprocessor", {"sampledata"} },
+{ "slicert", {"sampledata"} },
+};
+
+// Vector with all the upgrade methods, either run on the whole document or on each element with one of the given tag names
+const std::vector<DataFile::Upgrade> DataFile::UPGRADE_METHODS = {
+	{&DataFile::upgrade_0_2_1_20070501, {"arpandchords", "sampletrack", "ladspacontrols", "head"}},
+	&DataFile::upgrade_0_2_1_20070508,
+	{&DataFile::upgrade_0_3_0_rc2, {"arpandchords"}},
+	{&DataFile::upgrade_0_3_0, {"pluckedstringsynth", "lb303", "channelsettings"}},
+	{&DataFile::upgrade_0_4_0_20080104, {"fx"}},
+	{&DataFile::upgrade_0_4_0_20080118, {"fx"}},
+	{&DataFile::upgrade_0_4_0_20080129, {"arpandchords"}},
+	{&DataFile::upgrade_0_4_0_20080409, {"note", "pattern", "bbtco", "sampletco", "time", "timeline"}},
+	{&DataFile::upgrade_0_4_0_20080607, {"midi"}},
+	{&DataFile::upgrade_0_4_0_20080622, {"automation-pattern", "bbtrack"}},
+	{&DataFile::upgrade_0_4_0_beta1, {"effect"}},
+	{&DataFile::upgrade_0_4_0_rc2, {"audiofileprocessor", "lb302"}},
+	&DataFile::upgrade_1_0_99,
+	{&DataFile::upgrade_1_1_0, {"fxmixer"}},
+	{&DataFile::upgrade_1_1_91, {"audiofileprocessor", "attribute", "crossoevereqcontrols", "arpeggiator"}},
+	&DataFile::upgrade_1_2_0_rc3,
+	{&DataFile::upgrade_1_3_0, {"instrument", "effect"}},
+	{&DataFile::upgrade_noHiddenClipNames, {"track"}},
+	{&DataFile::upgrade_automationNodes, {"automationpattern"}},
+	&DataFile::upgrade_extendedNoteRange,
+	{&DataFile::upgrade_defaultTripleOscillatorHQ, {"tripleoscillator"}},
+	{&DataFile::upgrade_mixerRename, {"fxmixer", "fxchannel", "instrumenttrack", "sampletrack"}},
+	{&DataFile::upgrade_bbTcoRename, {"automationpattern", "bbtco", "pattern", "sampletco", "bbtrack", "bbtrackcontainer", "track"}},
+	{&DataFile::upgrade_sampleAndHold, {"lfocontroller"}},
+	{&DataFile::upgrade_midiCCIndexing, {"Midicontroller"}},
+	{&DataFile::upgrade_loopsRename, {"sampleclip", "audiofileprocessor"}},
+	{&DataFile::upgrade_noteTypes, {"note"}},
+	{&DataFile::upgrade_fixCMTDelays, {"effect"}},
+	{&DataFile::upgrade_fixBassLoopsTypo, {"sampleclip", "audiofileprocessor"}},
+	{&DataFile::findProblematicLadspaPlugins, {"ladspacontrols"}},
 	&DataFile::upgrade_noHiddenAutomationTracks
 };
 
@@ -177,6 +199,18 @@ DataFile::DataFile( const QString & _fileName ) :
 		return;
 	}
 
+	if (ProjectArchive::isArchive(inFile))
+	{
+		// Only the document is read here, the samples are read from the archive when they are restored
+		m_archive = ProjectArchive::open(_fileName);
+		loadData(m_archive ? m_archive->read(ProjectArchive::DocumentChunk) : QByteArray{}, _fileName);
+		if (m_archive && !documentElement().isNull())
+		{
+			documentElement().setAttribute(ProjectArchive::PathAttribute, m_archive->path());
+		}
+		return;
+	}
+
 	loadData( inFile.readAll(), _fileName );
 }
 
@@ -202,7 +236,7 @@ bool DataFile::validate( QString extension )
 	switch( m_type )
 	{
 	case Type::SongProject:
-		if( extension == "mmp" || extension == "mmpz" )
+		if( extension == "mmp" || extension == "mmpz" || extension == "mmpc" )
 		{
 			return true;
 		}
@@ -226,7 +260,7 @@ bool DataFile::validate( QString extension )
 		}
 		break;
 	case Type::Unknown:
-		if (! ( extension == "mmp" || extension == "mpt" || extension == "mmpz" ||
+		if (! ( extension == "mmp" || extension == "mpt" || extension == "mmpz" || extension == "mmpc" ||
 				extension == "xpf" || extension == "xml" ||
 				( extension == "xiz" && ! getPluginFactory()->pluginSupportingExtension(extension).isNull()) ||
 				extension == "sf2" || extension == "sf3" || extension == "pat" || extension == "mid" ||
@@ -268,7 +302,8 @@ QString DataFile::nameWithExtension( const QString & _fn ) const
 		case Type::SongProject:
 			if( extension != "mmp" &&
 					extension != "mpt" &&
-					extension != "mmpz" )
+					extension != "mmpz" &&
+					extension != "mmpc" )
 			{
 				if( ConfigManager::inst()->value( "app",
 						"nommpz" ).toInt() == 0 )
@@ -306,6 +341,7 @@ void DataFile::write( QTextStream & _strm )
 		cleanMetaNodes( documentElement() );
 	}
 
+	inlineSampleData();
 	save(_strm, 2);
 }
 
@@ -402,7 +438,12 @@ bool DataFile::writeFile(const QString& filename, bool withResources)
 	}
 
 	const QString extension = fullName.section('.', -1);
-	if (extension == "mmpz" || extension == "xptz")
+	if (extension == "mmpc")
+	{
+		// Makes the commit below fail and report the error
+		if (!writeArchive(outfile)) { outfile.cancelWriting(); }
+	}
+	else if (extension == "mmpz" || extension == "xptz")
 	{
 		QString xml;
 		QTextStream ts( &xml );
@@ -650,40 +691,105 @@ void DataFile::cleanMetaNodes( QDomElement _de )
 	}
 }
 
-void DataFile::mapSrcAttributeInElementsWithResources(const QMap<QString, QString>& map)
+void DataFile::mapSrcAttributeInElementWithResources(QDomElement& element, const QMap<QString, QString>& map)
 {
-	for (const auto& [elem, srcAttrs] : ELEMENTS_WITH_RESOURCES)
+	const auto resources = ELEMENTS_WITH_RESOURCES.find(element.tagName());
+	if (resources == ELEMENTS_WITH_RESOURCES.end()) { return; }
+
+	for (const auto& srcAttr : resources->second)
 	{
-		auto elements = elementsByTagName(elem);
+		if (!element.hasAttribute(srcAttr)) { continue; }
+
+		const QString srcVal = element.attribute(srcAttr);
 
-		for (const auto& srcAttr : srcAttrs)
+		const auto it = map.constFind(srcVal);
+		if (it != map.constEnd())
 		{
-			for (int i = 0; i < elements.length(); ++i)
+			element.setAttribute(srcAttr, *it);
+		}
+	}
+}
+
+
+bool DataFile::writeArchive(QIODevice& output)
+{
+	if (type() == Type::SongProject || type() == Type::SongProjectTemplate
+					|| type() == Type::InstrumentTrackSettings)
+	{
+		cleanMetaNodes(documentElement());
+	}
+
+	// Leave this document untouched, the sample data is only replaced by references in the archived one
+	auto document = cloneNode(true).toDocument();
+	document.documentElement().removeAttribute(ProjectArchive::PathAttribute);
+
+	auto writer = ProjectArchive::Writer{output};
+	int samples = 0;
+	for (const auto& [tagName, attributes] : ELEMENTS_WITH_SAMPLE_DATA)
+	{
+		const auto elements = document.elementsByTagName(tagName);
+		for (int i = 0; i < elements.length(); ++i)
+		{
+			auto element = elements.item(i).toElement();
+			for (const auto& attribute : attributes)
 			{
-				auto item = elements.item(i).toElement();
+				const auto value = element.attribute(attribute);
+				if (value.isEmpty()) { continue; }
+
+				// Chunks of the archive this document was loaded from are copied over without decoding them
+				const auto data = ProjectArchive::isChunkReference(value)
+					? (m_archive ? m_archive->read(ProjectArchive::chunkName(value)) : QByteArray{})
+					: QByteArray::fromBase64(value.toLatin1());
+				if (data.isEmpty()) { continue; }
+
+				// Audio barely compresses with zlib, so sample chunks are stored as they are
+				const auto name = QString{"samples/%1"}.arg(samples++);
+				writer.add(name, data, ProjectArchive::Compression::None);
+				element.setAttribute(attribute, ProjectArchive::chunkReference(name));
+			}
+		}
+	}
 
-				if (item.isNull() || !item.hasAttribute(srcAttr)) { continue; }
+	writer.add(ProjectArchive::DocumentChunk, document.toByteArray(2), ProjectArchive::Compression::Zlib);
+	return writer.finish();
+}
 
-				const QString srcVal = item.attribute(srcAttr);
 
-				const auto it = map.constFind(srcVal);
-				if (it != map.constEnd())
-				{
-					item.setAttribute(srcAttr, *it);
-				}
+
+
+void DataFile::inlineSampleData()
+{
+	if (!m_archive) { return; }
+
+	for (const auto& [tagName, attributes] : ELEMENTS_WITH_SAMPLE_DATA)
+	{
+		const auto elements = elementsByTagName(tagName);
+		for (int i = 0; i < elements.length(); ++i)
+		{
+			auto element = elements.item(i).toElement();
+			for (const auto& attribute : attributes)
+			{
+				const auto value = element.attribute(attribute);
+				if (!ProjectArchive::isChunkReference(value)) { continue; }
+
+				const auto data = m_archive->read(ProjectArchive::chunkName(value));
+				element.setAttribute(attribute, QString::fromLatin1(data.toBase64()));
 			}
 		}
 	}
+
+	documentElement().removeAttribute(ProjectArchive::PathAttribute);
+	m_archive.reset();
 }
 
 
-void DataFile::upgrade_0_2_1_20070501()
+
+
+void DataFile::upgrade_0_2_1_20070501( QDomElement & el )
 {
 	// Upgrade to version 0.2.1-20070501
-	QDomNodeList list = elementsByTagName( "arpandchords" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	if( el.tagName() == "arpandchords" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		if( el.hasAttribute( "arpdir" ) )
 		{
 			int arpdir = el.attribute( "arpdir" ).toInt();
@@ -697,11 +803,8 @@ void DataFile::upgrade_0_2_1_20070501()
 			}
 		}
 	}
-
-	list = elementsByTagName( "sampletrack" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "sampletrack" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		if( el.attribute( "vol" ) != "" )
 		{
 			el.setAttribute( "vol", LocaleHelper::toFloat(
@@ -718,11 +821,8 @@ void DataFile::upgrade_0_2_1_20070501()
 			}
 		}
 	}
-
-	list = elementsByTagName( "ladspacontrols" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "ladspacontrols" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		QDomNode anode = el.namedItem( "automation-pattern" );
 		QDomNode node = anode.firstChild();
 		while( !node.isNull() )
@@ -745,52 +845,54 @@ void DataFile::upgrade_0_2_1_20070501()
 			node = node.nextSibling();
 		}
 	}
-
-	QDomNode node = m_head.firstChild();
-	while( !node.isNull() )
+	else if( el == m_head )
 	{
-		if( node.isElement() )
+		QDomNode node = m_head.firstChild();
+		while( !node.isNull() )
 		{
-			if( node.nodeName() == "bpm" )
+			if( node.isElement() )
 			{
-				int value = node.toElement().attribute(
-						"value" ).toInt();
-				if( value > 0 )
+				if( node.nodeName() == "bpm" )
 				{
-					m_head.setAttribute( "bpm",
-								value );
-					QDomNode oldNode = node;
-					node = node.nextSibling();
-					m_head.removeChild( oldNode );
-					continue;
+					int value = node.toElement().attribute(
+							"value" ).toInt();
+					if( value > 0 )
+					{
+						m_head.setAttribute( "bpm",
+									value );
+						QDomNode oldNode = node;
+						node = node.nextSibling();
+						m_head.removeChild( oldNode );
+						continue;
+					}
 				}
-			}
-			else if( node.nodeName() == "mastervol" )
-			{
-				int value = node.toElement().attribute(
-						"value" ).toInt();
-				if( value > 0 )
+				else if( node.nodeName() == "mastervol" )
+				{
+					int value = node.toElement().attribute(
+							"value" ).toInt();
+					if( value > 0 )
+					{
+						m_head.setAttribute(
+							"mastervol", value );
+						QDomNode oldNode = node;
+						node = node.nextSibling();
+						m_head.removeChild( oldNode );
+						continue;
+					}
+				}
+				else if( node.nodeName() == "masterpitch" )
 				{
-					m_head.setAttribute(
-						"mastervol", value );
+					m_head.setAttribute( "masterpitch",
+						-node.toElement().attribute(
+							"value" ).toInt() );
 					QDomNode oldNode = node;
 					node = node.nextSibling();
 					m_head.removeChild( oldNode );
 					continue;
 				}
 			}
-			else if( node.nodeName() == "masterpitch" )
-			{
-				m_head.setAttribute( "masterpitch",
-					-node.toElement().attribute(
-						"value" ).toInt() );
-				QDomNode oldNode = node;
-				node = node.nextSibling();
-				m_head.removeChild( oldNode );
-				continue;
-			}
+			node = node.nextSibling();
 		}
-		node = node.nextSibling();
 	}
 }
 
@@ -857,159 +959,110 @@ void DataFile::upgrade_0_2_1_20070508()
 }
 
 
-void DataFile::upgrade_0_3_0_rc2()
+void DataFile::upgrade_0_3_0_rc2( QDomElement & el )
 {
 	// Upgrade to version 0.3.0-rc2 from some version greater than or equal to 0.2.1-20070508
-	QDomNodeList list = elementsByTagName( "arpandchords" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	if( el.attribute( "arpdir" ).toInt() > 0 )
 	{
-		QDomElement el = list.item( i ).toElement();
-		if( el.attribute( "arpdir" ).toInt() > 0 )
-		{
-			el.setAttribute( "arpdir",
-				el.attribute( "arpdir" ).toInt() - 1 );
-		}
+		el.setAttribute( "arpdir",
+			el.attribute( "arpdir" ).toInt() - 1 );
 	}
 }
 
 
-void DataFile::upgrade_0_3_0()
+void DataFile::upgrade_0_3_0( QDomElement & el )
 {
 	// Upgrade to version 0.3.0 (final) from some version greater than or equal to 0.3.0-rc2
-	QDomNodeList list;
-	while( !( list = elementsByTagName(
-				"pluckedstringsynth" ) ).isEmpty() )
+	if( el.tagName() == "pluckedstringsynth" )
 	{
-		QDomElement el = list.item( 0 ).toElement();
 		el.setTagName( "vibedstrings" );
 		el.setAttribute( "active0", 1 );
 	}
-
-	while( !( list = elementsByTagName( "lb303" ) ).isEmpty() )
+	else if( el.tagName() == "lb303" )
 	{
-		QDomElement el = list.item( 0 ).toElement();
 		el.setTagName( "lb302" );
 	}
-
-	while( !( list = elementsByTagName( "channelsettings" ) ).
-							isEmpty() )
+	else if( el.tagName() == "channelsettings" )
 	{
-		QDomElement el = list.item( 0 ).toElement();
 		el.setTagName( "instrumenttracksettings" );
 	}
 }
 
 
-void DataFile::upgrade_0_4_0_20080104()
+void DataFile::upgrade_0_4_0_20080104( QDomElement & el )
 {
 	// Upgrade to version 0.4.0-20080104 from some version greater than or equal to 0.3.0 (final)
-	QDomNodeList list = elementsByTagName( "fx" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	if( el.hasAttribute( "fxdisabled" ) &&
+		el.attribute( "fxdisabled" ).toInt() == 0 )
 	{
-		QDomElement el = list.item( i ).toElement();
-		if( el.hasAttribute( "fxdisabled" ) &&
-			el.attribute( "fxdisabled" ).toInt() == 0 )
-		{
-			el.setAttribute( "enabled", 1 );
-		}
+		el.setAttribute( "enabled", 1 );
 	}
 }
 
 
-void DataFile::upgrade_0_4_0_20080118()
+void DataFile::upgrade_0_4_0_20080118( QDomElement & fxchain )
 {
 	// Upgrade to version 0.4.0-20080118 from some version greater than or equal to 0.4.0-20080104
-	QDomNodeList list;
-	while( !( list = elementsByTagName( "fx" ) ).isEmpty() )
-	{
-		QDomElement fxchain = list.item( 0 ).toElement();
-		fxchain.setTagName( "fxchain" );
-		QDomNode rack = list.item( 0 ).firstChild();
-		QDomNodeList effects = rack.childNodes();
-		// move items one level up
-		while( effects.count() )
-		{
-			fxchain.appendChild( effects.at( 0 ) );
-		}
-		fxchain.setAttribute( "numofeffects",
-			rack.toElement().attribute( "numofeffects" ) );
-		fxchain.removeChild( rack );
+	fxchain.setTagName( "fxchain" );
+	QDomNode rack = fxchain.firstChild();
+	QDomNodeList effects = rack.childNodes();
+	// move items one level up
+	while( effects.count() )
+	{
+		fxchain.appendChild( effects.at( 0 ) );
 	}
+	fxchain.setAttribute( "numofeffects",
+		rack.toElement().attribute( "numofeffects" ) );
+	fxchain.removeChild( rack );
 }
 
 
-void DataFile::upgrade_0_4_0_20080129()
+void DataFile::upgrade_0_4_0_20080129( QDomElement & aac )
 {
 	// Upgrade to version 0.4.0-20080129 from some version greater than or equal to 0.4.0-20080118
-	QDomNodeList list;
-	while( !( list =
-		elementsByTagName( "arpandchords" ) ).isEmpty() )
-	{
-		QDomElement aac = list.item( 0 ).toElement();
-		aac.setTagName( "arpeggiator" );
-		QDomNode cloned = aac.cloneNode();
-		cloned.toElement().setTagName( "chordcreator" );
-		aac.parentNode().appendChild( cloned );
-	}
+	aac.setTagName( "arpeggiator" );
+	QDomNode cloned = aac.cloneNode();
+	cloned.toElement().setTagName( "chordcreator" );
+	aac.parentNode().appendChild( cloned );
 }
 
 
-void DataFile::upgrade_0_4_0_20080409()
+void DataFile::upgrade_0_4_0_20080409( QDomElement & el )
 {
 	// Upgrade to version 0.4.0-20080409 from some version greater than or equal to 0.4.0-20080129
-	QStringList s;
-	s << "note" << "pattern" << "bbtco" << "sampletco" << "time";
-	for( QStringList::iterator it = s.begin(); it < s.end(); ++it )
-	{
-		QDomNodeList list = elementsByTagName( *it );
-		for( int i = 0; !list.item( i ).isNull(); ++i )
-		{
-			QDomElement el = list.item( i ).toElement();
-			el.setAttribute( "pos",
-				el.attribute( "pos" ).toInt()*3 );
-			el.setAttribute( "len",
-				el.attribute( "len" ).toInt()*3 );
-		}
-	}
-	QDomNodeList list = elementsByTagName( "timeline" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	if( el.tagName() == "timeline" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		el.setAttribute( "lp0pos",
 			el.attribute( "lp0pos" ).toInt()*3 );
 		el.setAttribute( "lp1pos",
 			el.attribute( "lp1pos" ).toInt()*3 );
 	}
+	else
+	{
+		el.setAttribute( "pos",
+			el.attribute( "pos" ).toInt()*3 );
+		el.setAttribute( "len",
+			el.attribute( "len" ).toInt()*3 );
+	}
 }
 
 
-void DataFile::upgrade_0_4_0_20080607()
+void DataFile::upgrade_0_4_0_20080607( QDomElement & el )
 {
 	// Upgrade to version 0.4.0-20080607 from some version greater than or equal to 0.3.0-20080409
-	QDomNodeList list;
-	while( !( list = elementsByTagName( "midi" ) ).isEmpty() )
-	{
-		QDomElement el = list.item( 0 ).toElement();
-		el.setTagName( "midiport" );
-	}
+	el.setTagName( "midiport" );
 }
 
 
-void DataFile::upgrade_0_4_0_20080622()
+void DataFile::upgrade_0_4_0_20080622( QDomElement & el )
 {
 	// Upgrade to version 0.4.0-20080622 from some version greater than or equal to 0.3.0-20080607
-	QDomNodeList list;
-	while( !( list = elementsByTagName(
-				"automation-pattern" ) ).isEmpty() )
+	if( el.tagName() == "automation-pattern" )
 	{
-		QDomElement el = list.item( 0 ).toElement();
 		el.setTagName( "automationpattern" );
 	}
-
-	list = elementsByTagName( "bbtrack" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "bbtrack" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		QString s = el.attribute( "name" );
 		s.replace(QRegularExpression("^Beat/Baseline "), "Beat/Bassline");
 		el.setAttribute( "name", s );
@@ -1017,62 +1070,52 @@ void DataFile::upgrade_0_4_0_20080622()
 }
 
 
-void DataFile::upgrade_0_4_0_beta1()
+void DataFile::upgrade_0_4_0_beta1( QDomElement & el )
 {
 	// Upgrade to version 0.4.0-beta1 from some version greater than or equal to 0.4.0-20080622
 	// convert binary effect-key-blobs to XML
-	QDomNodeList list;
-	list = elementsByTagName( "effect" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
-	{
-		QDomElement el = list.item( i ).toElement();
-		QString k = el.attribute( "key" );
-		if( !k.isEmpty() )
-		{
-			const QList<QVariant> l =
-				base64::decode(k, QMetaType::QVariantList).toList();
-			if( !l.isEmpty() )
+	QString k = el.attribute( "key" );
+	if( !k.isEmpty() )
+	{
+		const QList<QVariant> l =
+			base64::decode(k, QMetaType::QVariantList).toList();
+		if( !l.isEmpty() )
+		{
+			QString name = l[0].toString();
+			QVariant u = l[1];
+			EffectKey::AttributeMap m;
+			// VST-effect?
+			if (typeId(u) == QMetaType::QString)
 			{
-				QString name = l[0].toString();
-				QVariant u = l[1];
-				EffectKey::AttributeMap m;
-				// VST-effect?
-				if (typeId(u) == QMetaType::QString)
-				{
-					m["file"] = u.toString();
-				}
-				// LADSPA-effect?
-				else if (typeId(u) == QMetaType::QStringList)
-				{
-					const QStringList sl = u.toStringList();
-					m["plugin"] = sl.value( 0 );
-					m["file"] = sl.value( 1 );
-				}
-				EffectKey key( nullptr, name, m );
-				el.appendChild( key.saveXML( *this ) );
+				m["file"] = u.toString();
+			}
+			// LADSPA-effect?
+			else if (typeId(u) == QMetaType::QStringList)
+			{
+				const QStringList sl = u.toStringList();
+				m["plugin"] = sl.value( 0 );
+				m["file"] = sl.value( 1 );
 			}
+			EffectKey key( nullptr, name, m );
+			el.appendChild( key.saveXML( *this ) );
 		}
 	}
 }
 
 
-void DataFile::upgrade_0_4_0_rc2()
+void DataFile::upgrade_0_4_0_rc2( QDomElement & el )
 {
 	// Upgrade to version 0.4.0-rc2 from some version greater than or equal to 0.4.0-beta1
-	QDomNodeList list = elementsByTagName( "audiofileprocessor" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	if( el.tagName() == "audiofileprocessor" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		QString s = el.attribute( "src" );
 		s.replace( "drumsynth/misc ", "drumsynth/misc_" );
 		s.replace( "drumsynth/r&b", "drumsynth/r_n_b" );
 		s.replace( "drumsynth/r_b", "drumsynth/r_n_b" );
 		el.setAttribute( "src", s );
 	}
-	list = elementsByTagName( "lb302" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "lb302" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		int s = el.attribute( "shape" ).toInt();
 		if( s >= 1 )
 		{
@@ -1123,56 +1166,47 @@ void DataFile::upgrade_1_0_99()
 }
 
 
-void DataFile::upgrade_1_1_0()
+void DataFile::upgrade_1_1_0(QDomElement& el)
 {
-	QDomNodeList list = elementsByTagName("fxchannel");
-	for (int i = 1; !list.item(i).isNull(); ++i)
+	// Every channel but the master channel sends to the master channel
+	QDomElement channel = el.firstChildElement("fxchannel");
+	if (channel.isNull()) { return; }
+	for (channel = channel.nextSiblingElement("fxchannel"); !channel.isNull();
+		channel = channel.nextSiblingElement("fxchannel"))
 	{
-		QDomElement el = list.item(i).toElement();
 		QDomElement send = createElement("send");
 		send.setAttribute("channel", "0");
 		send.setAttribute("amount", "1");
-		el.appendChild(send);
+		channel.appendChild(send);
 	}
 }
 
 
-void DataFile::upgrade_1_1_91()
+void DataFile::upgrade_1_1_91( QDomElement & el )
 {
 	// Upgrade to version 1.1.91 from some version less than 1.1.91
-	QDomNodeList list = elementsByTagName( "audiofileprocessor" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	if( el.tagName() == "audiofileprocessor" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		QString s = el.attribute( "src" );
 		s.replace(QRegularExpression("/samples/bassloopes/"), "/samples/bassloops/");
 		el.setAttribute( "src", s );
 	}
-
-	list = elementsByTagName( "attribute" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "attribute" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		if( el.attribute( "name" ) == "plugin" && el.attribute( "value" ) == "vocoder-lmms" ) {
 			el.setAttribute( "value", "vocoder" );
 		}
 	}
-
-	list = elementsByTagName( "crossoevereqcontrols" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "crossoevereqcontrols" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		// invert the mute LEDs
 		for( int j = 1; j <= 4; ++j ){
 			QString a = QString( "mute%1" ).arg( j );
 			el.setAttribute( a, ( el.attribute( a ) == "0" ) ? "1" : "0" );
 		}
 	}
-
-	list = elementsByTagName( "arpeggiator" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "arpeggiator" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		// Swap elements ArpDirRandom and ArpDirDownAndUp
 		if( el.attribute( "arpdir" ) == "3" )
 		{
@@ -1311,12 +1345,10 @@ QDebug operator<<(QDebug dbg, const QDomNode& node)
 	return dbg;
 }
 
-void DataFile::upgrade_1_3_0()
+void DataFile::upgrade_1_3_0( QDomElement & el )
 {
-	QDomNodeList list = elementsByTagName( "instrument" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	if( el.tagName() == "instrument" )
 	{
-		QDomElement el = list.item( i ).toElement();
 		if( el.attribute( "name" ) == "papu" )
 		{
 			el.setAttribute( "name", "freeboy" );
@@ -1338,11 +1370,9 @@ void DataFile::upgrade_1_3_0()
 			}
 		}
 	}
-
-	list = elementsByTagName( "effect" );
-	for( int i = 0; !list.item( i ).isNull(); ++i )
+	else if( el.tagName() == "effect" )
 	{
-		QDomElement effect = list.item( i ).toElement();
+		QDomElement & effect = el;
 		if( effect.attribute( "name" ) == "ladspaeffect" )
 		{
 			QDomNodeList keys = effect.elementsByTagName( "key" );
@@ -1692,10 +1722,8 @@ void DataFile::upgrade_noHiddenAutomationTracks()
 	}
 }
 
-void DataFile::upgrade_noHiddenClipNames()
+void DataFile::upgrade_noHiddenClipNames(QDomElement& track)
 {
-	QDomNodeList tracks = elementsByTagName("track");
-
 	auto clearDefaultNames = [](QDomNodeList clips, QString trackName)
 	{
 		for (int j = 0; j < clips.size(); ++j)
@@ -1706,66 +1734,47 @@ void DataFile::upgrade_noHiddenClipNames()
 		}
 	};
 
-	for (int i = 0; i < tracks.size(); ++i)
-	{
-		QDomElement track = tracks.item(i).toElement();
-		QString trackName = track.attribute("name", "");
+	QString trackName = track.attribute("name", "");
 
-		QDomNodeList instClips = track.elementsByTagName("pattern");
-		QDomNodeList autoClips = track.elementsByTagName("automationpattern");
-		QDomNodeList bbClips = track.elementsByTagName("bbtco");
+	QDomNodeList instClips = track.elementsByTagName("pattern");
+	QDomNodeList autoClips = track.elementsByTagName("automationpattern");
+	QDomNodeList bbClips = track.elementsByTagName("bbtco");
 
-		clearDefaultNames(instClips, trackName);
-		clearDefaultNames(autoClips, trackName);
-		clearDefaultNames(bbClips, trackName);
-	}
+	clearDefaultNames(instClips, trackName);
+	clearDefaultNames(autoClips, trackName);
+	clearDefaultNames(bbClips, trackName);
 }
 
-void DataFile::upgrade_automationNodes()
+void DataFile::upgrade_automationNodes(QDomElement& autoPattern)
 {
-	QDomNodeList autoPatterns = elementsByTagName("automationpattern");
+	// On each automation pattern, get all <time> elements
+	QDomNodeList times = autoPattern.elementsByTagName("time");
 
-	// Go through all automation patterns
-	for (int i = 0; i < autoPatterns.size(); ++i)
+	// Loop through all <time> elements and change what we need
+	for (int j=0; j < times.size(); ++j)
 	{
-		QDomElement autoPattern = autoPatterns.item(i).toElement();
-
-		// On each automation pattern, get all <time> elements
-		QDomNodeList times = autoPattern.elementsByTagName("time");
-
-		// Loop through all <time> elements and change what we need
-		for (int j=0; j < times.size(); ++j)
-		{
-			QDomElement el = times.item(j).toElement();
+		QDomElement el = times.item(j).toElement();
 
-			float value = LocaleHelper::toFloat(el.attribute("value"));
+		float value = LocaleHelper::toFloat(el.attribute("value"));
 
-			// inValue will be equal to "value" and outValue will
-			// be set to the same
-			el.setAttribute("outValue", value);
-		}
+		// inValue will be equal to "value" and outValue will
+		// be set to the same
+		el.setAttribute("outValue", value);
 	}
 }
 
 // Convert the negative length notes to StepNotes
-void DataFile::upgrade_noteTypes()
+void DataFile::upgrade_noteTypes(QDomElement& note)
 {
-	const auto notes = elementsByTagName("note");
-
-	for (int i = 0; i < notes.size(); ++i)
+	const auto noteSize = note.attribute("len").toInt();
+	if (noteSize < 0)
 	{
-		auto note = notes.item(i).toElement();
-
-		const auto noteSize = note.attribute("len").toInt();
-		if (noteSize < 0)
-		{
-			note.setAttribute("len", DefaultTicksPerBar / 16);
-			note.setAttribute("type", static_cast<int>(Note::Type::Step));
-		}
+		note.setAttribute("len", DefaultTicksPerBar / 16);
+		note.setAttribute("type", static_cast<int>(Note::Type::Step));
 	}
 }
 
-void DataFile::upgrade_fixCMTDelays()
+void DataFile::upgrade_fixCMTDelays(QDomElement& effect)
 {
 	static const QMap<QString, QString> nameMap {
 		{ "delay_0,01s", "delay_0.01s" },
@@ -1774,30 +1783,23 @@ void DataFile::upgrade_fixCMTDelays()
 		{ "fbdelay_0,1s", "fbdelay_0.1s" }
 	};
 
-	const auto effects = elementsByTagName("effect");
+	// We are only interested in LADSPA plugins
+	if (effect.attribute("name") != "ladspaeffect") { return; }
 
-	for (int i = 0; i < effects.size(); ++i)
+	// Fetch all attributes (LMMS) beneath the LADSPA effect so that we can check the value of the plugin attribute (XML)
+	auto attributes = effect.elementsByTagName("attribute");
+	for (int j = 0; j < attributes.size(); ++j)
 	{
-		auto effect = effects.item(i).toElement();
-
-		// We are only interested in LADSPA plugins
-		if (effect.attribute("name") != "ladspaeffect") { continue; }
+		auto attribute = attributes.item(j).toElement();
 
-		// Fetch all attributes (LMMS) beneath the LADSPA effect so that we can check the value of the plugin attribute (XML)
-		auto attributes = effect.elementsByTagName("attribute");
-		for (int j = 0; j < attributes.size(); ++j)
+		if (attribute.attribute("name") == "plugin")
 		{
-			auto attribute = attributes.item(j).toElement();
+			const auto attributeValue = attribute.attribute("value");
 
-			if (attribute.attribute("name") == "plugin")
+			const auto it = nameMap.constFind(attributeValue);
+			if (it != nameMap.constEnd())
 			{
-				const auto attributeValue = attribute.attribute("value");
-
-				const auto it = nameMap.constFind(attributeValue);
-				if (it != nameMap.constEnd())
-				{
-					attribute.setAttribute("value", *it);
-				}
+				attribute.setAttribute("value", *it);
 			}
 		}
 	}
@@ -1823,87 +1825,45 @@ void DataFile::upgrade_extendedNoteRange()
  * Older projects were made without this feature and would sound differently if loaded
  * with the new default setting. This upgrade routine preserves their old behavior.
  */
-void DataFile::upgrade_defaultTripleOscillatorHQ()
+void DataFile::upgrade_defaultTripleOscillatorHQ(QDomElement& tripleoscillator)
 {
-	QDomNodeList tripleoscillators = elementsByTagName("tripleoscillator");
-	for (int i = 0; !tripleoscillators.item(i).isNull(); i++)
+	for (int j = 1; j <= 3; j++)
 	{
-		for (int j = 1; j <= 3; j++)
+		// Only set the attribute if it does not exist (default template has it but reports as 1.2.0)
+		if (tripleoscillator.attribute("useWaveTable" + QString::number(j)) == "")
 		{
-			// Only set the attribute if it does not exist (default template has it but reports as 1.2.0)
-			if (tripleoscillators.item(i).toElement().attribute("useWaveTable" + QString::number(j)) == "")
-			{
-				tripleoscillators.item(i).toElement().setAttribute("useWaveTable" + QString::number(j), 0);
-			}
+			tripleoscillator.setAttribute("useWaveTable" + QString::number(j), 0);
 		}
 	}
 }
 
 
 // Remove FX prefix from mixer and related nodes
-void DataFile::upgrade_mixerRename()
+void DataFile::upgrade_mixerRename(QDomElement& item)
 {
 	// Change nodename <fxmixer> to <mixer>
-	QDomNodeList fxmixer = elementsByTagName("fxmixer");
-	for (int i = 0; i < fxmixer.length(); ++i)
+	if (item.tagName() == "fxmixer")
 	{
-		auto item = fxmixer.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
 		item.setTagName("mixer");
 	}
-
 	// Change nodename <fxchannel> to <mixerchannel>
-	QDomNodeList fxchannel = elementsByTagName("fxchannel");
-	for (int i = 0; i < fxchannel.length(); ++i)
+	else if (item.tagName() == "fxchannel")
 	{
-		auto item = fxchannel.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
 		item.setTagName("mixerchannel");
 	}
-
-	// Change the attribute fxch of element <instrumenttrack> to mixch
-	QDomNodeList fxch = elementsByTagName("instrumenttrack");
-	for (int i = 0; i < fxch.length(); ++i)
-	{
-		auto item = fxch.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
-		if (item.hasAttribute("fxch"))
-		{
-			item.setAttribute("mixch", item.attribute("fxch"));
-			item.removeAttribute("fxch");
-		}
-	}
-	// Change the attribute fxch of element <sampletrack> to mixch
-	fxch = elementsByTagName("sampletrack");
-	for (int i = 0; i < fxch.length(); ++i)
+	// Change the attribute fxch of elements <instrumenttrack> and <sampletrack> to mixch
+	else if (item.hasAttribute("fxch"))
 	{
-		auto item = fxch.item(i).toElement();
-		if (item.isNull())
-		{
-			continue;
-		}
-		if (item.hasAttribute("fxch"))
-		{
-			item.setAttribute("mixch", item.attribute("fxch"));
-			item.removeAttribute("fxch");
-		}
+		item.setAttribute("mixch", item.attribute("fxch"));
+		item.removeAttribute("fxch");
 	}
 }
 
 
 // Rename BB to pattern and TCO to clip
-void DataFile::upgrade_bbTcoRename()
+void DataFile::upgrade_bbTcoRename(QDomElement& e)
 {
-	std::vector<std::pair<const char *, const char *>> names {
+	static const std::map<QString, QString> names {
 		{"automationpattern", "automationclip"},
 		{"bbtco", "patternclip"},
 		{"pattern", "midiclip"},
@@ -1912,19 +1872,13 @@ void DataFile::upgrade_bbTcoRename()
 		{"bbtrackcontainer", "patternstore"},
 	};
 	// Replace names of XML tags
-	for (auto name : names)
+	if (const auto name = names.find(e.tagName()); name != names.end())
 	{
-		QDomNodeList elements = elementsByTagName(name.first);
-		for (int i = 0; !elements.item(i).isNull(); ++i)
-		{
-			elements.item(i).toElement().setTagName(name.second);
-		}
+		e.setTagName(name->second);
 	}
 	// Replace "Beat/Bassline" with "Pattern" in track names
-	QDomNodeList elements = elementsByTagName("track");
-	for (int i = 0; !elements.item(i).isNull(); ++i)
+	else
 	{
-		auto e = elements.item(i).toElement();
 		static_assert(Track::Type::Pattern == static_cast<Track::Type>(1), "Must be type=1 for backwards compatibility");
 		if (static_cast<Track::Type>(e.attribute("type").toInt()) == Track::Type::Pattern)
 		{
@@ -1935,18 +1889,12 @@ void DataFile::upgrade_bbTcoRename()
 
 
 // Set LFO speed to 0.01 on projects made before sample-and-hold PR
-void DataFile::upgrade_sampleAndHold()
+void DataFile::upgrade_sampleAndHold(QDomElement& e)
 {
-	QDomNodeList elements = elementsByTagName("lfocontroller");
-	for (int i = 0; i < elements.length(); ++i)
+	// Correct old random wave LFO speeds
+	if (e.attribute("wave").toInt() == 6)
 	{
-		if (elements.item(i).isNull()) { continue; }
-		auto e = elements.item(i).toElement();
-		// Correct old random wave LFO speeds
-		if (e.attribute("wave").toInt() == 6)
-		{
-			e.setAttribute("speed", 0.01f);
-		}
+		e.setAttribute("speed", 0.01f);
 	}
 }
 
@@ -2004,69 +1952,48 @@ static QMap<QString, QString> buildReplacementMap()
 }
 
 // Change loops' filenames in <sampleclip>s
-void DataFile::upgrade_loopsRename()
+void DataFile::upgrade_loopsRename(QDomElement& element)
 {
 	static const QMap<QString, QString> namesToNamesWithBPMsMap = buildReplacementMap();
 
-	mapSrcAttributeInElementsWithResources(namesToNamesWithBPMsMap);
+	mapSrcAttributeInElementWithResources(element, namesToNamesWithBPMsMap);
 }
 
 //! Update MIDI CC indexes, so that they are counted from 0. Older releases of LMMS
 //! count the CCs from 1.
-void DataFile::upgrade_midiCCIndexing()
+void DataFile::upgrade_midiCCIndexing(QDomElement& element)
 {
 	static constexpr std::array attributesToUpdate{"inputcontroller", "outputcontroller"};
 
-	QDomNodeList elements = elementsByTagName("Midicontroller");
-	for(int i = 0; i < elements.length(); i++)
+	for (const char* attrName : attributesToUpdate)
 	{
-		if (elements.item(i).isNull()) { continue; }
-		auto element = elements.item(i).toElement();
-		for (const char* attrName : attributesToUpdate)
+		if (element.hasAttribute(attrName))
 		{
-			if (element.hasAttribute(attrName))
-			{
-				int cc = element.attribute(attrName).toInt();
-				element.setAttribute(attrName, cc - 1);
-			}
+			int cc = element.attribute(attrName).toInt();
+			element.setAttribute(attrName, cc - 1);
 		}
 	}
 }
 
-void DataFile::findProblematicLadspaPlugins()
+void DataFile::findProblematicLadspaPlugins(QDomElement& ladspacontrol)
 {
 	// This is not an upgrade but a check for potentially problematic LADSPA
-	// controls. See #5738 for more details.
+	// controls. See #5738 for more details. The warning is shown by upgrade().
 
-	const QDomNodeList ladspacontrols = elementsByTagName("ladspacontrols");
-
-	uint numberOfProblematicPlugins = 0;
-
-	for (int i = 0; i < ladspacontrols.size(); ++i)
+	const auto attributes = ladspacontrol.attributes();
+	for (int j = 0; j < attributes.length(); ++j)
 	{
-		const QDomElement ladspacontrol = ladspacontrols.item(i).toElement();
-
-		const auto attributes = ladspacontrol.attributes();
-		for (int j = 0; j < attributes.length(); ++j)
+		const auto attribute = attributes.item(j);
+		const auto name = attribute.nodeName();
+		if (name != "ports" && name.startsWith("port"))
 		{
-			const auto attribute = attributes.item(j);
-			const auto name = attribute.nodeName();
-			if (name != "ports" && name.startsWith("port"))
-			{
-				++numberOfProblematicPlugins;
-				break;
-			}
+			++m_problematicLadspaPlugins;
+			break;
 		}
 	}
-
-	if (numberOfProblematicPlugins > 0)
-	{
-		QMessageBox::warning(nullptr, QObject::tr("LADSPA plugins"),
-			QObject::tr("The project contains %1 LADSPA plugin(s) which might have not been restored correctly! Please check the project.").arg(numberOfProblematicPlugins));
-	}
 }
 
-void DataFile::upgrade_fixBassLoopsTypo()
+void DataFile::upgrade_fixBassLoopsTypo(QDomElement& element)
 {
 	static const QMap<QString, QString> replacementMap = {
 		{ "bassloopes/briff01.ogg", "bassloops/briff01 - 140 BPM.ogg" },
@@ -2081,19 +2008,91 @@ void DataFile::upgrade_fixBassLoopsTypo()
 		{ "bassloopes/techno_synth04.ogg", "bassloops/techno_synth04 - 140 BPM.ogg" }
 	};
 
-	mapSrcAttributeInElementsWithResources(replacementMap);
+	mapSrcAttributeInElementWithResources(element, replacementMap);
+}
+
+void DataFile::upgradeElements(std::size_t first, std::size_t last)
+{
+	// Indices of the upgrades in [first, last] for each tag name, in ascending order
+	QHash<QString, std::vector<std::size_t>> upgradesByTagName;
+	for (std::size_t i = first; i <= last; ++i)
+	{
+		for (const auto& tagName : UPGRADE_METHODS[i].tagNames)
+		{
+			upgradesByTagName[tagName].push_back(i);
+		}
+	}
+
+	// Pre-order traversal: an element is upgraded before its descendants, just like
+	// it would be by running the upgrades one after another over the whole document
+	QDomElement element = documentElement();
+	while (!element.isNull())
+	{
+		// Upgrades may rename the element, so look up the remaining ones by its current name
+		std::size_t next = first;
+		while (next <= last)
+		{
+			const auto upgrades = upgradesByTagName.constFind(element.tagName());
+			if (upgrades == upgradesByTagName.constEnd()) { break; }
+
+			const auto upgrade = std::lower_bound(upgrades->begin(), upgrades->end(), next);
+			if (upgrade == upgrades->end()) { break; }
+
+			(this->*UPGRADE_METHODS[*upgrade].elementMethod)(element);
+			next = *upgrade + 1;
+		}
+
+		QDomElement following = element.firstChildElement();
+		while (following.isNull() && !element.isNull())
+		{
+			following = element.nextSiblingElement();
+			element = element.parentNode().toElement();
+		}
+		element = following;
+	}
 }
 
+
+
+
 void DataFile::upgrade()
 {
-	// Runs all necessary upgrade methods
-	std::size_t max = std::min(static_cast<std::size_t>(m_fileVersion), UPGRADE_METHODS.size());
-	std::for_each( UPGRADE_METHODS.begin() + max, UPGRADE_METHODS.end(),
-		[this](UpgradeMethod um)
+	// Runs all necessary upgrade methods. Consecutive element upgrades share one traversal of the
+	// document, while document upgrades (which need to see all of it at once) run on their own.
+	m_problematicLadspaPlugins = 0;
+	std::size_t i = std::min(static_cast<std::size_t>(m_fileVersion), UPGRADE_METHODS.size());
+	while (i < UPGRADE_METHODS.size())
+	{
+		if (UPGRADE_METHODS[i].documentMethod)
 		{
-			(this->*um)();
+			(this->*UPGRADE_METHODS[i].documentMethod)();
+			++i;
+			continue;
+		}
+
+		std::size_t last = i;
+		while (last + 1 < UPGRADE_METHODS.size() && UPGRADE_METHODS[last + 1].elementMethod)
+		{
+			++last;
+		}
+		upgradeElements(i, last);
+		i = last + 1;
+	}
+
+	// See #5738 for more details
+	if (m_problematicLadspaPlugins > 0)
+	{
+		const auto message = QObject::tr("The project contains %1 LADSPA plugin(s) which might have not been "
+			"restored correctly! Please check the project.").arg(m_problematicLadspaPlugins);
+		if (gui::getGUI() != nullptr)
+		{
+			QMessageBox::warning(nullptr, QObject::tr("LADSPA plugins"), message);
 		}
-	);
+		else
+		{
+			qWarning() << message;
+		}
+	}
 
 	// Bump the file version (which should be the size of the upgrade methods vector)
 	m_fileVersion = UPGRADE_METHODS.size();
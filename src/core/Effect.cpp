@@ -33,6 +33,7 @@
 #include "EffectControls.h"
 #include "EffectView.h"
 #include "SampleFrame.h"
+#include "Tracer.h"
 
 namespace lmms
 {
@@ -94,6 +95,9 @@ void Effect::loadSettings( const QDomElement & _this )
 
 bool Effect::processAudioBuffer(AudioBuffer& inOut)
 {
+	AudioEngineProfiler::NodeProbe profilerProbe(m_profilerNode);
+	Tracer::Scope traceScope("Effect", descriptor()->displayName);
+
 	if (!isAwake())
 	{
 		if (!inOut.hasSignal(0b11))
@@ -117,10 +121,24 @@ bool Effect::processAudioBuffer(AudioBuffer& inOut)
 		return false;
 	}
 
-	const auto status = processImpl(inOut.interleavedBuffer().asSampleFrames().data(), inOut.frames());
-
-	// Copy interleaved plugin output to planar
-	toPlanar(inOut.interleavedBuffer(), inOut.groupBuffers(0));
+	ProcessStatus status;
+	if (processesPlanar())
+	{
+		status = static_cast<PlanarEffect*>(this)->processPlanarImpl({inOut.group(0).buffers(), inOut.frames()});
+		inOut.setInterleavedInSync(false);
+	}
+	else
+	{
+		// Legacy effects work on the interleaved scratch buffer. It still holds the output of the
+		// previous legacy effect unless something wrote to the planar buffers since then.
+		if (!inOut.interleavedInSync())
+		{
+			toInterleaved(inOut.groupBuffers(0), inOut.interleavedBuffer());
+		}
+		status = processImpl(inOut.interleavedBuffer().asSampleFrames().data(), inOut.frames());
+		toPlanar(inOut.interleavedBuffer(), inOut.groupBuffers(0));
+		inOut.setInterleavedInSync(true);
+	}
 
 	const auto sanitized = Engine::audioEngine()->sanitizationEnabled() ? inOut.sanitize(0b11) : false;
 	m_corrupted.store(sanitized, std::memory_order_relaxed);
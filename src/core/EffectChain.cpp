@@ -121,6 +121,8 @@ void EffectChain::loadSettings( const QDomElement & _this )
 
 void EffectChain::appendEffect( Effect * _effect )
 {
+	_effect->m_profilerNode.setName(_effect->displayName());
+
 	Engine::audioEngine()->requestChangeInModel();
 	m_effects.push_back(_effect);
 	Engine::audioEngine()->doneChangeInModel();
@@ -191,6 +193,9 @@ bool EffectChain::processAudioBuffer(AudioBuffer& buffer)
 		return false;
 	}
 
+	// The planar buffers were mixed into since the last time the chain ran
+	buffer.setInterleavedInSync(false);
+
 	bool moreEffects = false;
 	for (Effect* effect : m_effects)
 	{
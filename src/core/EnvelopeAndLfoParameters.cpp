@@ -24,6 +24,9 @@
 
 #include "EnvelopeAndLfoParameters.h"
 
+#include <limits>
+#include <thread>
+
 #include <QDomElement>
 #include <QFileInfo>
 
@@ -49,11 +52,10 @@ EnvelopeAndLfoParameters::LfoInstances * EnvelopeAndLfoParameters::s_lfoInstance
 
 void EnvelopeAndLfoParameters::LfoInstances::trigger()
 {
-	QMutexLocker m( &m_lfoListMutex );
 	for (const auto& lfo : m_lfos)
 	{
 		lfo->m_lfoFrame += Engine::audioEngine()->framesPerPeriod();
-		lfo->m_bad_lfoShapeData = true;
+		lfo->startPeriod();
 	}
 }
 
@@ -62,11 +64,10 @@ void EnvelopeAndLfoParameters::LfoInstances::trigger()
 
 void EnvelopeAndLfoParameters::LfoInstances::reset()
 {
-	QMutexLocker m( &m_lfoListMutex );
 	for (const auto& lfo : m_lfos)
 	{
 		lfo->m_lfoFrame = 0;
-		lfo->m_bad_lfoShapeData = true;
+		lfo->updateLfoShapeData();
 	}
 }
 
@@ -75,7 +76,7 @@ void EnvelopeAndLfoParameters::LfoInstances::reset()
 
 void EnvelopeAndLfoParameters::LfoInstances::add( EnvelopeAndLfoParameters * lfo )
 {
-	QMutexLocker m( &m_lfoListMutex );
+	const auto guard = Engine::audioEngine()->requestChangesGuard();
 	m_lfos.append( lfo );
 }
 
@@ -84,8 +85,11 @@ void EnvelopeAndLfoParameters::LfoInstances::add( EnvelopeAndLfoParameters * lfo
 
 void EnvelopeAndLfoParameters::LfoInstances::remove( EnvelopeAndLfoParameters * lfo )
 {
-	QMutexLocker m( &m_lfoListMutex );
+	// the audio engine may be gone already when the song is destroyed
+	const auto audioEngine = Engine::audioEngine();
+	if (audioEngine) { audioEngine->requestChangeInModel(); }
 	m_lfos.removeAll( lfo );
+	if (audioEngine) { audioEngine->doneChangeInModel(); }
 }
 
 
@@ -106,10 +110,6 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 	m_valueForZeroAmount( _value_for_zero_amount ),
 	m_pahdFrames( 0 ),
 	m_rFrames( 0 ),
-	m_pahdEnv( nullptr ),
-	m_rEnv( nullptr ),
-	m_pahdBufSize( 0 ),
-	m_rBufSize( 0 ),
 	m_lfoPredelayModel(0.f, 0.f, 1.f, 0.001f, this, tr("LFO pre-delay")),
 	m_lfoAttackModel(0.f, 0.f, 1.f, 0.001f, this, tr("LFO attack")),
 	m_lfoSpeedModel(0.1f, 0.001f, 1.f, 0.0001f,
@@ -120,19 +120,13 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 	m_x100Model( false, this, tr( "LFO frequency x 100" ) ),
 	m_controlEnvAmountModel( false, this, tr( "Modulate env amount" ) ),
 	m_lfoFrame( 0 ),
-	m_lfoAmountIsZero( false ),
-	m_lfoShapeData(nullptr)
+	m_lfoShapeData(Engine::audioEngine()->framesPerPeriod()),
+	m_random( 0.0f ),
+	m_randomCycle( std::numeric_limits<f_cnt_t>::max() )
 {
 	m_amountModel.setCenterValue( 0 );
 	m_lfoAmountModel.setCenterValue( 0 );
 
-	if( s_lfoInstances == nullptr )
-	{
-		s_lfoInstances = new LfoInstances();
-	}
-
-	instances()->add( this );
-
 	connect( &m_predelayModel, SIGNAL(dataChanged()),
 			this, SLOT(updateSampleVars()), Qt::DirectConnection );
 	connect( &m_attackModel, SIGNAL(dataChanged()),
@@ -160,15 +154,22 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 			this, SLOT(updateSampleVars()), Qt::DirectConnection );
 	connect( &m_x100Model, SIGNAL(dataChanged()),
 			this, SLOT(updateSampleVars()), Qt::DirectConnection );
+	connect( &m_controlEnvAmountModel, SIGNAL(dataChanged()),
+			this, SLOT(updateSampleVars()), Qt::DirectConnection );
 
 	connect( Engine::audioEngine(), SIGNAL(sampleRateChanged()),
 				this, SLOT(updateSampleVars()));
 
+	updateSampleVars();
+	startPeriod();
 
-	m_lfoShapeData =
-		new sample_t[Engine::audioEngine()->framesPerPeriod()];
+	// only now the audio thread may start a period for us
+	if( s_lfoInstances == nullptr )
+	{
+		s_lfoInstances = new LfoInstances();
+	}
 
-	updateSampleVars();
+	instances()->add( this );
 }
 
 
@@ -189,10 +190,7 @@ EnvelopeAndLfoParameters::~EnvelopeAndLfoParameters()
 	m_lfoAmountModel.disconnect( this );
 	m_lfoWaveModel.disconnect( this );
 	m_x100Model.disconnect( this );
-
-	delete[] m_pahdEnv;
-	delete[] m_rEnv;
-	delete[] m_lfoShapeData;
+	m_controlEnvAmountModel.disconnect( this );
 
 	instances()->remove( this );
 
@@ -208,11 +206,12 @@ EnvelopeAndLfoParameters::~EnvelopeAndLfoParameters()
 
 inline sample_t EnvelopeAndLfoParameters::lfoShapeSample( f_cnt_t _frame_offset )
 {
-	f_cnt_t frame = ( m_lfoFrame + _frame_offset ) % m_lfoOscillationFrames;
+	const Snapshot& params = m_periodSnapshot;
+	f_cnt_t frame = ( m_lfoFrame + _frame_offset ) % params.lfoOscillationFrames;
 	const float phase = frame / static_cast<float>(
-						m_lfoOscillationFrames );
+						params.lfoOscillationFrames );
 	sample_t shape_sample;
-	switch( static_cast<LfoShape>(m_lfoWaveModel.value())  )
+	switch( params.lfoShape )
 	{
 		case LfoShape::TriangleWave:
 			shape_sample = Oscillator::triangleSample( phase );
@@ -224,21 +223,26 @@ inline sample_t EnvelopeAndLfoParameters::lfoShapeSample( f_cnt_t _frame_offset
 			shape_sample = Oscillator::sawSample( phase );
 			break;
 		case LfoShape::UserDefinedWave:
-			shape_sample = Oscillator::userWaveSample(m_userWave.get(), phase);
+			shape_sample = Oscillator::userWaveSample(params.userWave, phase);
 			break;
 		case LfoShape::RandomWave:
-			if( frame == 0 )
+		{
+			// the shape is only sampled every few frames, so the start of an oscillation may be skipped
+			const f_cnt_t cycle = ( m_lfoFrame + _frame_offset ) / params.lfoOscillationFrames;
+			if( cycle != m_randomCycle )
 			{
 				m_random = Oscillator::noiseSample( 0.0f );
+				m_randomCycle = cycle;
 			}
 			shape_sample = m_random;
 			break;
+		}
 		case LfoShape::SineWave:
 		default:
 			shape_sample = Oscillator::sinSample( phase );
 			break;
 	}
-	return shape_sample * m_lfoAmount;
+	return shape_sample * params.lfoAmount;
 }
 
 
@@ -246,47 +250,152 @@ inline sample_t EnvelopeAndLfoParameters::lfoShapeSample( f_cnt_t _frame_offset
 
 void EnvelopeAndLfoParameters::updateLfoShapeData()
 {
-	const f_cnt_t frames = Engine::audioEngine()->framesPerPeriod();
-	for( f_cnt_t offset = 0; offset < frames; ++offset )
+	if( m_periodSnapshot.lfoAmountIsZero )
+	{
+		return;
+	}
+
+	// the shape is evaluated at control rate and shared by all notes during the period
+	const auto frames = static_cast<f_cnt_t>( m_lfoShapeData.size() );
+	sample_t from = lfoShapeSample( 0 );
+	for( f_cnt_t start = 0; start < frames; start += ControlRateFrames )
 	{
-		m_lfoShapeData[offset] = lfoShapeSample( offset );
+		const f_cnt_t end = std::min( start + ControlRateFrames, frames );
+		const sample_t to = lfoShapeSample( end );
+		const float step = ( to - from ) / ( end - start );
+		for( f_cnt_t offset = start; offset < end; ++offset )
+		{
+			m_lfoShapeData[offset] = from + step * ( offset - start );
+		}
+		from = to;
 	}
-	m_bad_lfoShapeData = false;
 }
 
 
 
 
-inline void EnvelopeAndLfoParameters::fillLfoLevel( float * _buf,
-							f_cnt_t _frame,
-							const f_cnt_t _frames )
+bool EnvelopeAndLfoParameters::tryReadSnapshot(Snapshot& params) const
+{
+	// A sequence lock: the copy is only used if no write began or ended meanwhile. The audio
+	// thread then rather keeps the previous parameters for another period than waiting.
+	const auto sequence = m_snapshotSequence.load(std::memory_order_acquire);
+	if (sequence & 1) { return false; }
+
+	const auto copy = m_snapshot;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (m_snapshotSequence.load(std::memory_order_relaxed) != sequence) { return false; }
+
+	params = copy;
+	return true;
+}
+
+
+
+
+EnvelopeAndLfoParameters::Snapshot EnvelopeAndLfoParameters::snapshot() const
 {
-	if( m_lfoAmountIsZero || _frame <= m_lfoPredelayFrames )
+	auto params = Snapshot{};
+	while (!tryReadSnapshot(params)) { std::this_thread::yield(); }
+	return params;
+}
+
+
+
+
+void EnvelopeAndLfoParameters::publishSnapshot()
+{
+	// Parameters may change on any thread, including the audio threads, so instead of waiting for
+	// another thread that is publishing, that thread is told to compute the parameters once more
+	m_snapshotOutdated.store(true);
+	auto sequence = m_snapshotSequence.load();
+	while (m_snapshotOutdated.load())
 	{
-		for( f_cnt_t offset = 0; offset < _frames; ++offset )
-		{
-			*_buf++ = 0.0f;
-		}
-		return;
+		if (sequence & 1) { return; }
+		if (!m_snapshotSequence.compare_exchange_weak(sequence, sequence + 1)) { continue; }
+
+		m_snapshotOutdated.store(false);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_snapshot = computeSnapshot();
+
+		// sequentially consistent, so either the loop condition sees a change flagged meanwhile,
+		// or the thread flagging it sees that nobody is publishing anymore
+		sequence += 2;
+		m_snapshotSequence.store(sequence);
 	}
-	_frame -= m_lfoPredelayFrames;
+}
+
+
+
+
+void EnvelopeAndLfoParameters::setUserWave(std::shared_ptr<const SampleBuffer> wave)
+{
+	const auto guard = Engine::audioEngine()->requestChangesGuard();
+	m_userWave.swap(wave);
+	updateSampleVars();
+	m_periodSnapshot = snapshot();
+	// the previous wave is freed with the parameter, no snapshot refers to it anymore
+}
+
+
+
+
+void EnvelopeAndLfoParameters::startPeriod()
+{
+	tryReadSnapshot(m_periodSnapshot);
+	updateLfoShapeData();
+}
+
+
+
+
+inline float EnvelopeAndLfoParameters::pahdLevel( const Snapshot& params, f_cnt_t frame )
+{
+	if( frame < params.predelayFrames ) { return params.predelayLevel; }
+	frame -= params.predelayFrames;
+	if( frame < params.attackFrames ) { return frame * params.attackStep + params.predelayLevel; }
+	frame -= params.attackFrames;
+	if( frame < params.holdFrames ) { return params.holdLevel; }
+	frame -= params.holdFrames;
+	if( frame < params.decayFrames ) { return params.holdLevel + frame * params.decayStep; }
+	return params.sustainLevel;
+}
+
 
-	if( m_bad_lfoShapeData )
+
+
+inline float EnvelopeAndLfoParameters::levelAt( f_cnt_t frame, f_cnt_t releaseBegin, f_cnt_t offset ) const
+{
+	const Snapshot& params = m_periodSnapshot;
+
+	float env_level;
+	if( frame < releaseBegin )
 	{
-		updateLfoShapeData();
+		env_level = pahdLevel( params, frame );
 	}
-
-	f_cnt_t offset = 0;
-	const float lafI = 1.0f / std::max(minimumFrames, m_lfoAttackFrames);
-	for( ; offset < _frames && _frame < m_lfoAttackFrames; ++offset,
-								++_frame )
+	else if( ( frame - releaseBegin ) < params.releaseFrames )
 	{
-		*_buf++ = m_lfoShapeData[offset] * _frame * lafI;
+		env_level = static_cast<float>( params.releaseFrames - ( frame - releaseBegin ) ) * params.releaseStep *
+			pahdLevel( params, releaseBegin );
 	}
-	for( ; offset < _frames; ++offset )
+	else
 	{
-		*_buf++ = m_lfoShapeData[offset];
+		env_level = 0.0f;
 	}
+
+	float lfo_level = 0.0f;
+	if( !params.lfoAmountIsZero && frame > params.lfoPredelayFrames )
+	{
+		const f_cnt_t lfoFrame = frame - params.lfoPredelayFrames;
+		lfo_level = m_lfoShapeData[offset];
+		if( lfoFrame < params.lfoAttackFrames )
+		{
+			lfo_level *= lfoFrame / static_cast<float>( params.lfoAttackFrames );
+		}
+	}
+
+	return params.controlEnvAmount ?
+		env_level * ( 0.5f + lfo_level ) :
+		env_level + lfo_level;
 }
 
 
@@ -296,39 +405,27 @@ void EnvelopeAndLfoParameters::fillLevel( float * _buf, f_cnt_t _frame,
 						const f_cnt_t _release_begin,
 						const f_cnt_t _frames )
 {
-	QMutexLocker m(&m_paramMutex);
-
-	fillLfoLevel( _buf, _frame, _frames );
+	if( _frames == 0 )
+	{
+		return;
+	}
 
-	for( f_cnt_t offset = 0; offset < _frames; ++offset, ++_buf, ++_frame )
+	// evaluate at control rate and interpolate linearly in between
+	float from = levelAt( _frame, _release_begin, 0 );
+	_buf[0] = from;
+	for( f_cnt_t start = 0; start < _frames - 1; )
 	{
-		float env_level;
-		if( _frame < _release_begin )
+		const f_cnt_t end = std::min( start + ControlRateFrames, _frames - 1 );
+		const float to = levelAt( _frame + end, _release_begin, end );
+		const float step = ( to - from ) / ( end - start );
+		for( f_cnt_t offset = start + 1; offset < end; ++offset )
 		{
-			if( _frame < m_pahdFrames )
-			{
-				env_level = m_pahdEnv[_frame];
-			}
-			else
-			{
-				env_level = m_sustainLevel;
-			}
-		}
-		else if( ( _frame - _release_begin ) < m_rFrames )
-		{
-			env_level = m_rEnv[_frame - _release_begin] *
-				( ( _release_begin < m_pahdFrames ) ?
-				m_pahdEnv[_release_begin] : m_sustainLevel );
-		}
-		else
-		{
-			env_level = 0.0f;
+			_buf[offset] = from + step * ( offset - start );
 		}
+		_buf[end] = to;
 
-		// at this point, *_buf is LFO level
-		*_buf = m_controlEnvAmountModel.value() ?
-			env_level * ( 0.5f + *_buf ) :
-			env_level + *_buf;
+		from = to;
+		start = end;
 	}
 }
 
@@ -388,7 +485,7 @@ void EnvelopeAndLfoParameters::loadSettings( const QDomElement & _this )
 	{
 		if (QFileInfo(PathUtil::toAbsolute(userWaveFile)).exists())
 		{
-			m_userWave = SampleBuffer::fromFile(_this.attribute("userwavefile"));
+			setUserWave(SampleBuffer::fromFile(_this.attribute("userwavefile")));
 		}
 		else { Engine::getSong()->collectError(QString("%1: %2").arg(tr("Sample not found"), userWaveFile)); }  
 	}
@@ -401,7 +498,19 @@ void EnvelopeAndLfoParameters::loadSettings( const QDomElement & _this )
 
 void EnvelopeAndLfoParameters::updateSampleVars()
 {
-	QMutexLocker m(&m_paramMutex);
+	publishSnapshot();
+
+	emit dataChanged();
+}
+
+
+
+
+EnvelopeAndLfoParameters::Snapshot EnvelopeAndLfoParameters::computeSnapshot()
+{
+	// Build the parameters from scratch and publish them at once, so the audio
+	// thread never sees them half-updated
+	auto params = Snapshot{};
 
 	const float frames_per_env_seg = SECS_PER_ENV_SEGMENT *
 				Engine::audioEngine()->outputSampleRate();
@@ -420,121 +529,71 @@ void EnvelopeAndLfoParameters::updateSampleVars()
 					expKnobVal(m_decayModel.value() *
 					(1 - m_sustainModel.value()))));
 
-	m_sustainLevel = m_sustainModel.value();
-	m_amount = m_amountModel.value();
-	if( m_amount >= 0 )
-	{
-		m_amountAdd = ( 1.0f - m_amount ) * m_valueForZeroAmount;
-	}
-	else
-	{
-		m_amountAdd = m_valueForZeroAmount;
-	}
+	const float sustainLevel = m_sustainModel.value();
+	const float amount = m_amountModel.value();
+	const float amountAdd = amount >= 0
+		? ( 1.0f - amount ) * m_valueForZeroAmount
+		: m_valueForZeroAmount;
 
-	m_pahdFrames = predelay_frames + attack_frames + hold_frames +
+	const f_cnt_t pahdFrames = predelay_frames + attack_frames + hold_frames +
 								decay_frames;
-	m_rFrames = static_cast<f_cnt_t>( frames_per_env_seg *
+	f_cnt_t rFrames = static_cast<f_cnt_t>( frames_per_env_seg *
 					expKnobVal( m_releaseModel.value() ) );
-	m_rFrames = std::max(minimumFrames, m_rFrames);
-
-	if( static_cast<int>( floorf( m_amount * 1000.0f ) ) == 0 )
-	{
-		m_rFrames = minimumFrames;
-	}
-
-	// if the buffers are too small, make bigger ones - so we only alloc new memory when necessary
-	if( m_pahdBufSize < m_pahdFrames )
-	{
-		sample_t * tmp = m_pahdEnv;
-		m_pahdEnv = new sample_t[m_pahdFrames];
-		delete[] tmp;
-		m_pahdBufSize = m_pahdFrames;
-	}
-	if( m_rBufSize < m_rFrames )
-	{
-		sample_t * tmp = m_rEnv;
-		m_rEnv = new sample_t[m_rFrames];
-		delete[] tmp;
-		m_rBufSize = m_rFrames;
-	}
-
-	const float aa = m_amountAdd;
-	for( f_cnt_t i = 0; i < predelay_frames; ++i )
-	{
-		m_pahdEnv[i] = aa;
-	}
-
-	f_cnt_t add = predelay_frames;
+	rFrames = std::max(minimumFrames, rFrames);
 
-	const float afI = ( 1.0f / attack_frames ) * m_amount;
-	for( f_cnt_t i = 0; i < attack_frames; ++i )
+	if( static_cast<int>( floorf( amount * 1000.0f ) ) == 0 )
 	{
-		m_pahdEnv[add+i] = i * afI + aa;
+		rFrames = minimumFrames;
 	}
 
-	add += attack_frames;
-	const float amsum = m_amount + m_amountAdd;
-	for( f_cnt_t i = 0; i < hold_frames; ++i )
-	{
-		m_pahdEnv[add + i] = amsum;
-	}
-
-	add += hold_frames;
-	const float dfI = ( 1.0 / decay_frames ) * ( m_sustainLevel -1 ) * m_amount;
-	for( f_cnt_t i = 0; i < decay_frames; ++i )
-	{
-/*
-		m_pahdEnv[add + i] = ( m_sustainLevel + ( 1.0f -
-						(float)i / decay_frames ) *
-						( 1.0f - m_sustainLevel ) ) *
-							m_amount + m_amountAdd;
-*/
-		m_pahdEnv[add + i] = amsum + i*dfI;
-	}
+	// the stages are linear, see pahdLevel() and levelAt()
+	params.predelayFrames = predelay_frames;
+	params.attackFrames = attack_frames;
+	params.holdFrames = hold_frames;
+	params.decayFrames = decay_frames;
+	params.releaseFrames = rFrames;
 
-	const float rfI = ( 1.0f / m_rFrames ) * m_amount;
-	for( f_cnt_t i = 0; i < m_rFrames; ++i )
-	{
-		m_rEnv[i] = (float)( m_rFrames - i ) * rfI;
-	}
+	params.predelayLevel = amountAdd;
+	params.attackStep = ( 1.0f / attack_frames ) * amount;
+	params.holdLevel = amount + amountAdd;
+	params.decayStep = ( 1.0 / decay_frames ) * ( sustainLevel -1 ) * amount;
+	params.releaseStep = ( 1.0f / rFrames ) * amount;
 
 	// save this calculation in real-time-part
-	m_sustainLevel = m_sustainLevel * m_amount + m_amountAdd;
+	params.sustainLevel = sustainLevel * amount + amountAdd;
+	params.controlEnvAmount = m_controlEnvAmountModel.value();
 
 
 	const float frames_per_lfo_oscillation = SECS_PER_LFO_OSCILLATION *
 				Engine::audioEngine()->outputSampleRate();
-	m_lfoPredelayFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
+	params.lfoPredelayFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
 				expKnobVal( m_lfoPredelayModel.value() ) );
-	m_lfoAttackFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
+	params.lfoAttackFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
 				expKnobVal( m_lfoAttackModel.value() ) );
-	m_lfoOscillationFrames = static_cast<f_cnt_t>(
+	params.lfoOscillationFrames = static_cast<f_cnt_t>(
 						frames_per_lfo_oscillation *
 						m_lfoSpeedModel.value() );
 	if( m_x100Model.value() )
 	{
-		m_lfoOscillationFrames /= 100;
+		params.lfoOscillationFrames /= 100;
 	}
-	m_lfoAmount = m_lfoAmountModel.value() * 0.5f;
-
-	m_used = true;
-	if( static_cast<int>( floorf( m_lfoAmount * 1000.0f ) ) == 0 )
-	{
-		m_lfoAmountIsZero = true;
-		if( static_cast<int>( floorf( m_amount * 1000.0f ) ) == 0 )
-		{
-			m_used = false;
-		}
-	}
-	else
+	params.lfoOscillationFrames = std::max(minimumFrames, params.lfoOscillationFrames);
+	params.lfoAmount = m_lfoAmountModel.value() * 0.5f;
+	params.lfoShape = static_cast<LfoShape>( m_lfoWaveModel.value() );
+	params.userWave = m_userWave.get();
+
+	bool used = true;
+	params.lfoAmountIsZero = static_cast<int>( floorf( params.lfoAmount * 1000.0f ) ) == 0;
+	if( params.lfoAmountIsZero && static_cast<int>( floorf( amount * 1000.0f ) ) == 0 )
 	{
-		m_lfoAmountIsZero = false;
+		used = false;
 	}
 
-	m_bad_lfoShapeData = true;
-
-	emit dataChanged();
+	m_pahdFrames = pahdFrames;
+	m_rFrames = rFrames;
+	m_used = used;
 
+	return params;
 }
 
 
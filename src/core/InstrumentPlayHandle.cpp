@@ -24,6 +24,7 @@
 
 
 #include "InstrumentPlayHandle.h"
+#include "AudioBusHandle.h"
 #include "Instrument.h"
 #include "InstrumentTrack.h"
 #include "Engine.h"
@@ -62,6 +63,8 @@ void InstrumentPlayHandle::play(SampleFrame* working_buffer)
 	}
 	while (nphsLeft);
 
+	AudioEngineProfiler::NodeProbe profilerProbe(audioBusHandle()->profilerNode());
+
 	m_instrument->play(working_buffer);
 
 	// Process the audio buffer that the instrument has just worked on...
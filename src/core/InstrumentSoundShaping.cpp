@@ -22,6 +22,8 @@
  *
  */
 
+#include <algorithm>
+
 #include <QVarLengthArray>
 #include <QDomElement>
 
@@ -39,7 +41,6 @@ namespace lmms
 
 const float CUT_FREQ_MULTIPLIER = 6000.0f;
 const float RES_MULTIPLIER = 2.0f;
-const float RES_PRECISION = 1000.0f;
 
 
 InstrumentSoundShaping::InstrumentSoundShaping(
@@ -118,12 +119,6 @@ void InstrumentSoundShaping::processAudioBuffer( SampleFrame* buffer,
 		envReleaseBegin += frames;
 	}
 
-	// because of optimizations, there's special code for several cases:
-	// 	- cut- and res-lfo/envelope active
-	// 	- cut-lfo/envelope active
-	// 	- res-lfo/envelope active
-	//	- no lfo/envelope active but filter is used
-
 	// only use filter, if it is really needed
 
 	auto& cutoffParameters = getCutoffParameters();
@@ -131,94 +126,54 @@ void InstrumentSoundShaping::processAudioBuffer( SampleFrame* buffer,
 
 	if( m_filterEnabledModel.value() )
 	{
-		QVarLengthArray<float> cutBuffer(frames);
-		QVarLengthArray<float> resBuffer(frames);
-
-		int old_filter_cut = 0;
-		int old_filter_res = 0;
-
 		if( n->m_filter == nullptr )
 		{
 			n->m_filter = std::make_unique<BasicFilters<>>( Engine::audioEngine()->outputSampleRate() );
 		}
 		n->m_filter->setFilterType( static_cast<BasicFilters<>::FilterType>(m_filterModel.value()) );
 
-		if (cutoffParameters.isUsed())
-		{
-			cutoffParameters.fillLevel(cutBuffer.data(), envTotalFrames, envReleaseBegin, frames);
-		}
-
-		if (resonanceParameters.isUsed())
-		{
-			resonanceParameters.fillLevel(resBuffer.data(), envTotalFrames, envReleaseBegin, frames);
-		}
-
 		const float fcv = m_filterCutModel.value();
 		const float frv = m_filterResModel.value();
 
-		if (cutoffParameters.isUsed() && resonanceParameters.isUsed())
+		if (cutoffParameters.isUsed() || resonanceParameters.isUsed())
 		{
-			for( f_cnt_t frame = 0; frame < frames; ++frame )
-			{
-				const float new_cut_val = EnvelopeAndLfoParameters::expKnobVal( cutBuffer[frame] ) *
-								CUT_FREQ_MULTIPLIER + fcv;
-
-				const float new_res_val = frv + RES_MULTIPLIER * resBuffer[frame];
+			// the filter interpolates its coefficients between the values
+			// it picks from these buffers instead of recomputing them per frame
+			QVarLengthArray<float> cutBuffer(frames);
+			QVarLengthArray<float> resBuffer(frames);
 
-				if( static_cast<int>( new_cut_val ) != old_filter_cut ||
-					static_cast<int>( new_res_val*RES_PRECISION ) != old_filter_res )
+			if (cutoffParameters.isUsed())
+			{
+				cutoffParameters.fillLevel(cutBuffer.data(), envTotalFrames, envReleaseBegin, frames);
+				for (f_cnt_t frame = 0; frame < frames; ++frame)
 				{
-					n->m_filter->calcFilterCoeffs( new_cut_val, new_res_val );
-					old_filter_cut = static_cast<int>( new_cut_val );
-					old_filter_res = static_cast<int>( new_res_val*RES_PRECISION );
+					cutBuffer[frame] = EnvelopeAndLfoParameters::expKnobVal(cutBuffer[frame]) * CUT_FREQ_MULTIPLIER + fcv;
 				}
-
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
 			}
-		}
-		else if (cutoffParameters.isUsed())
-		{
-			for( f_cnt_t frame = 0; frame < frames; ++frame )
+			else
 			{
-				float new_cut_val = EnvelopeAndLfoParameters::expKnobVal( cutBuffer[frame] ) *
-								CUT_FREQ_MULTIPLIER + fcv;
+				std::fill(cutBuffer.begin(), cutBuffer.end(), fcv);
+			}
 
-				if( static_cast<int>( new_cut_val ) != old_filter_cut )
+			if (resonanceParameters.isUsed())
+			{
+				resonanceParameters.fillLevel(resBuffer.data(), envTotalFrames, envReleaseBegin, frames);
+				for (f_cnt_t frame = 0; frame < frames; ++frame)
 				{
-					n->m_filter->calcFilterCoeffs( new_cut_val, frv );
-					old_filter_cut = static_cast<int>( new_cut_val );
+					resBuffer[frame] = frv + RES_MULTIPLIER * resBuffer[frame];
 				}
-
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
 			}
-		}
-		else if(resonanceParameters.isUsed() )
-		{
-			for( f_cnt_t frame = 0; frame < frames; ++frame )
+			else
 			{
-				float new_res_val = frv + RES_MULTIPLIER * resBuffer[frame];
-
-				if( static_cast<int>( new_res_val*RES_PRECISION ) != old_filter_res )
-				{
-					n->m_filter->calcFilterCoeffs( fcv, new_res_val );
-					old_filter_res = static_cast<int>( new_res_val*RES_PRECISION );
-				}
-
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
+				std::fill(resBuffer.begin(), resBuffer.end(), frv);
 			}
+
+			n->m_filter->process(buffer, frames, cutBuffer.data(), resBuffer.data());
 		}
 		else
 		{
 			n->m_filter->calcFilterCoeffs( fcv, frv );
-
-			for( f_cnt_t frame = 0; frame < frames; ++frame )
-			{
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
-			}
+			n->m_filter->process(buffer, frames);
 		}
 	}
 
@@ -24,12 +24,23 @@
 
 #include "MixHelpers.h"
 
-#include <algorithm>
-#include <cmath>
+#include <array>
+#include <cassert>
 
+#include "Hardware.h"
+#include "MixHelpersKernels.h"
 #include "ValueBuffer.h"
 #include "SampleFrame.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define LMMS_MIX_HELPERS_SSE2
+	#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+	#define LMMS_MIX_HELPERS_NEON
+	#include <arm_neon.h>
+#endif
+
 namespace lmms::MixHelpers
 {
 
@@ -37,6 +48,88 @@ namespace {
 
 constexpr auto SilenceThreshold = 0.000001f; // -120 dBFS
 
+#ifdef LMMS_MIX_HELPERS_SSE2
+struct Sse2
+{
+	using Vector = __m128;
+	static constexpr std::size_t Width = 4;
+
+	static Vector load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, Vector v) { _mm_storeu_ps(p, v); }
+	static Vector set(float x) { return _mm_set1_ps(x); }
+	static Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+	static Vector mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+
+	static Vector loadFrameCoeffs(const float* p)
+	{
+		// {p0, p1} -> {p0, p0, p1, p1}
+		const auto coeffs = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+		return _mm_unpacklo_ps(coeffs, coeffs);
+	}
+
+	static bool allBelow(Vector v, Vector threshold)
+	{
+		const auto abs = _mm_andnot_ps(_mm_set1_ps(-0.f), v);
+		return _mm_movemask_ps(_mm_cmplt_ps(abs, threshold)) == 0xf;
+	}
+};
+#endif
+
+#ifdef LMMS_MIX_HELPERS_NEON
+struct Neon
+{
+	using Vector = float32x4_t;
+	static constexpr std::size_t Width = 4;
+
+	static Vector load(const float* p) { return vld1q_f32(p); }
+	static void store(float* p, Vector v) { vst1q_f32(p, v); }
+	static Vector set(float x) { return vdupq_n_f32(x); }
+	static Vector add(Vector a, Vector b) { return vaddq_f32(a, b); }
+	static Vector mul(Vector a, Vector b) { return vmulq_f32(a, b); }
+
+	static Vector loadFrameCoeffs(const float* p)
+	{
+		// {p0, p1} -> {p0, p0, p1, p1}
+		const auto coeffs = vld1_f32(p);
+		const auto zipped = vzip_f32(coeffs, coeffs);
+		return vcombine_f32(zipped.val[0], zipped.val[1]);
+	}
+
+	static bool allBelow(Vector v, Vector threshold)
+	{
+		const auto below = vcltq_f32(vabsq_f32(v), threshold);
+		const auto halves = vand_u32(vget_low_u32(below), vget_high_u32(below));
+		return (vget_lane_u32(halves, 0) & vget_lane_u32(halves, 1)) != 0;
+	}
+};
+#endif
+
+auto kernelsFor(Implementation impl) -> const Kernels*
+{
+	switch (impl)
+	{
+	case Implementation::Scalar: return &scalar::kernels;
+#ifdef LMMS_MIX_HELPERS_SSE2
+	case Implementation::SSE2: return &VectorKernels<Sse2>::kernels;
+#endif
+#if defined(LMMS_HOST_X86_64) || defined(LMMS_HOST_X86)
+	case Implementation::AVX2: return cpuFeatures().avx2 ? &avx2Kernels() : nullptr;
+	case Implementation::AVX512: return cpuFeatures().avx512f ? &avx512Kernels() : nullptr;
+#endif
+#ifdef LMMS_MIX_HELPERS_NEON
+	case Implementation::NEON: return &VectorKernels<Neon>::kernels;
+#endif
+	default: return nullptr;
+	}
+}
+
+// Constant-initialized, so the helpers are usable before the dispatch below has run
+Implementation s_implementation = Implementation::Scalar;
+const Kernels* s_kernels = &scalar::kernels;
+
+inline auto samples(SampleFrame* frames) -> float* { return frames->data(); }
+inline auto samples(const SampleFrame* frames) -> const float* { return frames->data(); }
+
 /*! \brief Function for applying MIXOP on all sample frames */
 template<typename MIXOP>
 inline void run(SampleFrame* dst, const SampleFrame* src, int frames, const MIXOP& OP)
@@ -60,27 +153,48 @@ inline void run(SampleFrame* dst, const sample_t* srcLeft, const sample_t* srcRi
 
 } // namespace
 
-bool isSilent(const SampleFrame* src, int frames)
+std::vector<Implementation> supportedImplementations()
 {
-	return isSilent({&src[0][0], static_cast<std::size_t>(frames * 2)});
+	auto result = std::vector<Implementation>{};
+	for (const auto impl : {Implementation::Scalar, Implementation::NEON, Implementation::SSE2,
+		Implementation::AVX2, Implementation::AVX512})
+	{
+		if (kernelsFor(impl)) { result.push_back(impl); }
+	}
+	return result;
 }
 
-bool isSilent(std::span<const sample_t> buffer)
+Implementation implementation()
 {
-	return std::ranges::all_of(buffer, [&](const sample_t s) { return std::abs(s) < SilenceThreshold; });
+	return s_implementation;
 }
 
-struct AddOp
+bool setImplementation(Implementation impl)
 {
-	void operator()( SampleFrame& dst, const SampleFrame& src ) const
-	{
-		dst += src;
-	}
-} ;
+	const auto kernels = kernelsFor(impl);
+	if (!kernels) { return false; }
+
+	s_implementation = impl;
+	s_kernels = kernels;
+	return true;
+}
+
+// Select the fastest implementation supported by the CPU once at startup
+[[maybe_unused]] static const bool s_dispatched = setImplementation(supportedImplementations().back());
+
+bool isSilent(const SampleFrame* src, int frames)
+{
+	return s_kernels->isSilent(samples(src), SilenceThreshold, static_cast<std::size_t>(frames) * 2);
+}
+
+bool isSilent(std::span<const sample_t> buffer)
+{
+	return s_kernels->isSilent(buffer.data(), SilenceThreshold, buffer.size());
+}
 
 void add( SampleFrame* dst, const SampleFrame* src, int frames )
 {
-	run<>( dst, src, frames, AddOp() );
+	s_kernels->add(samples(dst), samples(src), static_cast<std::size_t>(frames) * 2);
 }
 
 
@@ -89,36 +203,43 @@ void add(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src)
 	assert(dst.channels() == src.channels());
 	assert(dst.frames() == src.frames());
 
-	const auto channels = dst.channels();
-	const auto frames = dst.frames();
-	for (ch_cnt_t channel = 0; channel < channels; ++channel)
+	for (ch_cnt_t channel = 0; channel < dst.channels(); ++channel)
 	{
-		auto* dstPtr = dst.bufferPtr(channel);
-		const auto* srcPtr = src.bufferPtr(channel);
-		for (f_cnt_t frame = 0; frame < frames; ++frame)
-		{
-			dstPtr[frame] += srcPtr[frame];
-		}
+		s_kernels->add(dst.bufferPtr(channel), src.bufferPtr(channel), dst.frames());
 	}
 }
 
 
-struct AddMultipliedOp
+void add(PlanarBufferView<sample_t> dst, InterleavedBufferView<const sample_t, 2> src)
 {
-	AddMultipliedOp( float coeff ) : m_coeff( coeff ) { }
+	assert(dst.channels() == 2);
+	assert(dst.frames() == src.frames());
 
-	void operator()( SampleFrame& dst, const SampleFrame& src ) const
+	auto* left = dst.bufferPtr(0);
+	auto* right = dst.bufferPtr(1);
+	for (f_cnt_t frame = 0; frame < dst.frames(); ++frame)
 	{
-		dst += src * m_coeff;
+		left[frame] += src.framePtr(frame)[0];
+		right[frame] += src.framePtr(frame)[1];
 	}
-
-	const float m_coeff;
-} ;
+}
 
 
 void addMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames )
 {
-	run<>( dst, src, frames, AddMultipliedOp(coeffSrc) );
+	s_kernels->addMultiplied(samples(dst), samples(src), coeffSrc, static_cast<std::size_t>(frames) * 2);
+}
+
+
+void addMultiplied(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src, float coeffSrc)
+{
+	assert(dst.channels() == src.channels());
+	assert(dst.frames() == src.frames());
+
+	for (ch_cnt_t channel = 0; channel < dst.channels(); ++channel)
+	{
+		s_kernels->addMultiplied(dst.bufferPtr(channel), src.bufferPtr(channel), coeffSrc, dst.frames());
+	}
 }
 
 
@@ -137,9 +258,14 @@ struct AddSwappedMultipliedOp
 
 void multiply(SampleFrame* dst, float coeff, int frames)
 {
-	for (int i = 0; i < frames; ++i)
+	s_kernels->multiply(samples(dst), coeff, static_cast<std::size_t>(frames) * 2);
+}
+
+void multiply(PlanarBufferView<sample_t> dst, float coeff)
+{
+	for (ch_cnt_t channel = 0; channel < dst.channels(); ++channel)
 	{
-		dst[i] *= coeff;
+		s_kernels->multiply(dst.bufferPtr(channel), coeff, dst.frames());
 	}
 }
 
@@ -151,21 +277,40 @@ void addSwappedMultiplied( SampleFrame* dst, const SampleFrame* src, float coeff
 
 void addMultipliedByBuffer( SampleFrame* dst, const SampleFrame* src, float coeffSrc, ValueBuffer * coeffSrcBuf, int frames )
 {
-	for( int f = 0; f < frames; ++f )
+	s_kernels->addMultipliedByFrame(samples(dst), samples(src), coeffSrc, coeffSrcBuf->values(),
+		static_cast<std::size_t>(frames));
+}
+
+void addMultipliedByBuffer(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src, float coeffSrc,
+	const ValueBuffer* coeffSrcBuf)
+{
+	assert(dst.channels() == src.channels());
+	assert(dst.frames() == src.frames());
+
+	for (ch_cnt_t channel = 0; channel < dst.channels(); ++channel)
 	{
-		dst[f][0] += src[f][0] * coeffSrc * coeffSrcBuf->values()[f];
-		dst[f][1] += src[f][1] * coeffSrc * coeffSrcBuf->values()[f];
+		s_kernels->addMultipliedByBuffer(dst.bufferPtr(channel), src.bufferPtr(channel), coeffSrc,
+			coeffSrcBuf->values(), dst.frames());
 	}
 }
 
 void addMultipliedByBuffers( SampleFrame* dst, const SampleFrame* src, ValueBuffer * coeffSrcBuf1, ValueBuffer * coeffSrcBuf2, int frames )
 {
-	for( int f = 0; f < frames; ++f )
+	s_kernels->addMultipliedByFrames(samples(dst), samples(src), coeffSrcBuf1->values(), coeffSrcBuf2->values(),
+		static_cast<std::size_t>(frames));
+}
+
+void addMultipliedByBuffers(PlanarBufferView<sample_t> dst, PlanarBufferView<const sample_t> src,
+	const ValueBuffer* coeffSrcBuf1, const ValueBuffer* coeffSrcBuf2)
+{
+	assert(dst.channels() == src.channels());
+	assert(dst.frames() == src.frames());
+
+	for (ch_cnt_t channel = 0; channel < dst.channels(); ++channel)
 	{
-		dst[f][0] += src[f][0] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
-		dst[f][1] += src[f][1] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
+		s_kernels->addMultipliedByBuffers(dst.bufferPtr(channel), src.bufferPtr(channel), coeffSrcBuf1->values(),
+			coeffSrcBuf2->values(), dst.frames());
 	}
-
 }
 
 struct AddMultipliedStereoOp
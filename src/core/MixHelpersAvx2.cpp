@@ -0,0 +1,68 @@
+/*
+ * MixHelpersAvx2.cpp - MixHelpers kernels for AVX2
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+// This file is compiled with AVX2 enabled. Only call into it after checking cpuFeatures().
+
+#include "MixHelpersKernels.h"
+
+#include <immintrin.h>
+
+namespace lmms::MixHelpers
+{
+
+namespace {
+
+struct Avx2
+{
+	using Vector = __m256;
+	static constexpr std::size_t Width = 8;
+
+	static Vector load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, Vector v) { _mm256_storeu_ps(p, v); }
+	static Vector set(float x) { return _mm256_set1_ps(x); }
+	static Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+	static Vector mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+
+	static Vector loadFrameCoeffs(const float* p)
+	{
+		// {p0, ..., p3} -> {p0, p0, p1, p1, p2, p2, p3, p3}
+		const auto coeffs = _mm256_castps128_ps256(_mm_loadu_ps(p));
+		return _mm256_permutevar8x32_ps(coeffs, _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3));
+	}
+
+	static bool allBelow(Vector v, Vector threshold)
+	{
+		const auto abs = _mm256_andnot_ps(_mm256_set1_ps(-0.f), v);
+		return _mm256_movemask_ps(_mm256_cmp_ps(abs, threshold, _CMP_LT_OQ)) == 0xff;
+	}
+};
+
+} // namespace
+
+const Kernels& avx2Kernels()
+{
+	return VectorKernels<Avx2>::kernels;
+}
+
+} // namespace lmms::MixHelpers
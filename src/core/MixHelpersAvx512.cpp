@@ -0,0 +1,69 @@
+/*
+ * MixHelpersAvx512.cpp - MixHelpers kernels for AVX-512
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+// This file is compiled with AVX-512 enabled. Only call into it after checking cpuFeatures().
+
+#include "MixHelpersKernels.h"
+
+#include <immintrin.h>
+
+namespace lmms::MixHelpers
+{
+
+namespace {
+
+struct Avx512
+{
+	using Vector = __m512;
+	static constexpr std::size_t Width = 16;
+
+	static Vector load(const float* p) { return _mm512_loadu_ps(p); }
+	static void store(float* p, Vector v) { _mm512_storeu_ps(p, v); }
+	static Vector set(float x) { return _mm512_set1_ps(x); }
+	static Vector add(Vector a, Vector b) { return _mm512_add_ps(a, b); }
+	static Vector mul(Vector a, Vector b) { return _mm512_mul_ps(a, b); }
+
+	static Vector loadFrameCoeffs(const float* p)
+	{
+		// {p0, ..., p7} -> {p0, p0, p1, p1, ..., p7, p7}
+		const auto coeffs = _mm512_maskz_loadu_ps(0x00ff, p);
+		const auto indices = _mm512_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+		// the zero-masking version avoids a -Wmaybe-uninitialized false positive in GCC's headers
+		return _mm512_maskz_permutexvar_ps(0xffff, indices, coeffs);
+	}
+
+	static bool allBelow(Vector v, Vector threshold)
+	{
+		return _mm512_cmp_ps_mask(_mm512_abs_ps(v), threshold, _CMP_LT_OQ) == 0xffff;
+	}
+};
+
+} // namespace
+
+const Kernels& avx512Kernels()
+{
+	return VectorKernels<Avx512>::kernels;
+}
+
+} // namespace lmms::MixHelpers
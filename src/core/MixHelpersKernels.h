@@ -0,0 +1,262 @@
+/*
+ * MixHelpersKernels.h - SIMD kernels behind the MixHelpers, one set per instruction set
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_MIX_HELPERS_KERNELS_H
+#define LMMS_MIX_HELPERS_KERNELS_H
+
+#include <cstddef>
+
+namespace lmms::MixHelpers
+{
+
+/**
+	Kernels working on contiguous float arrays, so they can be used for
+	interleaved stereo buffers as well as for single planar channels.
+
+	All implementations have to give bit-exact results compared to the scalar
+	one, so they must use the same order of operations and no fused
+	multiply-add.
+*/
+struct Kernels
+{
+	//! dst[i] += src[i]
+	void (*add)(float* dst, const float* src, std::size_t count);
+	//! dst[i] *= coeff
+	void (*multiply)(float* dst, float coeff, std::size_t count);
+	//! dst[i] += src[i] * coeff
+	void (*addMultiplied)(float* dst, const float* src, float coeff, std::size_t count);
+	//! dst[2f + c] += src[2f + c] * coeff * frameCoeffs[f] for interleaved stereo frames
+	void (*addMultipliedByFrame)(float* dst, const float* src, float coeff, const float* frameCoeffs,
+		std::size_t frames);
+	//! dst[2f + c] += src[2f + c] * frameCoeffs1[f] * frameCoeffs2[f] for interleaved stereo frames
+	void (*addMultipliedByFrames)(float* dst, const float* src, const float* frameCoeffs1,
+		const float* frameCoeffs2, std::size_t frames);
+	//! dst[i] += src[i] * coeff * coeffs[i]
+	void (*addMultipliedByBuffer)(float* dst, const float* src, float coeff, const float* coeffs, std::size_t count);
+	//! dst[i] += src[i] * coeffs1[i] * coeffs2[i]
+	void (*addMultipliedByBuffers)(float* dst, const float* src, const float* coeffs1, const float* coeffs2,
+		std::size_t count);
+	//! @returns true if |src[i]| < threshold for all i
+	bool (*isSilent)(const float* src, float threshold, std::size_t count);
+};
+
+// Defined in their own translation units, which are compiled for the respective instruction set.
+// Only call them if the CPU supports it.
+const Kernels& avx2Kernels();
+const Kernels& avx512Kernels();
+
+
+// Everything below is compiled once per instruction set, so it must not be visible
+// to other translation units. Otherwise the linker might pick e.g. an AVX2 version
+// of a function for code running on any CPU.
+namespace
+{
+
+namespace scalar
+{
+
+inline void add(float* dst, const float* src, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i) { dst[i] += src[i]; }
+}
+
+inline void multiply(float* dst, float coeff, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i) { dst[i] *= coeff; }
+}
+
+inline void addMultiplied(float* dst, const float* src, float coeff, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i) { dst[i] += src[i] * coeff; }
+}
+
+inline void addMultipliedByFrame(float* dst, const float* src, float coeff, const float* frameCoeffs,
+	std::size_t frames)
+{
+	for (std::size_t f = 0; f < frames; ++f)
+	{
+		dst[2 * f] += src[2 * f] * coeff * frameCoeffs[f];
+		dst[2 * f + 1] += src[2 * f + 1] * coeff * frameCoeffs[f];
+	}
+}
+
+inline void addMultipliedByFrames(float* dst, const float* src, const float* frameCoeffs1,
+	const float* frameCoeffs2, std::size_t frames)
+{
+	for (std::size_t f = 0; f < frames; ++f)
+	{
+		dst[2 * f] += src[2 * f] * frameCoeffs1[f] * frameCoeffs2[f];
+		dst[2 * f + 1] += src[2 * f + 1] * frameCoeffs1[f] * frameCoeffs2[f];
+	}
+}
+
+inline void addMultipliedByBuffer(float* dst, const float* src, float coeff, const float* coeffs, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i) { dst[i] += src[i] * coeff * coeffs[i]; }
+}
+
+inline void addMultipliedByBuffers(float* dst, const float* src, const float* coeffs1, const float* coeffs2,
+	std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i) { dst[i] += src[i] * coeffs1[i] * coeffs2[i]; }
+}
+
+inline bool isSilent(const float* src, float threshold, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		// written this way so NaNs count as not silent, like in the vectorized versions
+		if (!(src[i] < threshold && -src[i] < threshold)) { return false; }
+	}
+	return true;
+}
+
+constexpr auto kernels = Kernels{
+	&add, &multiply, &addMultiplied, &addMultipliedByFrame, &addMultipliedByFrames,
+	&addMultipliedByBuffer, &addMultipliedByBuffers, &isSilent
+};
+
+} // namespace scalar
+
+
+/**
+	Generic kernels for an instruction set described by @p V, which provides:
+	- `Vector`, holding `Width` floats (an even number)
+	- `load()`, `store()` (unaligned), `set()`, `add()`, `mul()`
+	- `loadFrameCoeffs()`, which loads `Width / 2` values and duplicates each one
+	  to both samples of its frame
+	- `allBelow()`, which returns true if the absolute values of all lanes are below a threshold
+
+	The remainders that don't fill a whole vector are processed by the scalar kernels.
+*/
+template<class V>
+struct VectorKernels
+{
+	static constexpr auto FramesPerVector = V::Width / 2;
+
+	static void add(float* dst, const float* src, std::size_t count)
+	{
+		std::size_t i = 0;
+		for (; i + V::Width <= count; i += V::Width)
+		{
+			V::store(dst + i, V::add(V::load(dst + i), V::load(src + i)));
+		}
+		scalar::add(dst + i, src + i, count - i);
+	}
+
+	static void multiply(float* dst, float coeff, std::size_t count)
+	{
+		const auto c = V::set(coeff);
+		std::size_t i = 0;
+		for (; i + V::Width <= count; i += V::Width)
+		{
+			V::store(dst + i, V::mul(V::load(dst + i), c));
+		}
+		scalar::multiply(dst + i, coeff, count - i);
+	}
+
+	static void addMultiplied(float* dst, const float* src, float coeff, std::size_t count)
+	{
+		const auto c = V::set(coeff);
+		std::size_t i = 0;
+		for (; i + V::Width <= count; i += V::Width)
+		{
+			V::store(dst + i, V::add(V::load(dst + i), V::mul(V::load(src + i), c)));
+		}
+		scalar::addMultiplied(dst + i, src + i, coeff, count - i);
+	}
+
+	static void addMultipliedByFrame(float* dst, const float* src, float coeff, const float* frameCoeffs,
+		std::size_t frames)
+	{
+		const auto c = V::set(coeff);
+		std::size_t f = 0;
+		for (; f + FramesPerVector <= frames; f += FramesPerVector)
+		{
+			const auto product = V::mul(V::mul(V::load(src + 2 * f), c), V::loadFrameCoeffs(frameCoeffs + f));
+			V::store(dst + 2 * f, V::add(V::load(dst + 2 * f), product));
+		}
+		scalar::addMultipliedByFrame(dst + 2 * f, src + 2 * f, coeff, frameCoeffs + f, frames - f);
+	}
+
+	static void addMultipliedByFrames(float* dst, const float* src, const float* frameCoeffs1,
+		const float* frameCoeffs2, std::size_t frames)
+	{
+		std::size_t f = 0;
+		for (; f + FramesPerVector <= frames; f += FramesPerVector)
+		{
+			const auto product = V::mul(V::mul(V::load(src + 2 * f), V::loadFrameCoeffs(frameCoeffs1 + f)),
+				V::loadFrameCoeffs(frameCoeffs2 + f));
+			V::store(dst + 2 * f, V::add(V::load(dst + 2 * f), product));
+		}
+		scalar::addMultipliedByFrames(dst + 2 * f, src + 2 * f, frameCoeffs1 + f, frameCoeffs2 + f, frames - f);
+	}
+
+	static void addMultipliedByBuffer(float* dst, const float* src, float coeff, const float* coeffs,
+		std::size_t count)
+	{
+		const auto c = V::set(coeff);
+		std::size_t i = 0;
+		for (; i + V::Width <= count; i += V::Width)
+		{
+			const auto product = V::mul(V::mul(V::load(src + i), c), V::load(coeffs + i));
+			V::store(dst + i, V::add(V::load(dst + i), product));
+		}
+		scalar::addMultipliedByBuffer(dst + i, src + i, coeff, coeffs + i, count - i);
+	}
+
+	static void addMultipliedByBuffers(float* dst, const float* src, const float* coeffs1, const float* coeffs2,
+		std::size_t count)
+	{
+		std::size_t i = 0;
+		for (; i + V::Width <= count; i += V::Width)
+		{
+			const auto product = V::mul(V::mul(V::load(src + i), V::load(coeffs1 + i)), V::load(coeffs2 + i));
+			V::store(dst + i, V::add(V::load(dst + i), product));
+		}
+		scalar::addMultipliedByBuffers(dst + i, src + i, coeffs1 + i, coeffs2 + i, count - i);
+	}
+
+	static bool isSilent(const float* src, float threshold, std::size_t count)
+	{
+		const auto t = V::set(threshold);
+		std::size_t i = 0;
+		for (; i + V::Width <= count; i += V::Width)
+		{
+			if (!V::allBelow(V::load(src + i), t)) { return false; }
+		}
+		return scalar::isSilent(src + i, threshold, count - i);
+	}
+
+	static constexpr auto kernels = Kernels{
+		&add, &multiply, &addMultiplied, &addMultipliedByFrame, &addMultipliedByFrames,
+		&addMultipliedByBuffer, &addMultipliedByBuffers, &isSilent
+	};
+};
+
+} // namespace
+
+} // namespace lmms::MixHelpers
+
+#endif // LMMS_MIX_HELPERS_KERNELS_H
@@ -25,6 +25,7 @@
 #include "Mixer.h"
 
 #include <QDomElement>
+#include <utility>
 
 #include "AudioEngine.h"
 #include "AudioEngineWorkerThread.h"
@@ -36,6 +37,7 @@
 #include "PatternStore.h"
 #include "SampleTrack.h"
 #include "TrackContainer.h" // For TrackContainer::TrackList typedef
+#include "Tracer.h"
 
 namespace lmms
 {
@@ -72,8 +74,10 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 	m_lock(),
 	m_queued( false ),
 	m_dependenciesMet(0),
+	m_busDependencies(0),
 	m_channelIndex(idx)
 {
+	// Only needed for effects which can't process planar buffers
 	m_buffer.allocateInterleavedBuffer();
 }
 
@@ -85,25 +89,31 @@ MixerChannel::~MixerChannel()
 }
 
 
-inline void MixerChannel::processed()
+MixerChannel* MixerChannel::processed()
 {
+	MixerChannel* continuation = nullptr;
 	for( const MixerRoute * receiverRoute : m_sends )
 	{
-		if( receiverRoute->receiver()->m_muted == false )
+		MixerChannel* receiver = receiverRoute->receiver();
+		if (receiver->m_muted == false && receiver->incrementDeps())
 		{
-			receiverRoute->receiver()->incrementDeps();
+			// keep the first ready receiver for the caller, the others go to the job queue
+			if (continuation == nullptr) { continuation = receiver; }
+			else { AudioEngineWorkerThread::addJob(receiver); }
 		}
 	}
+	return continuation;
 }
 
-void MixerChannel::incrementDeps()
+bool MixerChannel::incrementDeps()
 {
 	const auto i = m_dependenciesMet++ + 1;
-	if( i >= m_receives.size() && ! m_queued )
+	if( i >= m_receives.size() + m_busDependencies && ! m_queued )
 	{
 		m_queued = true;
-		AudioEngineWorkerThread::addJob( this );
+		return true;
 	}
+	return false;
 }
 
 void MixerChannel::unmuteForSolo()
@@ -167,6 +177,9 @@ void MixerChannel::doProcessing()
 
 	if( m_muted == false )
 	{
+		AudioEngineProfiler::NodeProbe profilerProbe(m_profilerNode);
+		Tracer::Scope traceScope("Mixer channel");
+
 		for( MixerRoute * senderRoute : m_receives )
 		{
 			MixerChannel * sender = senderRoute->sender();
@@ -175,36 +188,35 @@ void MixerChannel::doProcessing()
 
 			if (sender->m_buffer.hasAnySignal() || sender->m_stillRunning)
 			{
-				auto buffer = m_buffer.interleavedBuffer().asSampleFrames();
+				auto buffer = m_buffer.groupBuffers(0);
 
 				// figure out if we're getting sample-exact input
 				ValueBuffer * sendBuf = sendModel->valueBuffer();
 				ValueBuffer * volBuf = sender->m_volumeModel.valueBuffer();
 
 				// mix it's output with this one's output
-				auto ch_buf = sender->m_buffer.interleavedBuffer().asSampleFrames();
+				auto ch_buf = std::as_const(sender->m_buffer).groupBuffers(0);
 
 				// use sample-exact mixing if sample-exact values are available
 				if( ! volBuf && ! sendBuf ) // neither volume nor send has sample-exact data...
 				{
 					const float v = sender->m_volumeModel.value() * sendModel->value();
-					MixHelpers::addMultiplied(buffer.data(), ch_buf.data(), v, fpp);
+					MixHelpers::addMultiplied(buffer, ch_buf, v);
 				}
 				else if( volBuf && sendBuf ) // both volume and send have sample-exact data
 				{
-					MixHelpers::addMultipliedByBuffers(buffer.data(), ch_buf.data(), volBuf, sendBuf, fpp);
+					MixHelpers::addMultipliedByBuffers(buffer, ch_buf, volBuf, sendBuf);
 				}
 				else if( volBuf ) // volume has sample-exact data but send does not
 				{
 					const float v = sendModel->value();
-					MixHelpers::addMultipliedByBuffer(buffer.data(), ch_buf.data(), v, volBuf, fpp);
+					MixHelpers::addMultipliedByBuffer(buffer, ch_buf, v, volBuf);
 				}
 				else // vice versa
 				{
 					const float v = sender->m_volumeModel.value();
-					MixHelpers::addMultipliedByBuffer(buffer.data(), ch_buf.data(), v, sendBuf, fpp);
+					MixHelpers::addMultipliedByBuffer(buffer, ch_buf, v, sendBuf);
 				}
-				toPlanar(m_buffer.interleavedBuffer(), m_buffer.groupBuffers(0));
 				m_buffer.mixSilenceFlags(sender->m_buffer);
 			}
 		}
@@ -223,8 +235,13 @@ void MixerChannel::doProcessing()
 		m_peakLeft = m_peakRight = 0.0f;
 	}
 
-	// increment dependency counter of all receivers
-	processed();
+	Engine::audioEngine()->profiler().markGraphDetail(AudioEngineProfiler::DetailType::Mixing);
+
+	// increment dependency counter of all receivers. A receiver that became
+	// ready is processed right away on this thread: our output is still hot
+	// in the cache and it saves a round trip through the job queue. The depth
+	// of this recursion is bounded by the longest chain of sends.
+	if (MixerChannel* next = processed()) { next->processAsContinuation(); }
 }
 
 
@@ -646,10 +663,6 @@ void Mixer::mixToChannel(const AudioBuffer& buffer, mix_ch_t dest)
 	{
 		channel->m_lock.lock();
 		MixHelpers::add(channel->m_buffer.groupBuffers(0), buffer.groupBuffers(0));
-
-		// Copy the planar buffer to the temporary interleaved buffer so they stay in sync
-		toInterleaved(channel->m_buffer.groupBuffers(0), channel->m_buffer.interleavedBuffer());
-
 		channel->m_buffer.mixSilenceFlags(buffer);
 		channel->m_lock.unlock();
 	}
@@ -665,79 +678,83 @@ void Mixer::prepareMasterMix()
 
 
 
-void Mixer::masterMix( SampleFrame* _buf )
+void Mixer::prepareGraph()
 {
-	const int fpp = Engine::audioEngine()->framesPerPeriod();
+	for (MixerChannel* ch : m_mixerChannels)
+	{
+		ch->reset();
+		ch->m_muted = ch->m_muteModel.value();
+		ch->m_queued = false;
+		ch->m_dependenciesMet = 0;
+		ch->m_busDependencies = 0;
+	}
+}
+
+
 
+
+void Mixer::startGraph()
+{
 	// add the channels that have no dependencies (no incoming senders, ie.
-	// no receives) to the jobqueue. The channels that have receives get
-	// added when their senders get processed, which is detected by
-	// dependency counting.
+	// no receives and no audio bus handles) to the jobqueue. The other
+	// channels get added when their last input gets processed, which is
+	// detected by dependency counting.
 	// also instantly add all muted channels as they don't need to care
 	// about their senders, and can just increment the deps of their
 	// recipients right away.
-	AudioEngineWorkerThread::resetJobQueue( AudioEngineWorkerThread::JobQueue::OperationMode::Dynamic );
 	for( MixerChannel * ch : m_mixerChannels )
 	{
-		ch->m_muted = ch->m_muteModel.value();
 		if( ch->m_muted ) // instantly "process" muted channels
 		{
-			ch->processed();
+			ch->m_queued = true;
+			if (MixerChannel* next = ch->processed()) { AudioEngineWorkerThread::addJob(next); }
 			ch->done();
 		}
-		else if( ch->m_receives.size() == 0 )
+		else if (ch->m_receives.empty() && ch->m_busDependencies == 0)
 		{
 			ch->m_queued = true;
 			AudioEngineWorkerThread::addJob( ch );
 		}
 	}
-	while (m_mixerChannels[0]->state() != ThreadableJob::ProcessingState::Done)
-	{
-		bool found = false;
-		for( MixerChannel * ch : m_mixerChannels )
-		{
-			const auto s = ch->state();
-			if (s == ThreadableJob::ProcessingState::Queued
-				|| s == ThreadableJob::ProcessingState::InProgress)
-			{
-				found = true;
-				break;
-			}
-		}
-		if( !found )
-		{
-			break;
-		}
-		AudioEngineWorkerThread::startAndWaitForJobs();
-	}
+}
+
+
+
 
-	auto buffer = m_mixerChannels[0]->m_buffer.interleavedBuffer().asSampleFrames();
+void Mixer::masterMix( SampleFrame* _buf )
+{
+	const int fpp = Engine::audioEngine()->framesPerPeriod();
+
+	const AudioBuffer& master = m_mixerChannels[0]->m_buffer;
+	const float* left = master.buffer(0).data();
+	const float* right = master.buffer(1).data();
 
 	// handle sample-exact data in master volume fader
 	ValueBuffer * volBuf = m_mixerChannels[0]->m_volumeModel.valueBuffer();
 
+	// the output is interleaved, so apply the volume while interleaving
 	if( volBuf )
 	{
 		for( int f = 0; f < fpp; f++ )
 		{
-			buffer[f][0] *= volBuf->values()[f];
-			buffer[f][1] *= volBuf->values()[f];
+			_buf[f][0] += left[f] * volBuf->values()[f];
+			_buf[f][1] += right[f] * volBuf->values()[f];
+		}
+	}
+	else
+	{
+		const float v = m_mixerChannels[0]->m_volumeModel.value();
+		for (int f = 0; f < fpp; ++f)
+		{
+			_buf[f][0] += left[f] * v;
+			_buf[f][1] += right[f] * v;
 		}
 	}
 
-	const float v = volBuf
-		? 1.0f
-		: m_mixerChannels[0]->m_volumeModel.value();
-	MixHelpers::addMultiplied(_buf, buffer.data(), v, fpp);
-
-	// clear all channel buffers and
-	// reset channel process state
+	// clear all channel buffers for the next period
 	for( int i = 0; i < numChannels(); ++i)
 	{
 		m_mixerChannels[i]->m_buffer.silenceAllChannels();
-		m_mixerChannels[i]->reset();
-		m_mixerChannels[i]->m_queued = false;
-		m_mixerChannels[i]->m_dependenciesMet = 0;
 	}
 }
 
@@ -763,7 +780,7 @@ void Mixer::clearChannel(mix_ch_t index)
 	ch->m_volumeModel.setValue( 1.0f );
 	ch->m_muteModel.setValue( false );
 	ch->m_soloModel.setValue( false );
-	ch->m_name = ( index == 0 ) ? tr( "Master" ) : tr( "Channel %1" ).arg( index );
+	ch->setName(index == 0 ? tr("Master") : tr("Channel %1").arg(index));
 	ch->m_volumeModel.setDisplayName( ch->m_name + ">" + tr( "Volume" ) );
 	ch->m_muteModel.setDisplayName( ch->m_name + ">" + tr( "Mute" ) );
 	ch->m_soloModel.setDisplayName( ch->m_name + ">" + tr( "Solo" ) );
@@ -851,7 +868,7 @@ void Mixer::loadSettings( const QDomElement & _this )
 		m_mixerChannels[num]->m_volumeModel.loadSettings( mixch, "volume" );
 		m_mixerChannels[num]->m_muteModel.loadSettings( mixch, "muted" );
 		m_mixerChannels[num]->m_soloModel.loadSettings( mixch, "soloed" );
-		m_mixerChannels[num]->m_name = mixch.attribute( "name" );
+		m_mixerChannels[num]->setName(mixch.attribute("name"));
 		if (mixch.hasAttribute("color"))
 		{
 			m_mixerChannels[num]->setColor(QColor{mixch.attribute("color")});
@@ -887,7 +904,7 @@ void Mixer::validateChannelName( int index, int oldIndex )
 {
 	if( m_mixerChannels[index]->m_name == tr( "Channel %1" ).arg( oldIndex ) )
 	{
-		m_mixerChannels[index]->m_name = tr( "Channel %1" ).arg( index );
+		m_mixerChannels[index]->setName(tr("Channel %1").arg(index));
 	}
 }
 
@@ -25,8 +25,11 @@
 
 #include "NotePlayHandle.h"
 
+#include <algorithm>
+
 #include "AudioEngine.h"
 #include "DetuningHelper.h"
+#include "Hardware.h"
 #include "InstrumentSoundShaping.h"
 #include "InstrumentTrack.h"
 #include "Instrument.h"
@@ -602,25 +605,13 @@ void NotePlayHandle::resize( const bpm_t _new_tempo )
 }
 
 
-NotePlayHandle ** NotePlayHandleManager::s_available;
-QReadWriteLock NotePlayHandleManager::s_mutex;
-std::atomic_int NotePlayHandleManager::s_availableIndex;
-int NotePlayHandleManager::s_size;
+SlabPool NotePlayHandleManager::s_pool{INITIAL_NPH_CACHE};
 
 
 void NotePlayHandleManager::init()
 {
-	s_available = new NotePlayHandle*[INITIAL_NPH_CACHE];
-
-	auto n = static_cast<NotePlayHandle *>(std::malloc(sizeof(NotePlayHandle) * INITIAL_NPH_CACHE));
-
-	for( int i=0; i < INITIAL_NPH_CACHE; ++i )
-	{
-		s_available[ i ] = n;
-		++n;
-	}
-	s_availableIndex = INITIAL_NPH_CACHE - 1;
-	s_size = INITIAL_NPH_CACHE;
+	// keep note play handles on separate cache lines, they are processed by different threads
+	s_pool.create(sizeof(NotePlayHandle), std::max(alignof(NotePlayHandle), hardware_destructive_interference_size));
 }
 
 
@@ -632,45 +623,31 @@ NotePlayHandle * NotePlayHandleManager::acquire( InstrumentTrack* instrumentTrac
 				int midiEventChannel,
 				NotePlayHandle::Origin origin )
 {
-	// TODO: use some lockless data structures
-	s_mutex.lockForWrite();
-	if (s_availableIndex < 0) { extend(NPH_CACHE_INCREMENT); }
-	NotePlayHandle * nph = s_available[s_availableIndex--];
-	s_mutex.unlock();
-
-	new( (void*)nph ) NotePlayHandle( instrumentTrack, offset, frames, noteToPlay, parent, midiEventChannel, origin );
-	return nph;
+	// don't allocate on the heap on the audio thread, rather drop the note
+	void* memory = s_pool.allocate();
+	if (!memory) { return nullptr; }
+
+	return new (memory)
+		NotePlayHandle(instrumentTrack, offset, frames, noteToPlay, parent, midiEventChannel, origin);
 }
 
 
 void NotePlayHandleManager::release( NotePlayHandle * nph )
 {
 	nph->NotePlayHandle::~NotePlayHandle();
-	s_mutex.lockForRead();
-	s_available[++s_availableIndex] = nph;
-	s_mutex.unlock();
+	s_pool.deallocate(nph);
 }
 
 
-void NotePlayHandleManager::extend( int c )
+void NotePlayHandleManager::free()
 {
-	s_size += c;
-	auto tmp = new NotePlayHandle*[s_size];
-	delete[] s_available;
-	s_available = tmp;
-
-	auto n = static_cast<NotePlayHandle *>(std::malloc(sizeof(NotePlayHandle) * c));
-
-	for( int i=0; i < c; ++i )
-	{
-		s_available[++s_availableIndex] = n;
-		++n;
-	}
+	s_pool.destroy();
 }
 
-void NotePlayHandleManager::free()
+
+NotePlayHandleManager::Statistics NotePlayHandleManager::statistics()
 {
-	delete[] s_available;
+	return s_pool.statistics();
 }
 
 
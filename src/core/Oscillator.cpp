@@ -26,14 +26,25 @@
 #include "Oscillator.h"
 
 #include <algorithm>
-#if !defined(__MINGW32__) && !defined(__MINGW64__)
-	#include <thread>
-#endif
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <mutex>
 #include <numbers>
+#include <thread>
+#include <vector>
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
 
 #include "Engine.h"
 #include "AudioEngine.h"
 #include "AutomatableModel.h"
+#include "LmmsSemaphore.h"
+#include "Song.h"
+#include "ThreadPool.h"
 #include "fftw3.h"
 #include "fft_helpers.h"
 
@@ -41,15 +52,73 @@
 namespace lmms
 {
 
+namespace
+{
+
+enum class WaveTableState
+{
+	Missing,
+	Requested,
+	Loading,
+	Ready
+};
+
+std::array<std::atomic<WaveTableState>, Oscillator::NumWaveShapeTables> s_waveTableStates = {};
+Semaphore s_waveTableRequests{0};
+std::atomic<bool> s_quitWaveTableLoader = false;
+std::thread s_waveTableLoader;
+
+//! Guards the FFT plans and their buffers, which are shared by all table generators
+std::mutex s_fftMutex;
+
+QString s_waveTableCacheDir;
+
+//! Precedes the tables of a wave shape in the cache. Any change of the generated tables requires a new version.
+struct WaveTableCacheHeader
+{
+	char magic[4] = {'L', 'W', 'T', 'C'};
+	std::uint32_t version = 1;
+	std::uint32_t tableLength = OscillatorConstants::WAVETABLE_LENGTH;
+	std::uint32_t tableCount = OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT;
+	//! FNV-1a of the tables
+	std::uint64_t checksum = 0;
+
+	bool operator==(const WaveTableCacheHeader&) const = default;
+};
+
+std::uint64_t checksum(const unsigned char* data, std::size_t size)
+{
+	auto hash = std::uint64_t{0xcbf29ce484222325};
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		hash = (hash ^ data[i]) * 0x100000001b3;
+	}
+	return hash;
+}
+
+QString waveTableCachePath(Oscillator::WaveShape shape)
+{
+	return QString{"%1/%2.bin"}.arg(s_waveTableCacheDir).arg(static_cast<int>(shape));
+}
+
+} // namespace
+
+
+
 
 void Oscillator::waveTableInit()
 {
-	createFFTPlans();
-	generateWaveTables();
 	// The oscillator FFT plans remain throughout the application lifecycle
 	// due to being expensive to create, and being used whenever a userwave form is changed
-	// deleted in main.cpp main()
+	createFFTPlans();
 
+	// The band-limited tables are only loaded once an oscillator needs them, from the cache if possible
+	const auto cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+	s_waveTableCacheDir = cacheDir.isEmpty() ? QString{} : cacheDir + "/wavetables";
+	s_quitWaveTableLoader = false;
+	s_waveTableLoader = std::thread{runWaveTableLoader};
+	// pick up tables requested while the engine was destroyed
+	s_waveTableRequests.post();
 }
 
 Oscillator::Oscillator(const IntModel *wave_shape_model,
@@ -79,39 +148,53 @@ Oscillator::Oscillator(const IntModel *wave_shape_model,
 
 void Oscillator::update(SampleFrame* ab, const f_cnt_t frames, const ch_cnt_t chnl, bool modulator)
 {
-	if (m_freq >= Engine::audioEngine()->outputSampleRate() / 2)
+	const auto sampleRate = Engine::audioEngine()->outputSampleRate();
+	if (m_freq >= sampleRate / 2)
 	{
 		zeroSampleFrames(ab, frames);
 		return;
 	}
+	const float currentFreq = m_freq * m_detuning_div_samplerate * sampleRate;
+	m_waveTableBand = waveTableBandFromFreq(currentFreq);
+	m_aboveMaxFreq = currentFreq >= OscillatorConstants::MAX_FREQ;
+
 	// If this oscillator is used to PM or PF modulate another oscillator, take a note.
-	// The sampling functions will check this variable and avoid using band-limited
-	// wavetables, since they contain ringing that would lead to unexpected results.
+	// Band-limited wavetables are avoided then, since they contain ringing that would
+	// lead to unexpected results.
 	m_isModulator = modulator;
+
+	// Everything that is constant during the period is resolved here, so the kernels don't branch per sample
+	auto shape = static_cast<WaveShape>(m_waveShapeModel->value());
+	if (static_cast<std::size_t>(shape) >= NumWaveShapes) { shape = WaveShape::Sine; }
+
+	auto algo = NumModulationAlgos;
 	if (m_subOsc != nullptr)
 	{
-		switch (static_cast<ModulationAlgo>(m_modulationAlgoModel->value()))
-		{
-			case ModulationAlgo::PhaseModulation:
-				updatePM(ab, frames, chnl);
-				break;
-			case ModulationAlgo::AmplitudeModulation:
-				updateAM(ab, frames, chnl);
-				break;
-			case ModulationAlgo::SignalMix:
-			default:
-				updateMix(ab, frames, chnl);
-				break;
-			case ModulationAlgo::SynchronizedBySubOsc:
-				updateSync(ab, frames, chnl);
-				break;
-			case ModulationAlgo::FrequencyModulation:
-				updateFM(ab, frames, chnl);
-		}
+		algo = static_cast<std::size_t>(m_modulationAlgoModel->value());
+		if (algo >= NumModulationAlgos) { algo = static_cast<std::size_t>(ModulationAlgo::SignalMix); }
 	}
-	else
+
+	const auto kernel = s_kernels[algo][static_cast<std::size_t>(shape)][usesWaveTable(shape)];
+	(this->*kernel)(ab, frames, chnl);
+}
+
+
+
+
+bool Oscillator::usesWaveTable(WaveShape shape) const
+{
+	if (!m_useWaveTable) { return false; }
+
+	switch (shape)
 	{
-		updateNoSub(ab, frames, chnl);
+		case WaveShape::Sine:
+			return true;
+		case WaveShape::WhiteNoise:
+			return false;
+		case WaveShape::UserDefined:
+			return m_userAntiAliasWaveTable && !m_isModulator;
+		default:
+			return !m_isModulator && waveTableAvailable(shape);
 	}
 }
 
@@ -191,6 +274,7 @@ void Oscillator::generateFromFFT(int bands, sample_t* table)
 std::unique_ptr<OscillatorConstants::waveform_t> Oscillator::generateAntiAliasUserWaveTable(const SampleBuffer* sampleBuffer)
 {
 	auto userAntiAliasWaveTable = std::make_unique<OscillatorConstants::waveform_t>();
+	const auto lock = std::lock_guard{s_fftMutex};
 	for (int i = 0; i < OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT; ++i)
 	{
 		// TODO: This loop seems to be doing the same thing for each iteration of the outer loop,
@@ -235,20 +319,28 @@ void Oscillator::createFFTPlans()
 
 void Oscillator::destroyFFTPlans()
 {
+	if (s_waveTableLoader.joinable())
+	{
+		s_quitWaveTableLoader = true;
+		s_waveTableRequests.post();
+		s_waveTableLoader.join();
+	}
+
 	fftwf_destroy_plan(s_fftPlan);
 	fftwf_destroy_plan(s_ifftPlan);
 	fftwf_free(s_specBuf);
 }
 
-void Oscillator::generateWaveTables()
+void Oscillator::generateWaveTable(WaveShape shape)
 {
-	// Generate tables for simple shaped (constructed by summing sine waves).
+	const auto shapeID = static_cast<std::size_t>(shape) - FirstWaveShapeTable;
+
+	// Generate tables for simple shapes (constructed by summing sine waves).
 	// Start from the table that contains the least number of bands, and re-use each table in the following
 	// iteration, adding more bands in each step and avoiding repeated computation of earlier bands.
 	using generator_t = void (*)(int, sample_t*, int);
-	auto simpleGen = [](WaveShape shape, generator_t generator)
+	auto simpleGen = [shapeID](generator_t generator)
 	{
-		const int shapeID = static_cast<std::size_t>(shape) - FirstWaveShapeTable;
 		int lastBands = 0;
 
 		// Clear the first wave table
@@ -274,83 +366,39 @@ void Oscillator::generateWaveTables()
 
 	// FFT-based wave shapes: make standard wave table without band limit, convert to frequency domain, remove bands
 	// above maximum frequency and convert back to time domain.
-	auto fftGen = []()
+	using shape_function_t = sample_t (*)(float);
+	auto fftGen = [shapeID](shape_function_t shapeFunction)
 	{
-		// Generate moogSaw tables
+		const auto lock = std::lock_guard{s_fftMutex};
 		for (int i = 0; i < OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT; ++i)
 		{
-			for (int i = 0; i < OscillatorConstants::WAVETABLE_LENGTH; ++i)
+			for (int j = 0; j < OscillatorConstants::WAVETABLE_LENGTH; ++j)
 			{
-				Oscillator::s_sampleBuffer[i] = moogSawSample((float)i / (float)OscillatorConstants::WAVETABLE_LENGTH);
+				s_sampleBuffer[j] = shapeFunction((float)j / (float)OscillatorConstants::WAVETABLE_LENGTH);
 			}
 			fftwf_execute(s_fftPlan);
-			generateFromFFT(OscillatorConstants::MAX_FREQ / freqFromWaveTableBand(i), s_waveTables[static_cast<std::size_t>(WaveShape::MoogSaw) - FirstWaveShapeTable][i]);
-		}
-
-		// Generate exponential tables
-		for (int i = 0; i < OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT; ++i)
-		{
-			for (int i = 0; i < OscillatorConstants::WAVETABLE_LENGTH; ++i)
-			{
-				s_sampleBuffer[i] = expSample((float)i / (float)OscillatorConstants::WAVETABLE_LENGTH);
-			}
-			fftwf_execute(s_fftPlan);
-			generateFromFFT(OscillatorConstants::MAX_FREQ / freqFromWaveTableBand(i), s_waveTables[static_cast<std::size_t>(WaveShape::Exponential) - FirstWaveShapeTable][i]);
+			generateFromFFT(OscillatorConstants::MAX_FREQ / freqFromWaveTableBand(i), s_waveTables[shapeID][i]);
 		}
 	};
 
-// TODO: Mingw compilers currently do not support std::thread. There are some 3rd-party workarounds available,
-// but since threading is not essential in this case, it is easier and more reliable to simply generate
-// the wavetables serially. Remove the the check and #else branch once std::thread is well supported.
-#if !defined(__MINGW32__) && !defined(__MINGW64__)
-	std::thread sawThread(simpleGen, WaveShape::Saw, generateSawWaveTable);
-	std::thread squareThread(simpleGen, WaveShape::Square, generateSquareWaveTable);
-	std::thread triangleThread(simpleGen, WaveShape::Triangle, generateTriangleWaveTable);
-	std::thread fftThread(fftGen);
-	sawThread.join();
-	squareThread.join();
-	triangleThread.join();
-	fftThread.join();
-#else
-	simpleGen(WaveShape::Saw, generateSawWaveTable);
-	simpleGen(WaveShape::Square, generateSquareWaveTable);
-	simpleGen(WaveShape::Triangle, generateTriangleWaveTable);
-	fftGen();
-#endif
-}
-
-
-
-
-void Oscillator::updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
-{
-	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
+	switch (shape)
 	{
-		case WaveShape::Sine:
-		default:
-			updateNoSub<WaveShape::Sine>( _ab, _frames, _chnl );
-			break;
 		case WaveShape::Triangle:
-			updateNoSub<WaveShape::Triangle>( _ab, _frames, _chnl );
+			simpleGen(generateTriangleWaveTable);
 			break;
 		case WaveShape::Saw:
-			updateNoSub<WaveShape::Saw>( _ab, _frames, _chnl );
+			simpleGen(generateSawWaveTable);
 			break;
 		case WaveShape::Square:
-			updateNoSub<WaveShape::Square>( _ab, _frames, _chnl );
+			simpleGen(generateSquareWaveTable);
 			break;
 		case WaveShape::MoogSaw:
-			updateNoSub<WaveShape::MoogSaw>( _ab, _frames, _chnl );
+			fftGen(moogSawSample);
 			break;
 		case WaveShape::Exponential:
-			updateNoSub<WaveShape::Exponential>( _ab, _frames, _chnl );
+			fftGen(expSample);
 			break;
-		case WaveShape::WhiteNoise:
-			updateNoSub<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::UserDefined:
-			updateNoSub<WaveShape::UserDefined>( _ab, _frames, _chnl );
+		default:
 			break;
 	}
 }
@@ -358,181 +406,149 @@ void Oscillator::updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 
-void Oscillator::updatePM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::waitForWaveTables()
 {
-	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
+	for (std::size_t table = 0; table < NumWaveShapeTables; ++table)
 	{
-		case WaveShape::Sine:
-		default:
-			updatePM<WaveShape::Sine>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Triangle:
-			updatePM<WaveShape::Triangle>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Saw:
-			updatePM<WaveShape::Saw>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Square:
-			updatePM<WaveShape::Square>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::MoogSaw:
-			updatePM<WaveShape::MoogSaw>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Exponential:
-			updatePM<WaveShape::Exponential>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::WhiteNoise:
-			updatePM<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::UserDefined:
-			updatePM<WaveShape::UserDefined>( _ab, _frames, _chnl );
-			break;
+		waitForWaveTable(table);
 	}
 }
 
 
 
 
-void Oscillator::updateAM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+bool Oscillator::waveTableAvailable(WaveShape shape)
 {
-	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
+	const auto table = static_cast<std::size_t>(shape) - FirstWaveShapeTable;
+	if (s_waveTableStates[table].load(std::memory_order_acquire) == WaveTableState::Ready) { return true; }
+
+	// During playback, the oscillator isn't band-limited until the tables have been loaded in the background.
+	// When exporting, the result must not depend on timing, and blocking is fine.
+	requestWaveTable(table);
+	if (!Engine::getSong()->isExporting()) { return false; }
+
+	waitForWaveTable(table);
+	return true;
+}
+
+
+
+
+//! Realtime-safe: only marks the table as requested and wakes the loader thread
+void Oscillator::requestWaveTable(std::size_t table)
+{
+	auto expected = WaveTableState::Missing;
+	if (s_waveTableStates[table].compare_exchange_strong(expected, WaveTableState::Requested,
+		std::memory_order_acq_rel))
 	{
-		case WaveShape::Sine:
-		default:
-			updateAM<WaveShape::Sine>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Triangle:
-			updateAM<WaveShape::Triangle>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Saw:
-			updateAM<WaveShape::Saw>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Square:
-			updateAM<WaveShape::Square>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::MoogSaw:
-			updateAM<WaveShape::MoogSaw>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Exponential:
-			updateAM<WaveShape::Exponential>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::WhiteNoise:
-			updateAM<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::UserDefined:
-			updateAM<WaveShape::UserDefined>( _ab, _frames, _chnl );
-			break;
+		s_waveTableRequests.post();
 	}
 }
 
 
 
 
-void Oscillator::updateMix( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::waitForWaveTable(std::size_t table)
 {
-	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
+	requestWaveTable(table);
+
+	auto& state = s_waveTableStates[table];
+	for (auto current = state.load(std::memory_order_acquire); current != WaveTableState::Ready;
+		current = state.load(std::memory_order_acquire))
 	{
-		case WaveShape::Sine:
-		default:
-			updateMix<WaveShape::Sine>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Triangle:
-			updateMix<WaveShape::Triangle>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Saw:
-			updateMix<WaveShape::Saw>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Square:
-			updateMix<WaveShape::Square>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::MoogSaw:
-			updateMix<WaveShape::MoogSaw>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Exponential:
-			updateMix<WaveShape::Exponential>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::WhiteNoise:
-			updateMix<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::UserDefined:
-			updateMix<WaveShape::UserDefined>( _ab, _frames, _chnl );
-			break;
+		state.wait(current, std::memory_order_acquire);
 	}
 }
 
 
 
 
-void Oscillator::updateSync( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::runWaveTableLoader()
 {
-	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
+	auto pending = std::vector<std::future<void>>{};
+
+	while (true)
 	{
-		case WaveShape::Sine:
-		default:
-			updateSync<WaveShape::Sine>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Triangle:
-			updateSync<WaveShape::Triangle>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Saw:
-			updateSync<WaveShape::Saw>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Square:
-			updateSync<WaveShape::Square>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::MoogSaw:
-			updateSync<WaveShape::MoogSaw>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Exponential:
-			updateSync<WaveShape::Exponential>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::WhiteNoise:
-			updateSync<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::UserDefined:
-			updateSync<WaveShape::UserDefined>( _ab, _frames, _chnl );
-			break;
+		s_waveTableRequests.wait();
+		if (s_quitWaveTableLoader) { break; }
+
+		// load all requested tables in parallel
+		for (std::size_t table = 0; table < NumWaveShapeTables; ++table)
+		{
+			auto expected = WaveTableState::Requested;
+			if (s_waveTableStates[table].compare_exchange_strong(expected, WaveTableState::Loading,
+				std::memory_order_acq_rel))
+			{
+				pending.push_back(ThreadPool::instance().enqueue(loadWaveTable, table));
+			}
+		}
 	}
+
+	// the FFT plans are destroyed after this
+	for (auto& future : pending) { future.wait(); }
 }
 
 
 
 
-void Oscillator::updateFM( SampleFrame* _ab, const f_cnt_t _frames,
-							const ch_cnt_t _chnl )
+void Oscillator::loadWaveTable(std::size_t table)
 {
-	switch( static_cast<WaveShape>(m_waveShapeModel->value()) )
+	const auto shape = static_cast<WaveShape>(table + FirstWaveShapeTable);
+	if (!readWaveTableCache(shape))
 	{
-		case WaveShape::Sine:
-		default:
-			updateFM<WaveShape::Sine>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Triangle:
-			updateFM<WaveShape::Triangle>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Saw:
-			updateFM<WaveShape::Saw>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Square:
-			updateFM<WaveShape::Square>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::MoogSaw:
-			updateFM<WaveShape::MoogSaw>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::Exponential:
-			updateFM<WaveShape::Exponential>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::WhiteNoise:
-			updateFM<WaveShape::WhiteNoise>( _ab, _frames, _chnl );
-			break;
-		case WaveShape::UserDefined:
-			updateFM<WaveShape::UserDefined>( _ab, _frames, _chnl );
-			break;
+		generateWaveTable(shape);
+		writeWaveTableCache(shape);
 	}
+
+	s_waveTableStates[table].store(WaveTableState::Ready, std::memory_order_release);
+	s_waveTableStates[table].notify_all();
+}
+
+
+
+
+bool Oscillator::readWaveTableCache(WaveShape shape)
+{
+	auto file = QFile{waveTableCachePath(shape)};
+	if (s_waveTableCacheDir.isEmpty() || !file.open(QIODevice::ReadOnly)) { return false; }
+
+	const auto table = static_cast<std::size_t>(shape) - FirstWaveShapeTable;
+	constexpr auto dataSize = sizeof(s_waveTables[0]);
+	if (file.size() != static_cast<qint64>(sizeof(WaveTableCacheHeader) + dataSize)) { return false; }
+
+	const auto mapped = file.map(0, file.size());
+	if (!mapped) { return false; }
+
+	auto header = WaveTableCacheHeader{};
+	std::memcpy(&header, mapped, sizeof(header));
+	const auto data = mapped + sizeof(header);
+
+	const bool valid = header == WaveTableCacheHeader{.checksum = header.checksum}
+		&& header.checksum == checksum(data, dataSize);
+	if (valid) { std::memcpy(s_waveTables[table], data, dataSize); }
+
+	file.unmap(mapped);
+	return valid;
+}
+
+
+
+
+void Oscillator::writeWaveTableCache(WaveShape shape)
+{
+	if (s_waveTableCacheDir.isEmpty() || !QDir{}.mkpath(s_waveTableCacheDir)) { return; }
+
+	const auto table = static_cast<std::size_t>(shape) - FirstWaveShapeTable;
+	constexpr auto dataSize = sizeof(s_waveTables[0]);
+	const auto data = reinterpret_cast<const unsigned char*>(s_waveTables[table]);
+	const auto header = WaveTableCacheHeader{.checksum = checksum(data, dataSize)};
+
+	// written to a temporary file first, so other instances never read an incomplete cache
+	auto file = QSaveFile{waveTableCachePath(shape)};
+	if (!file.open(QIODevice::WriteOnly)) { return; }
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(data), dataSize);
+	file.commit();
 }
 
 
@@ -579,7 +595,7 @@ float Oscillator::syncInit( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 // if we have no sub-osc, we can't do any modulation... just get our samples
-template<Oscillator::WaveShape W>
+template<Oscillator::WaveShape W, bool WaveTable>
 void Oscillator::updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl )
 {
@@ -588,7 +604,7 @@ void Oscillator::updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
 
 	for( f_cnt_t frame = 0; frame < _frames; ++frame )
 	{
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
+		_ab[frame][_chnl] = getSample<W, WaveTable>( m_phase ) * m_volume;
 		m_phase += osc_coeff;
 	}
 }
@@ -597,7 +613,7 @@ void Oscillator::updateNoSub( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 // do pm by using sub-osc as modulator
-template<Oscillator::WaveShape W>
+template<Oscillator::WaveShape W, bool WaveTable>
 void Oscillator::updatePM( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl )
 {
@@ -607,7 +623,7 @@ void Oscillator::updatePM( SampleFrame* _ab, const f_cnt_t _frames,
 
 	for( f_cnt_t frame = 0; frame < _frames; ++frame )
 	{
-		_ab[frame][_chnl] = getSample<W>( m_phase +
+		_ab[frame][_chnl] = getSample<W, WaveTable>( m_phase +
 					_ab[frame][_chnl] )
 							* m_volume;
 		m_phase += osc_coeff;
@@ -618,7 +634,7 @@ void Oscillator::updatePM( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 // do am by using sub-osc as modulator
-template<Oscillator::WaveShape W>
+template<Oscillator::WaveShape W, bool WaveTable>
 void Oscillator::updateAM( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl )
 {
@@ -628,7 +644,7 @@ void Oscillator::updateAM( SampleFrame* _ab, const f_cnt_t _frames,
 
 	for( f_cnt_t frame = 0; frame < _frames; ++frame )
 	{
-		_ab[frame][_chnl] *= getSample<W>( m_phase ) * m_volume;
+		_ab[frame][_chnl] *= getSample<W, WaveTable>( m_phase ) * m_volume;
 		m_phase += osc_coeff;
 	}
 }
@@ -637,7 +653,7 @@ void Oscillator::updateAM( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 // do mix by using sub-osc as mix-sample
-template<Oscillator::WaveShape W>
+template<Oscillator::WaveShape W, bool WaveTable>
 void Oscillator::updateMix( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl )
 {
@@ -647,7 +663,7 @@ void Oscillator::updateMix( SampleFrame* _ab, const f_cnt_t _frames,
 
 	for( f_cnt_t frame = 0; frame < _frames; ++frame )
 	{
-		_ab[frame][_chnl] += getSample<W>( m_phase ) * m_volume;
+		_ab[frame][_chnl] += getSample<W, WaveTable>( m_phase ) * m_volume;
 		m_phase += osc_coeff;
 	}
 }
@@ -657,7 +673,7 @@ void Oscillator::updateMix( SampleFrame* _ab, const f_cnt_t _frames,
 
 // sync with sub-osc (every time sub-osc starts new period, we also start new
 // period)
-template<Oscillator::WaveShape W>
+template<Oscillator::WaveShape W, bool WaveTable>
 void Oscillator::updateSync( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl )
 {
@@ -671,7 +687,7 @@ void Oscillator::updateSync( SampleFrame* _ab, const f_cnt_t _frames,
 		{
 			m_phase = m_phaseOffset;
 		}
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
+		_ab[frame][_chnl] = getSample<W, WaveTable>( m_phase ) * m_volume;
 		m_phase += osc_coeff;
 	}
 }
@@ -680,7 +696,7 @@ void Oscillator::updateSync( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 // do fm by using sub-osc as modulator
-template<Oscillator::WaveShape W>
+template<Oscillator::WaveShape W, bool WaveTable>
 void Oscillator::updateFM( SampleFrame* _ab, const f_cnt_t _frames,
 							const ch_cnt_t _chnl )
 {
@@ -692,7 +708,7 @@ void Oscillator::updateFM( SampleFrame* _ab, const f_cnt_t _frames,
 	for( f_cnt_t frame = 0; frame < _frames; ++frame )
 	{
 		m_phase += _ab[frame][_chnl] * sampleRateCorrection;
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
+		_ab[frame][_chnl] = getSample<W, WaveTable>( m_phase ) * m_volume;
 		m_phase += osc_coeff;
 	}
 }
@@ -700,132 +716,75 @@ void Oscillator::updateFM( SampleFrame* _ab, const f_cnt_t _frames,
 
 
 
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Sine>(const float sample)
-{
-	const float current_freq = m_freq * m_detuning_div_samplerate * Engine::audioEngine()->outputSampleRate();
-
-	if (!m_useWaveTable || current_freq < OscillatorConstants::MAX_FREQ)
-	{
-		return sinSample(sample);
-	}
-	else
-	{
-		return 0;
-	}
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Triangle>(
-		const float _sample )
+template<Oscillator::WaveShape W, bool WaveTable>
+inline sample_t Oscillator::getSample(const float sample)
 {
-	if (m_useWaveTable && !m_isModulator)
+	if constexpr (W == WaveShape::Sine)
 	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Triangle) - FirstWaveShapeTable],_sample);
+		// the sine has no wavetable, but is band-limited the same way
+		return WaveTable && m_aboveMaxFreq ? 0 : sinSample(sample);
 	}
-	else
+	else if constexpr (W == WaveShape::WhiteNoise)
 	{
-		return triangleSample(_sample);
+		return noiseSample(sample);
 	}
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Saw>(
-		const float _sample )
-{
-	if (m_useWaveTable && !m_isModulator)
+	else if constexpr (W == WaveShape::UserDefined)
 	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Saw) - FirstWaveShapeTable], _sample);
+		if constexpr (WaveTable) { return wtSample(m_userAntiAliasWaveTable.get(), sample); }
+		else { return userWaveSample(m_userWave.get(), sample); }
 	}
-	else
+	else if constexpr (WaveTable)
 	{
-		return sawSample(_sample);
+		return wtSample(s_waveTables[static_cast<std::size_t>(W) - FirstWaveShapeTable], sample);
 	}
+	else if constexpr (W == WaveShape::Triangle) { return triangleSample(sample); }
+	else if constexpr (W == WaveShape::Saw) { return sawSample(sample); }
+	else if constexpr (W == WaveShape::Square) { return squareSample(sample); }
+	else if constexpr (W == WaveShape::MoogSaw) { return moogSawSample(sample); }
+	else { return expSample(sample); }
 }
 
 
 
 
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Square>(
-		const float _sample )
+template<Oscillator::WaveShape W, bool WaveTable>
+constexpr auto Oscillator::kernelsFor() -> std::array<UpdateKernel, NumModulationAlgos + 1>
 {
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Square) - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return squareSample(_sample);
-	}
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::MoogSaw>(
-							const float _sample )
-{
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::MoogSaw) - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return moogSawSample(_sample);
-	}
+	// in the order of ModulationAlgo, followed by the kernel without sub oscillator
+	return {
+		&Oscillator::updatePM<W, WaveTable>,
+		&Oscillator::updateAM<W, WaveTable>,
+		&Oscillator::updateMix<W, WaveTable>,
+		&Oscillator::updateSync<W, WaveTable>,
+		&Oscillator::updateFM<W, WaveTable>,
+		&Oscillator::updateNoSub<W, WaveTable>
+	};
 }
 
 
 
 
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Exponential>(
-							const float _sample )
+constexpr auto Oscillator::makeKernelTable() -> KernelTable
 {
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Exponential) - FirstWaveShapeTable], _sample);
-	}
-	else
+	auto table = KernelTable{};
+	const auto addShapes = [&]<std::size_t... Shapes>(std::index_sequence<Shapes...>)
 	{
-		return expSample(_sample);
-	}
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::WhiteNoise>(
-							const float _sample )
-{
-	return( noiseSample( _sample ) );
+		const auto addShape = [&]<WaveShape W>()
+		{
+			const auto withoutTable = kernelsFor<W, false>();
+			const auto withTable = kernelsFor<W, true>();
+			for (std::size_t algo = 0; algo < NumModulationAlgos + 1; ++algo)
+			{
+				table[algo][static_cast<std::size_t>(W)] = {withoutTable[algo], withTable[algo]};
+			}
+		};
+		(addShape.template operator()<static_cast<WaveShape>(Shapes)>(), ...);
+	};
+	addShapes(std::make_index_sequence<NumWaveShapes>{});
+	return table;
 }
 
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::UserDefined>(
-							const float _sample )
-{
-	if (m_useWaveTable && m_userAntiAliasWaveTable && !m_isModulator)
-	{
-		return wtSample(m_userAntiAliasWaveTable.get(), _sample);
-	}
-	else
-	{
-		return userWaveSample(m_userWave.get(), _sample);
-	}
-}
+constinit const Oscillator::KernelTable Oscillator::s_kernels = makeKernelTable();
 
 
 } // namespace lmms
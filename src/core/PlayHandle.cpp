@@ -23,10 +23,13 @@
  */
  
 #include "PlayHandle.h"
+#include "AudioBusHandle.h"
 #include "AudioEngine.h"
 #include "BufferManager.h"
 #include "Engine.h"
+#include "Tracer.h"
 
+#include <optional>
 #include <QThread>
 
 
@@ -39,7 +42,8 @@ PlayHandle::PlayHandle(const Type type, f_cnt_t offset) :
 		m_affinity(QThread::currentThread()),
 		m_playHandleBuffer(BufferManager::acquire()),
 		m_bufferReleased(true),
-		m_usesBuffer(true)
+		m_usesBuffer(true),
+		m_audioBusHandle(nullptr)
 {
 }
 
@@ -52,16 +56,32 @@ PlayHandle::~PlayHandle()
 
 void PlayHandle::doProcessing()
 {
-	if( m_usesBuffer )
 	{
-		m_bufferReleased = false;
-		zeroSampleFrames(m_playHandleBuffer, Engine::audioEngine()->framesPerPeriod());
-		play( buffer() );
-	}
-	else
-	{
-		play( nullptr );
+		// account the time to the track we're playing on. Instrument play handles first wait for
+		// the track's notes, which are timed on their own, so they only time the instrument.
+		auto profilerProbe = std::optional<AudioEngineProfiler::NodeProbe>{};
+		if (m_audioBusHandle && m_type != Type::InstrumentPlayHandle)
+		{
+			profilerProbe.emplace(m_audioBusHandle->profilerNode());
+		}
+		Tracer::Scope traceScope("Play handle");
+
+		if( m_usesBuffer )
+		{
+			m_bufferReleased = false;
+			zeroSampleFrames(m_playHandleBuffer, Engine::audioEngine()->framesPerPeriod());
+			play( buffer() );
+		}
+		else
+		{
+			play( nullptr );
+		}
 	}
+
+	Engine::audioEngine()->profiler().markGraphDetail(AudioEngineProfiler::DetailType::Instruments);
+
+	// our audio bus handle can be processed as soon as all of its play handles are done
+	if (m_audioBusHandle) { m_audioBusHandle->graphInputProcessed(); }
 }
 
 
@@ -0,0 +1,245 @@
+/*
+ * ProjectArchive.cpp - indexed, chunked container for projects
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ProjectArchive.h"
+
+#include <QDataStream>
+#include <QFileInfo>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <map>
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr auto Magic = std::array{'L', 'M', 'P', 'A'};
+constexpr auto Version = quint32{1};
+constexpr auto HeaderSize = quint64{Magic.size() + sizeof(quint32) + sizeof(quint64)};
+
+//! Base64 encoded data never contains a colon, so references can't be mistaken for it
+const auto ChunkReferencePrefix = QStringLiteral("chunk:");
+
+std::mutex s_openMutex;
+std::map<QString, std::weak_ptr<const ProjectArchive>> s_openArchives;
+
+void setUpStream(QDataStream& stream)
+{
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream.setByteOrder(QDataStream::LittleEndian);
+}
+
+} // namespace
+
+
+
+
+ProjectArchive::Writer::Writer(QIODevice& output) :
+	m_output(output),
+	m_ok(output.isWritable() && !output.isSequential() && output.pos() == 0)
+{
+	auto stream = QDataStream{&m_output};
+	setUpStream(stream);
+	stream.writeRawData(Magic.data(), Magic.size());
+	// The index offset is filled in by finish()
+	stream << Version << quint64{0};
+	m_ok = m_ok && stream.status() == QDataStream::Ok;
+}
+
+
+
+
+void ProjectArchive::Writer::add(const QString& name, const QByteArray& data, Compression compression)
+{
+	const auto stored = compression == Compression::Zlib ? qCompress(data) : data;
+	m_chunks.push_back(Chunk{name, compression, static_cast<quint64>(m_output.pos()),
+		static_cast<quint64>(stored.size()), static_cast<quint64>(data.size())});
+
+	m_ok = m_ok && m_output.write(stored) == stored.size();
+}
+
+
+
+
+auto ProjectArchive::Writer::finish() -> bool
+{
+	const auto indexOffset = static_cast<quint64>(m_output.pos());
+
+	auto stream = QDataStream{&m_output};
+	setUpStream(stream);
+	stream << static_cast<quint32>(m_chunks.size());
+	for (const auto& chunk : m_chunks)
+	{
+		stream << chunk.name << static_cast<quint32>(chunk.compression) << chunk.offset << chunk.size << chunk.rawSize;
+	}
+
+	m_ok = m_ok && stream.status() == QDataStream::Ok && m_output.seek(Magic.size() + sizeof(Version));
+	stream << indexOffset;
+	return m_ok && stream.status() == QDataStream::Ok;
+}
+
+
+
+
+auto ProjectArchive::isArchive(QIODevice& device) -> bool
+{
+	return device.peek(Magic.size()) == QByteArray(Magic.data(), Magic.size());
+}
+
+
+
+
+auto ProjectArchive::open(const QString& path) -> std::shared_ptr<const ProjectArchive>
+{
+	const auto info = QFileInfo{path};
+	const auto absolutePath = info.absoluteFilePath();
+
+	const auto lock = std::lock_guard{s_openMutex};
+	if (const auto it = s_openArchives.find(absolutePath); it != s_openArchives.end())
+	{
+		const auto archive = it->second.lock();
+		if (archive && archive->m_lastModified == info.lastModified()) { return archive; }
+	}
+
+	auto archive = std::shared_ptr<ProjectArchive>{new ProjectArchive{absolutePath}};
+	if (!archive->readIndex()) { return nullptr; }
+
+	std::erase_if(s_openArchives, [](const auto& entry) { return entry.second.expired(); });
+	s_openArchives[absolutePath] = archive;
+	return archive;
+}
+
+
+
+
+auto ProjectArchive::chunkReference(const QString& name) -> QString
+{
+	return ChunkReferencePrefix + name;
+}
+
+
+
+
+auto ProjectArchive::isChunkReference(const QString& value) -> bool
+{
+	return value.startsWith(ChunkReferencePrefix);
+}
+
+
+
+
+auto ProjectArchive::chunkName(const QString& reference) -> QString
+{
+	return reference.mid(ChunkReferencePrefix.size());
+}
+
+
+
+
+auto ProjectArchive::find(const QString& name) const -> const Chunk*
+{
+	const auto it = std::find_if(m_chunks.begin(), m_chunks.end(), [&](const Chunk& chunk) {
+		return chunk.name == name;
+	});
+	return it != m_chunks.end() ? &*it : nullptr;
+}
+
+
+
+
+auto ProjectArchive::read(const QString& name) const -> QByteArray
+{
+	const auto chunk = find(name);
+	if (!chunk) { return {}; }
+
+	auto data = QByteArray{};
+	{
+		const auto lock = std::lock_guard{m_fileMutex};
+		if (!m_file.seek(static_cast<qint64>(chunk->offset))) { return {}; }
+		data = m_file.read(static_cast<qint64>(chunk->size));
+	}
+	if (static_cast<quint64>(data.size()) != chunk->size) { return {}; }
+
+	if (chunk->compression == Compression::Zlib) { data = qUncompress(data); }
+	return static_cast<quint64>(data.size()) == chunk->rawSize ? data : QByteArray{};
+}
+
+
+
+
+ProjectArchive::ProjectArchive(const QString& path) :
+	m_path(path),
+	m_lastModified(QFileInfo{path}.lastModified()),
+	m_file(path)
+{
+}
+
+
+
+
+auto ProjectArchive::readIndex() -> bool
+{
+	if (!m_file.open(QIODevice::ReadOnly) || !isArchive(m_file)) { return false; }
+
+	auto stream = QDataStream{&m_file};
+	setUpStream(stream);
+	stream.skipRawData(Magic.size());
+
+	auto version = quint32{0};
+	auto indexOffset = quint64{0};
+	stream >> version >> indexOffset;
+	if (stream.status() != QDataStream::Ok || version != Version || indexOffset < HeaderSize
+		|| indexOffset > static_cast<quint64>(m_file.size()) || !m_file.seek(static_cast<qint64>(indexOffset)))
+	{
+		return false;
+	}
+
+	auto count = quint32{0};
+	stream >> count;
+	// Not reserving count chunks up front, since the count isn't validated yet
+	for (auto i = quint32{0}; i < count; ++i)
+	{
+		auto chunk = Chunk{};
+		auto compression = quint32{0};
+		stream >> chunk.name >> compression >> chunk.offset >> chunk.size >> chunk.rawSize;
+
+		const auto maxSize = static_cast<quint64>(std::numeric_limits<int>::max());
+		if (stream.status() != QDataStream::Ok || compression > static_cast<quint32>(Compression::Zlib)
+			|| chunk.offset < HeaderSize || chunk.offset > indexOffset || chunk.size > indexOffset - chunk.offset
+			|| chunk.size > maxSize || chunk.rawSize > maxSize)
+		{
+			return false;
+		}
+
+		chunk.compression = static_cast<Compression>(compression);
+		m_chunks.push_back(std::move(chunk));
+	}
+
+	return true;
+}
+
+} // namespace lmms
@@ -0,0 +1,180 @@
+/*
+ * ProjectPrefetcher.cpp - loads the files of a project in the background
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ProjectPrefetcher.h"
+
+#include <QDomElement>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#include "PathUtil.h"
+#include "SampleBuffer.h"
+#include "SampleDecoder.h"
+#include "ThreadPool.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+//! Bytes of other files than samples read into the file cache at most, since plugins often read only parts of them
+constexpr auto MaxWarmUpBytes = qint64{256} << 20;
+
+bool isFileAttribute(const QString& name)
+{
+	return name == "src" || name.startsWith("userwavefile");
+}
+
+bool isSampleFile(const QString& path)
+{
+	const auto suffix = QFileInfo{path}.suffix().toLower().toStdString();
+	const auto& types = SampleDecoder::supportedAudioTypes();
+	return std::any_of(types.begin(), types.end(), [&](const auto& type) { return type.extension == suffix; });
+}
+
+void warmUp(const QString& path)
+{
+	auto file = QFile{path};
+	if (!file.open(QIODevice::ReadOnly)) { return; }
+
+	auto buffer = std::vector<char>(1 << 20);
+	for (auto bytes = qint64{0}; bytes < MaxWarmUpBytes;)
+	{
+		const auto read = file.read(buffer.data(), static_cast<qint64>(buffer.size()));
+		if (read <= 0) { break; }
+		bytes += read;
+	}
+}
+
+} // namespace
+
+
+
+
+ProjectPrefetcher::ProjectPrefetcher(const QDomElement& project)
+{
+	struct File
+	{
+		QString path;
+		//! Sample clips play their sample at one position, so long ones are streamed, see SampleBuffer::fromFile()
+		bool streamable;
+	};
+	auto files = std::vector<File>{};
+	auto absolutePaths = std::set<std::pair<QString, bool>>{};
+
+	auto element = project.firstChildElement();
+	while (!element.isNull())
+	{
+		const auto attributes = element.attributes();
+		for (int i = 0; i < attributes.count(); ++i)
+		{
+			const auto attribute = attributes.item(i).toAttr();
+			if (!isFileAttribute(attribute.name()) || attribute.value().isEmpty()) { continue; }
+
+			const auto absolutePath = PathUtil::toAbsolute(attribute.value());
+			const auto streamable = element.tagName() == "sampleclip";
+			if (absolutePaths.contains({absolutePath, streamable}) || !QFileInfo::exists(absolutePath)) { continue; }
+
+			absolutePaths.insert({absolutePath, streamable});
+			files.push_back({attribute.value(), streamable});
+		}
+
+		// Continue with the next element in document order
+		auto next = element.firstChildElement();
+		while (next.isNull() && element != project)
+		{
+			next = element.nextSiblingElement();
+			element = element.parentNode().toElement();
+		}
+		element = next;
+	}
+
+	m_samples.resize(files.size());
+	m_tasks.reserve(files.size());
+	for (auto i = std::size_t{0}; i < files.size(); ++i)
+	{
+		m_tasks.push_back(ThreadPool::instance().enqueue([this, i, file = files[i]] {
+			// Passing the path as stored in the project, so the cache key matches the one used when restoring
+			if (isSampleFile(file.path)) { m_samples[i] = SampleBuffer::fromFile(file.path, file.streamable); }
+			else { warmUp(PathUtil::toAbsolute(file.path)); }
+
+			finishTask();
+		}));
+	}
+}
+
+
+
+
+ProjectPrefetcher::~ProjectPrefetcher()
+{
+	// The futures are ready only once the tasks no longer touch this object
+	for (auto& task : m_tasks)
+	{
+		task.wait();
+	}
+}
+
+
+
+
+auto ProjectPrefetcher::done() const -> std::size_t
+{
+	const auto lock = std::lock_guard{m_mutex};
+	return m_done;
+}
+
+
+
+
+auto ProjectPrefetcher::waitFor(std::chrono::milliseconds timeout) -> bool
+{
+	auto lock = std::unique_lock{m_mutex};
+	return m_finished.wait_for(lock, timeout, [this] { return m_done == m_tasks.size(); });
+}
+
+
+
+
+void ProjectPrefetcher::wait()
+{
+	auto lock = std::unique_lock{m_mutex};
+	m_finished.wait(lock, [this] { return m_done == m_tasks.size(); });
+}
+
+
+
+
+void ProjectPrefetcher::finishTask()
+{
+	const auto lock = std::lock_guard{m_mutex};
+	++m_done;
+	m_finished.notify_all();
+}
+
+} // namespace lmms
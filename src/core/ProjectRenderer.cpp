@@ -23,11 +23,22 @@
  */
 
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <QFile>
 
 #include "ProjectRenderer.h"
+#include "AudioBusHandle.h"
+#include "AudioEngineWorkerThread.h"
+#include "LmmsSemaphore.h"
+#include "LocklessRingBuffer.h"
+#include "MicroTimer.h"
 #include "Song.h"
 #include "PerfLog.h"
+#include "ThreadableJob.h"
+#include "Tracer.h"
 
 #include "AudioFileWave.h"
 #include "AudioFileOgg.h"
@@ -75,28 +86,183 @@ const std::array<ProjectRenderer::FileEncodeDevice, 5> ProjectRenderer::fileEnco
 
 } ;
 
+//! Number of periods rendering may run ahead of encoding
+constexpr auto ENCODER_QUEUE_PERIODS = std::size_t{64};
+
+//! Encodes and writes the rendered periods on its own thread, so encoding
+//! doesn't serialize with rendering
+class ProjectRenderer::Encoder
+{
+public:
+	Encoder(AudioFileDevice* device, std::size_t capacity) :
+		m_device(device),
+		m_queue(capacity),
+		m_reader(m_queue),
+		m_buffer(m_queue.capacity()), // the ring buffer may round the requested capacity up
+		m_framesQueued(0),
+		m_framesEncoded(0),
+		m_thread(&Encoder::run, this)
+	{
+	}
+
+	~Encoder()
+	{
+		finish();
+	}
+
+	//! Queue rendered frames for encoding, waiting for the encoder if the queue is full
+	void write(const SampleFrame* frames, f_cnt_t count)
+	{
+		while (m_queue.free() < count) { m_framesEncoded.wait(); }
+		m_queue.write(frames, count);
+		m_framesQueued.post();
+	}
+
+	//! Encode everything queued and stop the encoder thread
+	void finish()
+	{
+		if (!m_thread.joinable()) { return; }
+		m_done = true;
+		m_framesQueued.post();
+		m_thread.join();
+	}
+
+	//! @returns the time spent encoding in seconds, valid after finish()
+	double encodingTime() const { return m_encodingTime; }
+
+private:
+	void run()
+	{
+		Tracer::setThreadName("Encoder");
+		while (true)
+		{
+			m_framesQueued.wait();
+
+			// everything queued before finish() is visible once m_done is
+			const bool done = m_done;
+			while (const auto available = m_reader.read_space())
+			{
+				const auto frames = std::min(available, m_buffer.size());
+				m_reader.read(frames).copy(m_buffer.data(), frames);
+				m_framesEncoded.post();
+
+				MicroTimer timer;
+				Tracer::Scope traceScope("Encode");
+				m_device->writeBuffer(m_buffer.data(), frames);
+				m_encodingTime += timer.elapsed() / 1e6;
+			}
+			if (done) { break; }
+		}
+	}
+
+	AudioFileDevice* m_device;
+	LocklessRingBuffer<SampleFrame> m_queue;
+	LocklessRingBufferReader<SampleFrame> m_reader;
+	std::vector<SampleFrame> m_buffer;
+	Semaphore m_framesQueued;
+	Semaphore m_framesEncoded;
+	std::atomic<bool> m_done = false;
+	double m_encodingTime = 0.0;
+
+	std::thread m_thread; // started last, after everything it uses is initialized
+};
+
+
+
+
+//! Writes the output of a single audio bus handle into its own file. Writing
+//! (and encoding) the stems of a period is done in parallel on the worker threads.
+class ProjectRenderer::StemWriter : public ThreadableJob
+{
+public:
+	StemWriter(AudioBusHandle* busHandle, AudioFileDevice* device, bool ownsDevice) :
+		m_busHandle(busHandle),
+		m_device(device),
+		m_ownedDevice(ownsDevice ? device : nullptr),
+		m_buffer(Engine::audioEngine()->framesPerPeriod())
+	{
+	}
+
+	AudioFileDevice* device() { return m_device; }
+
+	void attach() { m_busHandle->setOutputTap(m_buffer.data()); }
+	void detach() { m_busHandle->setOutputTap(nullptr); }
+
+	bool requiresProcessing() const override { return true; }
+
+protected:
+	void doProcessing() override
+	{
+		Tracer::Scope traceScope("Encode stem");
+		m_device->writeBuffer(m_buffer.data(), m_buffer.size());
+	}
+
+private:
+	AudioBusHandle* m_busHandle;
+	AudioFileDevice* m_device;
+	std::unique_ptr<AudioFileDevice> m_ownedDevice;
+	std::vector<SampleFrame> m_buffer;
+};
+
+
+
+
 ProjectRenderer::ProjectRenderer(
 	const OutputSettings& outputSettings, ExportFileFormat exportFileFormat, const QString& outputFilename)
 	: QThread(Engine::audioEngine())
-	, m_fileDev(nullptr)
+	, m_fileDev(createFileDevice(outputSettings, exportFileFormat, outputFilename))
 	, m_progress(0)
 	, m_abort(false)
 {
-	AudioFileDeviceInstantiaton audioEncoderFactory = fileEncodeDevices[static_cast<std::size_t>(exportFileFormat)].m_getDevInst;
+}
+
+
+
 
-	if (audioEncoderFactory)
+ProjectRenderer::ProjectRenderer(
+	const OutputSettings& outputSettings, ExportFileFormat exportFileFormat, const std::vector<Stem>& stems)
+	: QThread(Engine::audioEngine())
+	, m_fileDev(nullptr)
+	, m_progress(0)
+	, m_abort(false)
+{
+	for (const auto& [busHandle, outputFilename] : stems)
 	{
-		bool successful = false;
+		AudioFileDevice* device = createFileDevice(outputSettings, exportFileFormat, outputFilename);
+		if (!device) { continue; }
+
+		// the audio engine needs a device to render to - use the first stem's
+		// one. It doesn't get the master output though, just like the others.
+		const bool isEngineDevice = m_fileDev == nullptr;
+		if (isEngineDevice) { m_fileDev = device; }
+		m_stems.push_back(std::make_unique<StemWriter>(busHandle, device, !isEngineDevice));
+	}
+}
 
-		m_fileDev = audioEncoderFactory(
-					outputFilename, outputSettings, DEFAULT_CHANNELS,
-					Engine::audioEngine(), successful );
-		if( !successful )
-		{
-			delete m_fileDev;
-			m_fileDev = nullptr;
-		}
+
+
+
+ProjectRenderer::~ProjectRenderer() = default;
+
+
+
+
+AudioFileDevice* ProjectRenderer::createFileDevice(
+	const OutputSettings& outputSettings, ExportFileFormat fileFormat, const QString& outputFilename)
+{
+	AudioFileDeviceInstantiaton audioEncoderFactory = fileEncodeDevices[static_cast<std::size_t>(fileFormat)].m_getDevInst;
+	if (!audioEncoderFactory) { return nullptr; }
+
+	bool successful = false;
+	AudioFileDevice* device = audioEncoderFactory(
+				outputFilename, outputSettings, DEFAULT_CHANNELS,
+				Engine::audioEngine(), successful );
+	if( !successful )
+	{
+		delete device;
+		return nullptr;
 	}
+	return device;
 }
 
 
@@ -154,6 +320,17 @@ void ProjectRenderer::startProcessing()
 void ProjectRenderer::run()
 {
 	PerfLogTimer perfLog("Project Render");
+	Tracer::setThreadName("Renderer");
+	const auto exportStart = std::chrono::steady_clock::now();
+	m_statistics = Statistics{};
+	m_succeeded = false;
+
+	for (auto& stem : m_stems) { stem->attach(); }
+	if (m_stems.empty())
+	{
+		m_encoder = std::make_unique<Encoder>(
+			m_fileDev, ENCODER_QUEUE_PERIODS * Engine::audioEngine()->framesPerPeriod());
+	}
 
 	Engine::getSong()->startExport();
 	// Skip first empty buffer.
@@ -165,10 +342,25 @@ void ProjectRenderer::run()
 	Engine::audioEngine()->startProcessing();
 
 	// Continually track and emit progress percentage to listeners.
+	auto framesRendered = std::size_t{0};
 	while (!Engine::getSong()->isExportDone() && !m_abort)
 	{
+		MicroTimer timer;
 		const auto buffer = Engine::audioEngine()->renderNextPeriod();
-		m_fileDev->writeBuffer(buffer.data(), buffer.size());
+		m_statistics.rendering += timer.elapsed() / 1e6;
+		framesRendered += buffer.size();
+
+		timer.reset();
+		if (m_encoder)
+		{
+			m_encoder->write(buffer.data(), buffer.size());
+			m_statistics.encoderWait += timer.elapsed() / 1e6;
+		}
+		else
+		{
+			writeStems();
+			m_statistics.encoding += timer.elapsed() / 1e6;
+		}
 
 		const int nprog = Engine::getSong()->getExportProgress();
 		if (m_progress != nprog)
@@ -178,19 +370,52 @@ void ProjectRenderer::run()
 		}
 	}
 
+	if (m_encoder)
+	{
+		// let the encoder catch up before the file gets finalized
+		MicroTimer timer;
+		m_encoder->finish();
+		m_statistics.encoderWait += timer.elapsed() / 1e6;
+		m_statistics.encoding = m_encoder->encodingTime();
+		m_encoder.reset();
+	}
+
 	// Notify the audio engine of the end of processing.
 	Engine::audioEngine()->stopProcessing();
 
 	Engine::getSong()->stopExport();
 
+	for (auto& stem : m_stems) { stem->detach(); }
+
+	m_statistics.audioLength = static_cast<double>(framesRendered) / Engine::audioEngine()->outputSampleRate();
+	m_statistics.total = std::chrono::duration<double>(std::chrono::steady_clock::now() - exportStart).count();
+
 	perfLog.end();
 
-	// If the user aborted export-process, the file has to be deleted.
-	const QString f = m_fileDev->outputFile();
+	m_succeeded = !m_abort;
+
+	// If the user aborted export-process, the files have to be deleted.
 	if( m_abort )
 	{
-		QFile( f ).remove();
+		QFile(m_fileDev->outputFile()).remove();
+		for (auto& stem : m_stems)
+		{
+			QFile(stem->device()->outputFile()).remove();
+		}
+	}
+}
+
+
+
+
+void ProjectRenderer::writeStems()
+{
+	AudioEngineWorkerThread::resetJobQueue();
+	for (auto& stem : m_stems)
+	{
+		AudioEngineWorkerThread::addJob(stem.get());
 	}
+	AudioEngineWorkerThread::startAndWaitForJobs();
 }
 
 
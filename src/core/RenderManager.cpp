@@ -22,12 +22,17 @@
  *
  */
 
+#include <cstdio>
 #include <QDir>
 #include <QRegularExpression>
 
 #include "RenderManager.h"
 
+#include "BufferManager.h"
+#include "InstrumentTrack.h"
+#include "NotePlayHandle.h"
 #include "PatternStore.h"
+#include "SampleTrack.h"
 #include "Song.h"
 
 
@@ -52,15 +57,30 @@ void RenderManager::abortProcessing()
 {
 	if ( m_activeRenderer ) {
 		disconnect( m_activeRenderer.get(), SIGNAL(finished()),
-				this, SLOT(renderNextTrack()));
+				this, SLOT(renderFinished()));
 		m_activeRenderer->abortProcessing();
 	}
+	m_tracksToRender.clear();
 	restoreMutedState();
 }
 
-// Called to render each new track when rendering tracks individually.
-void RenderManager::renderNextTrack()
+void RenderManager::renderFinished()
 {
+	if (m_activeRenderer)
+	{
+		// when rendering tracks one after another, sum up the timings of all passes
+		const auto& statistics = m_activeRenderer->statistics();
+		m_statistics.audioLength += statistics.audioLength;
+		m_statistics.total += statistics.total;
+		m_statistics.rendering += statistics.rendering;
+		m_statistics.encoding += statistics.encoding;
+		m_statistics.encoderWait += statistics.encoderWait;
+		m_succeeded = m_succeeded && m_activeRenderer->hasSucceeded();
+	}
+	else
+	{
+		m_succeeded = false;
+	}
 	m_activeRenderer.reset();
 
 	if (m_tracksToRender.empty())
@@ -71,70 +91,96 @@ void RenderManager::renderNextTrack()
 	}
 	else
 	{
-		// pop the next track from our rendering queue
-		Track* renderTrack = m_tracksToRender.back();
-		m_tracksToRender.pop_back();
-
-		// mute everything but the track we are about to render
-		for (auto track : m_unmuted)
-		{
-			track->setMuted(track != renderTrack);
-		}
+		renderNextTrack();
+	}
+}
 
-		// for multi-render, prefix each output file with a different number
-		int trackNum = m_tracksToRender.size() + 1;
+// Called to render each new track when rendering tracks individually.
+void RenderManager::renderNextTrack()
+{
+	// pop the next track from our rendering queue
+	Track* renderTrack = m_tracksToRender.back();
+	m_tracksToRender.pop_back();
 
-		render( pathForTrack(renderTrack, trackNum) );
+	// mute everything but the track we are about to render
+	for (auto track : m_unmuted)
+	{
+		track->setMuted(track != renderTrack);
 	}
+
+	// for multi-render, prefix each output file with a different number
+	int trackNum = m_tracksToRender.size() + 1;
+
+	render(std::make_unique<ProjectRenderer>(m_outputSettings, m_format, pathForTrack(renderTrack, trackNum)));
 }
 
 // Render the song into individual tracks
-void RenderManager::renderTracks()
+void RenderManager::renderTracks(StemSource source)
 {
-	const TrackContainer::TrackList& tl = Engine::getSong()->tracks();
-
-	// find all currently unnmuted tracks -- we want to render these.
-	for (const auto& tk : tl)
+	// find all currently unmuted instrument and sample tracks -- we want to render these.
+	auto addTracks = [&](const TrackContainer::TrackList& tracks)
 	{
-		Track::Type type = tk->type();
-
-		// Don't render automation tracks
-		if ( tk->isMuted() == false &&
-				( type == Track::Type::Instrument || type == Track::Type::Sample ) )
+		for (const auto& tk : tracks)
 		{
-			m_unmuted.push_back(tk);
+			if (!tk->isMuted() && (tk->type() == Track::Type::Instrument || tk->type() == Track::Type::Sample))
+			{
+				m_unmuted.push_back(tk);
+			}
 		}
-	}
+	};
+	addTracks(Engine::getSong()->tracks());
+	addTracks(Engine::patternStore()->tracks());
 
-	const TrackContainer::TrackList& t2 = Engine::patternStore()->tracks();
-	for (const auto& tk : t2)
-	{
-		Track::Type type = tk->type();
+	m_statistics = ProjectRenderer::Statistics{};
+	m_succeeded = true;
 
-		// Don't render automation tracks
-		if ( tk->isMuted() == false &&
-				( type == Track::Type::Instrument || type == Track::Type::Sample ) )
+	if (source == StemSource::Track)
+	{
+		// tap the output of all tracks at once, nothing needs to be muted
+		auto stems = std::vector<ProjectRenderer::Stem>{};
+		for (const auto& tk : m_unmuted)
 		{
-			m_unmuted.push_back(tk);
+			// for multi-render, prefix each output file with a different number
+			const int trackNum = stems.size() + 1;
+			if (auto instrumentTrack = dynamic_cast<InstrumentTrack*>(tk))
+			{
+				stems.emplace_back(instrumentTrack->audioBusHandle(), pathForTrack(tk, trackNum));
+			}
+			else if (auto sampleTrack = dynamic_cast<SampleTrack*>(tk))
+			{
+				stems.emplace_back(sampleTrack->audioBusHandle(), pathForTrack(tk, trackNum));
+			}
 		}
+		m_unmuted.clear();
+
+		render(std::make_unique<ProjectRenderer>(m_outputSettings, m_format, stems));
+		return;
 	}
 
 	// copy the list of unmuted tracks into our rendering queue.
 	// we need to remember which tracks were unmuted to restore state at the end.
 	m_tracksToRender = m_unmuted;
 
+	if (m_tracksToRender.empty())
+	{
+		renderFinished();
+		return;
+	}
+
 	renderNextTrack();
 }
 
 // Render the song into a single track
 void RenderManager::renderProject()
 {
-	render( m_outputPath );
+	m_statistics = ProjectRenderer::Statistics{};
+	m_succeeded = true;
+	render(std::make_unique<ProjectRenderer>(m_outputSettings, m_format, m_outputPath));
 }
 
-void RenderManager::render(QString outputPath)
+void RenderManager::render(std::unique_ptr<ProjectRenderer> renderer)
 {
-	m_activeRenderer = std::make_unique<ProjectRenderer>(m_outputSettings, m_format, outputPath);
+	m_activeRenderer = std::move(renderer);
 
 	if( m_activeRenderer->isReady() )
 	{
@@ -142,17 +188,15 @@ void RenderManager::render(QString outputPath)
 		connect( m_activeRenderer.get(), SIGNAL(progressChanged(int)),
 				this, SIGNAL(progressChanged(int)));
 
-		// when it is finished, render the next track.
-		// if we have not queued any tracks, renderNextTrack will just clean up
 		connect( m_activeRenderer.get(), SIGNAL(finished()),
-				this, SLOT(renderNextTrack()));
+				this, SLOT(renderFinished()));
 
 		m_activeRenderer->startProcessing();
 	}
 	else
 	{
 		qDebug( "Renderer failed to acquire a file device!" );
-		renderNextTrack();
+		renderFinished();
 	}
 }
 
@@ -193,5 +237,23 @@ void RenderManager::updateConsoleProgress()
 	}
 }
 
+void RenderManager::printStatistics() const
+{
+	// the progress bar doesn't end its line
+	fprintf(stderr, "\n\nRendered %.1f s of audio in %.1f s (%.1fx realtime)\n",
+		m_statistics.audioLength, m_statistics.total, m_statistics.realtimeFactor());
+	fprintf(stderr, "  Rendering:           %8.2f s\n", m_statistics.rendering);
+	fprintf(stderr, "  Encoding:            %8.2f s\n", m_statistics.encoding);
+	fprintf(stderr, "  Waiting for encoder: %8.2f s\n", m_statistics.encoderWait);
+
+	const auto buffers = BufferManager::statistics();
+	fprintf(stderr, "Play handle buffers: %zu used at most, %zu preallocated, %zu dropped (pool exhausted)\n",
+		buffers.highWaterMark, buffers.capacity, buffers.failedAllocations);
+
+	const auto notes = NotePlayHandleManager::statistics();
+	fprintf(stderr, "Note play handles:   %zu used at most, %zu preallocated, %zu dropped (pool exhausted)\n",
+		notes.highWaterMark, notes.capacity, notes.failedAllocations);
+}
+
 
 } // namespace lmms
\ No newline at end of file
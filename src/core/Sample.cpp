@@ -24,6 +24,12 @@
 
 #include "Sample.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "SampleStream.h"
+#include "Song.h"
+
 namespace lmms {
 
 Sample::Sample(const SampleFrame* data, size_t numFrames, int sampleRate)
@@ -42,6 +48,7 @@ Sample::Sample(std::shared_ptr<const SampleBuffer> buffer)
 	, m_loopStartFrame(0)
 	, m_loopEndFrame(m_buffer->size())
 {
+	openStream();
 }
 
 Sample::Sample(const Sample& other)
@@ -54,6 +61,7 @@ Sample::Sample(const Sample& other)
 	, m_frequency(other.frequency())
 	, m_reversed(other.reversed())
 {
+	openStream();
 }
 
 Sample::Sample(Sample&& other) noexcept
@@ -65,11 +73,18 @@ Sample::Sample(Sample&& other) noexcept
 	, m_amplification(other.amplification())
 	, m_frequency(other.frequency())
 	, m_reversed(other.reversed())
+	, m_stream(std::exchange(other.m_stream, nullptr))
 {
 }
 
+Sample::~Sample()
+{
+	closeStream();
+}
+
 auto Sample::operator=(const Sample& other) -> Sample&
 {
+	closeStream();
 	m_buffer = other.m_buffer;
 	m_startFrame = other.startFrame();
 	m_endFrame = other.endFrame();
@@ -78,12 +93,14 @@ auto Sample::operator=(const Sample& other) -> Sample&
 	m_amplification = other.amplification();
 	m_frequency = other.frequency();
 	m_reversed = other.reversed();
+	openStream();
 
 	return *this;
 }
 
 auto Sample::operator=(Sample&& other) noexcept -> Sample&
 {
+	closeStream();
 	m_buffer = std::move(other.m_buffer);
 	m_startFrame = other.startFrame();
 	m_endFrame = other.endFrame();
@@ -92,6 +109,7 @@ auto Sample::operator=(Sample&& other) noexcept -> Sample&
 	m_amplification = other.amplification();
 	m_frequency = other.frequency();
 	m_reversed = other.reversed();
+	m_stream = std::exchange(other.m_stream, nullptr);
 
 	return *this;
 }
@@ -134,6 +152,28 @@ bool Sample::play(SampleFrame* dst, PlaybackState* state, size_t numFrames, Loop
 }
 
 f_cnt_t Sample::render(SampleFrame* dst, f_cnt_t size, PlaybackState* state, Loop loop) const
+{
+	if (!m_stream) { return render(dst, size, state, loop, m_buffer->data()); }
+
+	// Let the I/O thread know where playback continues
+	m_stream->setPosition(bufferFrame(state->m_frameIndex), state->m_backwards != m_reversed);
+
+	// An export must not lose any frames and may wait for the disk. The I/O thread still reads ahead,
+	// so the mapped pages are mostly resident by the time they are rendered.
+	if (const auto song = Engine::getSong(); song && song->isExporting())
+	{
+		return render(dst, size, state, loop, m_buffer->data());
+	}
+
+	auto view = SampleStream::View{*m_stream};
+	const auto rendered = render(dst, size, state, loop, view);
+	// Reading frames that were not read ahead from the mapping could wait for the disk
+	if (!view.complete()) { std::fill_n(dst, rendered, SampleFrame{}); }
+	return rendered;
+}
+
+template<typename Source>
+f_cnt_t Sample::render(SampleFrame* dst, f_cnt_t size, PlaybackState* state, Loop loop, Source&& source) const
 {
 	for (f_cnt_t frame = 0; frame < size; ++frame)
 	{
@@ -166,7 +206,7 @@ f_cnt_t Sample::render(SampleFrame* dst, f_cnt_t size, PlaybackState* state, Loo
 		}
 
 		const auto value
-			= m_buffer->data()[m_reversed ? m_buffer->size() - state->m_frameIndex - 1 : state->m_frameIndex]
+			= source[m_reversed ? m_buffer->size() - state->m_frameIndex - 1 : state->m_frameIndex]
 			* m_amplification;
 		dst[frame] = value;
 		state->m_backwards ? --state->m_frameIndex : ++state->m_frameIndex;
@@ -182,6 +222,11 @@ auto Sample::sampleDuration() const -> std::chrono::milliseconds
 	return std::chrono::milliseconds{static_cast<int>(duration)};
 }
 
+void Sample::prefetch(int frameIndex) const
+{
+	if (m_stream) { m_stream->prefetch(bufferFrame(frameIndex), m_reversed); }
+}
+
 void Sample::setAllPointFrames(int startFrame, int endFrame, int loopStartFrame, int loopEndFrame)
 {
 	setStartFrame(startFrame);
@@ -190,4 +235,21 @@ void Sample::setAllPointFrames(int startFrame, int endFrame, int loopStartFrame,
 	setLoopEndFrame(loopEndFrame);
 }
 
+void Sample::openStream()
+{
+	if (m_buffer->isMapped()) { m_stream = SampleStream::open(m_buffer, bufferFrame(startFrame()), m_reversed); }
+}
+
+void Sample::closeStream()
+{
+	if (m_stream) { std::exchange(m_stream, nullptr)->close(); }
+}
+
+auto Sample::bufferFrame(int frameIndex) const -> f_cnt_t
+{
+	const auto size = static_cast<int>(m_buffer->size());
+	const auto index = std::clamp(frameIndex, 0, std::max(size - 1, 0));
+	return m_reversed ? size - index - 1 : index;
+}
+
 } // namespace lmms
@@ -24,16 +24,90 @@
 
 #include "SampleBuffer.h"
 
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QDomElement>
+#include <QFileInfo>
 #include <QMessageBox>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 #include "GuiApplication.h"
 #include "PathUtil.h"
+#include "ProjectArchive.h"
 #include "SampleDecoder.h"
 
 namespace lmms {
 
+namespace {
+
+//! Identifies a file on disk, so that a changed file is decoded again
+struct CacheKey
+{
+	QString canonicalPath;
+	QString storedPath;
+	qint64 lastModified;
+	qint64 size;
+	//! Whether the buffer may be memory-mapped, see SampleBuffer::fromFile()
+	bool streamable;
+
+	friend auto operator<(const CacheKey& lhs, const CacheKey& rhs) -> bool
+	{
+		return std::tie(lhs.canonicalPath, lhs.storedPath, lhs.lastModified, lhs.size, lhs.streamable)
+			< std::tie(rhs.canonicalPath, rhs.storedPath, rhs.lastModified, rhs.size, rhs.streamable);
+	}
+};
+
+struct CacheEntry
+{
+	//! Not owning, so a sample is freed as soon as nothing uses it anymore
+	std::weak_ptr<const SampleBuffer> buffer;
+	//! Valid while the file is being decoded, so other callers wait for that instead of decoding it too
+	std::shared_future<std::shared_ptr<const SampleBuffer>> pending;
+};
+
+std::mutex s_cacheMutex;
+std::map<CacheKey, CacheEntry> s_cache;
+std::atomic<std::size_t> s_cachedBytes = 0;
+
+//! Files decoding to at least this many bytes are memory-mapped from the decoded sample cache
+constexpr auto MinMappedBytes = std::size_t{64} << 20;
+
+//! Precedes the frames of a sample in the decoded sample cache. Any change of the format requires a new version.
+struct DecodedSampleHeader
+{
+	char magic[4] = {'L', 'D', 'S', 'C'};
+	std::uint32_t version = 1;
+	//! Size and modification time of the source file, to detect when it changed
+	std::int64_t sourceSize = 0;
+	std::int64_t sourceModified = 0;
+	std::uint64_t frames = 0;
+	std::int32_t sampleRate = 0;
+	std::uint32_t reserved = 0;
+
+	bool operator==(const DecodedSampleHeader&) const = default;
+};
+
+auto readDecodedSampleHeader(QFile& file) -> std::optional<DecodedSampleHeader>
+{
+	auto header = DecodedSampleHeader{};
+	if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)) { return std::nullopt; }
+	return header;
+}
+
+} // namespace
+
 SampleBuffer::SampleBuffer(const SampleFrame* data, size_t numFrames, int sampleRate)
 	: m_data(data, data + numFrames)
 	, m_sampleRate(sampleRate)
@@ -47,10 +121,21 @@ SampleBuffer::SampleBuffer(std::vector<SampleFrame> data, int sampleRate, const
 {
 }
 
+SampleBuffer::SampleBuffer(std::shared_ptr<const void> mapping, std::span<const SampleFrame> data, int sampleRate,
+	const QString& audioFile)
+	: m_mapping(std::move(mapping))
+	, m_mappedData(data)
+	, m_audioFile(audioFile)
+	, m_sampleRate(sampleRate)
+{
+}
+
 void swap(SampleBuffer& first, SampleBuffer& second) noexcept
 {
 	using std::swap;
 	swap(first.m_data, second.m_data);
+	swap(first.m_mapping, second.m_mapping);
+	swap(first.m_mappedData, second.m_mappedData);
 	swap(first.m_audioFile, second.m_audioFile);
 	swap(first.m_sampleRate, second.m_sampleRate);
 }
@@ -58,8 +143,8 @@ void swap(SampleBuffer& first, SampleBuffer& second) noexcept
 QString SampleBuffer::toBase64() const
 {
 	// TODO: Replace with non-Qt equivalent
-	const auto data = reinterpret_cast<const char*>(m_data.data());
-	const auto size = static_cast<int>(m_data.size() * sizeof(SampleFrame));
+	const auto data = reinterpret_cast<const char*>(this->data());
+	const auto size = static_cast<int>(this->size() * sizeof(SampleFrame));
 	const auto byteArray = QByteArray{data, size};
 	return byteArray.toBase64();
 }
@@ -70,12 +155,13 @@ auto SampleBuffer::emptyBuffer() -> std::shared_ptr<const SampleBuffer>
 	return s_buffer;
 }
 
-std::shared_ptr<const SampleBuffer> SampleBuffer::fromFile(const QString& filePath)
+auto SampleBuffer::decodeFile(const QString& absolutePath, const QString& storedPath, bool streamable)
+	-> std::shared_ptr<const SampleBuffer>
 {
-	if (filePath.isEmpty()) { return SampleBuffer::emptyBuffer(); }
-
-	const auto absolutePath = PathUtil::toAbsolute(filePath);
-	const auto storedPath = PathUtil::toShortestRelative(filePath);
+	if (streamable)
+	{
+		if (auto buffer = mapDecodedFile(absolutePath, storedPath)) { return buffer; }
+	}
 
 	auto result = SampleDecoder::decode(absolutePath);
 
@@ -83,7 +169,8 @@ std::shared_ptr<const SampleBuffer> SampleBuffer::fromFile(const QString& filePa
 	{
 		// TODO: Improve error handling. We dont always want to show a message box on failure when there is a GUI (e.g.
 		// when loading the project), and this function also shouldn't be concerned with handling the error.
-		if (gui::getGUI())
+		// Samples may also be decoded on worker threads (see ProjectPrefetcher), which must not show any widgets.
+		if (gui::getGUI() && QThread::currentThread() == QCoreApplication::instance()->thread())
 		{
 			QMessageBox::warning(nullptr, QObject::tr("Failed to load sample"),
 				QObject::tr("The sample may be corrupted or unsupported."));
@@ -99,15 +186,179 @@ std::shared_ptr<const SampleBuffer> SampleBuffer::fromFile(const QString& filePa
 	}
 
 	auto& [data, sampleRate] = *result;
-	return std::make_shared<SampleBuffer>(std::move(data), sampleRate, storedPath);
+	const auto bytes = data.size() * sizeof(SampleFrame);
+	s_cachedBytes += bytes;
+
+	// The deleter must not lock the cache, since the last reference may be dropped while it is locked.
+	// Expired entries are removed when the next file is added instead.
+	return std::shared_ptr<const SampleBuffer>{new SampleBuffer(std::move(data), sampleRate, storedPath),
+		[bytes](const SampleBuffer* buffer) {
+			s_cachedBytes -= bytes;
+			delete buffer;
+		}};
+}
+
+auto SampleBuffer::mapDecodedFile(const QString& absolutePath, const QString& storedPath)
+	-> std::shared_ptr<const SampleBuffer>
+{
+	const auto info = SampleDecoder::info(absolutePath);
+	if (!info || info->frames * sizeof(SampleFrame) < MinMappedBytes) { return nullptr; }
+
+	const auto cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+	const auto cacheDir = cacheLocation + "/samples";
+	if (cacheLocation.isEmpty() || !QDir{}.mkpath(cacheDir)) { return nullptr; }
+
+	const auto source = QFileInfo{absolutePath};
+	const auto name = QCryptographicHash::hash(source.canonicalFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+	const auto cachePath = QString{"%1/%2.raw"}.arg(cacheDir, QString::fromLatin1(name));
+	auto expected = DecodedSampleHeader{
+		.sourceSize = source.size(), .sourceModified = source.lastModified().toMSecsSinceEpoch()};
+
+	const auto file = std::make_shared<QFile>(cachePath);
+	auto header = file->open(QIODevice::ReadOnly) ? readDecodedSampleHeader(*file) : std::nullopt;
+	const auto matches = [&] {
+		return header && *header == DecodedSampleHeader{.sourceSize = expected.sourceSize,
+			.sourceModified = expected.sourceModified, .frames = header->frames, .sampleRate = header->sampleRate};
+	};
+
+	if (!matches())
+	{
+		file->close();
+
+		// written to a temporary file first, so other instances never map an incomplete cache
+		auto output = QSaveFile{cachePath};
+		if (!output.open(QIODevice::WriteOnly)) { return nullptr; }
+		output.write(reinterpret_cast<const char*>(&expected), sizeof(expected));
+
+		const auto decoded = SampleDecoder::decode(absolutePath, output);
+		if (!decoded) { return nullptr; }
+		expected.frames = decoded->frames;
+		expected.sampleRate = decoded->sampleRate;
+		if (!output.seek(0) || output.write(reinterpret_cast<const char*>(&expected), sizeof(expected)) != sizeof(expected)
+			|| !output.commit())
+		{
+			return nullptr;
+		}
+
+		if (!file->open(QIODevice::ReadOnly)) { return nullptr; }
+		header = readDecodedSampleHeader(*file);
+		if (!matches()) { return nullptr; }
+	}
+
+	const auto frames = static_cast<std::size_t>(header->frames);
+	const auto bytes = static_cast<qint64>(frames * sizeof(SampleFrame));
+	if (frames == 0 || file->size() != static_cast<qint64>(sizeof(DecodedSampleHeader)) + bytes) { return nullptr; }
+
+	const auto mapped = file->map(sizeof(DecodedSampleHeader), bytes);
+	if (!mapped) { return nullptr; }
+
+	auto mapping = std::shared_ptr<const void>{mapped, [file](const void* data) {
+		file->unmap(static_cast<uchar*>(const_cast<void*>(data)));
+	}};
+	const auto data = std::span{reinterpret_cast<const SampleFrame*>(mapped), frames};
+	return std::shared_ptr<const SampleBuffer>{
+		new SampleBuffer(std::move(mapping), data, header->sampleRate, storedPath)};
+}
+
+std::shared_ptr<const SampleBuffer> SampleBuffer::fromFile(const QString& filePath, bool streamable)
+{
+	if (filePath.isEmpty()) { return SampleBuffer::emptyBuffer(); }
+
+	const auto absolutePath = PathUtil::toAbsolute(filePath);
+	const auto storedPath = PathUtil::toShortestRelative(filePath);
+
+	const auto info = QFileInfo{absolutePath};
+	const auto canonicalPath = info.canonicalFilePath();
+	// The file doesn't exist, let decoding fail and report it
+	if (canonicalPath.isEmpty()) { return decodeFile(absolutePath, storedPath, streamable); }
+
+	const auto key
+		= CacheKey{canonicalPath, storedPath, info.lastModified().toMSecsSinceEpoch(), info.size(), streamable};
+	auto otherKey = key;
+	otherKey.streamable = !streamable;
+	auto promise = std::promise<std::shared_ptr<const SampleBuffer>>{};
+	auto pending = std::shared_future<std::shared_ptr<const SampleBuffer>>{};
+
+	{
+		const auto lock = std::lock_guard{s_cacheMutex};
+
+		// Buffers held in memory can be played from any number of positions, so they are shared either way
+		if (const auto other = s_cache.find(otherKey); other != s_cache.end())
+		{
+			if (auto buffer = other->second.buffer.lock(); buffer && !buffer->isMapped()) { return buffer; }
+		}
+
+		auto& entry = s_cache[key];
+		if (auto buffer = entry.buffer.lock()) { return buffer; }
+
+		if (entry.pending.valid()) { pending = entry.pending; }
+		else { entry.pending = promise.get_future().share(); }
+	}
+
+	if (pending.valid()) { return pending.get(); }
+
+	auto buffer = decodeFile(absolutePath, storedPath, streamable);
+
+	{
+		const auto lock = std::lock_guard{s_cacheMutex};
+		for (auto it = s_cache.begin(); it != s_cache.end();)
+		{
+			if (it->second.buffer.expired() && !it->second.pending.valid()) { it = s_cache.erase(it); }
+			else { ++it; }
+		}
+
+		// Failures are not cached, so the file is tried again next time
+		if (buffer == SampleBuffer::emptyBuffer()) { s_cache.erase(key); }
+		else { s_cache[key] = CacheEntry{buffer, {}}; }
+	}
+
+	promise.set_value(buffer);
+	return buffer;
+}
+
+auto SampleBuffer::cachedMemoryUsage() -> std::size_t
+{
+	return s_cachedBytes;
 }
 
 std::shared_ptr<const SampleBuffer> SampleBuffer::fromBase64(const QString& str, int sampleRate)
 {
 	if (str.isEmpty()) { return SampleBuffer::emptyBuffer(); }
 
-	const auto bytes = QByteArray::fromBase64(str.toUtf8());
+	return fromBytes(QByteArray::fromBase64(str.toUtf8()), sampleRate);
+}
+
+std::shared_ptr<const SampleBuffer> SampleBuffer::fromAttribute(
+	const QDomElement& element, const QString& attribute, int sampleRate)
+{
+	const auto value = element.attribute(attribute);
+	if (!ProjectArchive::isChunkReference(value)) { return fromBase64(value, sampleRate); }
+
+	// Only this sample's chunk is read from the archive the project was loaded from
+	const auto path = element.ownerDocument().documentElement().attribute(ProjectArchive::PathAttribute);
+	const auto archive = ProjectArchive::open(path);
+	const auto bytes = archive ? archive->read(ProjectArchive::chunkName(value)) : QByteArray{};
 
+	if (bytes.isEmpty())
+	{
+		if (gui::getGUI() && QThread::currentThread() == QCoreApplication::instance()->thread())
+		{
+			QMessageBox::warning(nullptr, QObject::tr("Failed to load sample"),
+				QObject::tr("The sample data is missing from the project or corrupted."));
+		}
+		else
+		{
+			qWarning() << QObject::tr("Failed to load sample %1 from project archive %2").arg(value, path);
+		}
+
+		return SampleBuffer::emptyBuffer();
+	}
+
+	return fromBytes(bytes, sampleRate);
+}
+
+std::shared_ptr<const SampleBuffer> SampleBuffer::fromBytes(const QByteArray& bytes, int sampleRate)
+{
 	if (bytes.size() % sizeof(SampleFrame) != 0)
 	{
 		// TODO: Improve error handling. We dont always want to show a message box on failure when there is a GUI (e.g.
@@ -119,7 +370,7 @@ std::shared_ptr<const SampleBuffer> SampleBuffer::fromBase64(const QString& str,
 		}
 		else
 		{
-			qWarning() << QObject::tr("Failed to load Base64 sample, invalid size");
+			qWarning() << QObject::tr("Failed to load sample data, invalid size");
 		}
 
 		return SampleBuffer::emptyBuffer();
@@ -26,6 +26,7 @@
 
 #include <QDomElement>
 #include <QFileInfo>
+#include <algorithm>
 
 #include "PatternStore.h"
 #include "PathUtil.h"
@@ -54,6 +55,7 @@ SampleClip::SampleClip(Track* _track, Sample sample, bool isPlaying):
 	//playbutton clicked or space key / on Export Song set isPlaying to false
 	connect( Engine::getSong(), SIGNAL(playbackStateChanged()),
 			this, SLOT(playbackPositionChanged()), Qt::DirectConnection );
+	connect(Engine::getSong(), &Song::playbackStateChanged, this, &SampleClip::prefetchSample);
 	//care about loops and jumps
 	connect(Engine::getSong(), &Song::playbackPositionJumped,
 			this, &SampleClip::playbackPositionChanged, Qt::DirectConnection);
@@ -92,6 +94,7 @@ SampleClip::SampleClip(const SampleClip& orig) :
 	//playbutton clicked or space key / on Export Song set isPlaying to false
 	connect( Engine::getSong(), SIGNAL(playbackStateChanged()),
 			this, SLOT(playbackPositionChanged()), Qt::DirectConnection );
+	connect(Engine::getSong(), &Song::playbackStateChanged, this, &SampleClip::prefetchSample);
 	//care about loops and jumps
 	connect(Engine::getSong(), &Song::playbackPositionJumped,
 			this, &SampleClip::playbackPositionChanged, Qt::DirectConnection);
@@ -157,7 +160,7 @@ void SampleClip::setSampleFile(const QString& sf)
 	setStartTimeOffset(0);
 	if (!sf.isEmpty())
 	{
-		m_sample = Sample(SampleBuffer::fromFile(sf));
+		m_sample = Sample(SampleBuffer::fromFile(sf, true));
 		updateLength();
 	}
 	else
@@ -194,6 +197,22 @@ void SampleClip::playbackPositionChanged()
 
 
 
+void SampleClip::prefetchSample()
+{
+	// Playback is started on the GUI thread, so the sample can be read ahead before the audio thread plays it
+	const auto song = Engine::getSong();
+	if (!song->isPlaying() || song->playMode() != Song::PlayMode::Song) { return; }
+
+	const auto position = std::max(song->getPlayPos(), startPosition());
+	if (position >= endPosition()) { return; }
+
+	const auto framesPerTick = Engine::framesPerTick(m_sample.sampleRate());
+	m_sample.prefetch(std::max(0, static_cast<int>(framesPerTick * (position - startPosition() - startTimeOffset()))));
+}
+
+
+
+
 void SampleClip::updateTrackClips()
 {
 	auto sampletrack = dynamic_cast<SampleTrack*>(getTrack());
@@ -335,7 +354,7 @@ void SampleClip::loadSettings( const QDomElement & _this )
 		auto sampleRate = _this.hasAttribute("sample_rate") ? _this.attribute("sample_rate").toInt() :
 			Engine::audioEngine()->outputSampleRate();
 
-		auto buffer = SampleBuffer::fromBase64(_this.attribute("data"), sampleRate);
+		auto buffer = SampleBuffer::fromAttribute(_this, "data", sampleRate);
 		m_sample = Sample(std::move(buffer));
 	}
 	changeLength( _this.attribute( "len" ).toInt() );
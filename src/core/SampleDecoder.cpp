@@ -232,4 +232,58 @@ auto SampleDecoder::decode(const QString& audioFile) -> std::optional<Result>
 	return result;
 }
 
+auto SampleDecoder::info(const QString& audioFile) -> std::optional<Info>
+{
+	auto sfInfo = SF_INFO{};
+
+	auto file = QFile{audioFile};
+	if (!file.open(QIODevice::ReadOnly)) { return std::nullopt; }
+
+	const auto sndFile = sf_open_fd(file.handle(), SFM_READ, &sfInfo, false);
+	if (sf_error(sndFile) != 0) { return std::nullopt; }
+	sf_close(sndFile);
+
+	return Info{static_cast<f_cnt_t>(sfInfo.frames), static_cast<int>(sfInfo.samplerate)};
+}
+
+auto SampleDecoder::decode(const QString& audioFile, QIODevice& output) -> std::optional<Info>
+{
+	constexpr auto ChunkFrames = sf_count_t{65536};
+	auto sfInfo = SF_INFO{};
+
+	auto file = QFile{audioFile};
+	if (!file.open(QIODevice::ReadOnly)) { return std::nullopt; }
+
+	const auto sndFile = sf_open_fd(file.handle(), SFM_READ, &sfInfo, false);
+	if (sf_error(sndFile) != 0 || sfInfo.channels < 1) { return std::nullopt; }
+
+	auto buf = std::vector<sample_t>(sfInfo.channels * ChunkFrames);
+	auto chunk = std::vector<SampleFrame>(ChunkFrames);
+	auto framesWritten = sf_count_t{0};
+	while (framesWritten < sfInfo.frames)
+	{
+		const auto frames = sf_readf_float(sndFile, buf.data(), ChunkFrames);
+		if (frames <= 0) { break; }
+
+		// Same channel mapping as decode()
+		for (sf_count_t i = 0; i < frames; ++i)
+		{
+			chunk[i] = sfInfo.channels == 1
+				? SampleFrame{buf[i], buf[i]}
+				: SampleFrame{buf[i * sfInfo.channels], buf[i * sfInfo.channels + 1]};
+		}
+
+		const auto bytes = static_cast<qint64>(frames * sizeof(SampleFrame));
+		if (output.write(reinterpret_cast<const char*>(chunk.data()), bytes) != bytes)
+		{
+			sf_close(sndFile);
+			return std::nullopt;
+		}
+		framesWritten += frames;
+	}
+
+	sf_close(sndFile);
+	return Info{static_cast<f_cnt_t>(framesWritten), static_cast<int>(sfInfo.samplerate)};
+}
+
 } // namespace lmms
@@ -48,7 +48,7 @@ SamplePlayHandle::SamplePlayHandle(Sample* sample, bool ownAudioBusHandle)
 
 
 SamplePlayHandle::SamplePlayHandle( const QString& sampleFile ) :
-	SamplePlayHandle(new Sample(SampleBuffer::fromFile(sampleFile)), true)
+	SamplePlayHandle(new Sample(SampleBuffer::fromFile(sampleFile, true)), true)
 {
 }
 
@@ -0,0 +1,304 @@
+/*
+ * SampleStream.cpp - reads memory-mapped samples ahead of playback
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SampleStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SampleBuffer.h"
+
+namespace lmms {
+
+namespace {
+
+//! Frames copied per stream and pass, so a jump in one stream doesn't hold up the others for long
+constexpr auto MaxFramesPerPass = SampleStream::Capacity / 4;
+constexpr auto ReadAheadInterval = std::chrono::milliseconds{10};
+//! How long prefetch() waits for the I/O thread at most, e.g. when the disk is busy
+constexpr auto PrefetchTimeout = std::chrono::milliseconds{250};
+
+//! The first frame of the buffer, or the one past the last, that is read at @p position in the direction of playback
+auto anchorFrame(f_cnt_t position, bool backwards, f_cnt_t size) -> f_cnt_t
+{
+	position = std::min(position, size);
+	// Backwards playback continues with the frame at the position and the ones before it
+	return backwards ? std::min(position + 1, size) : position;
+}
+
+} // namespace
+
+
+
+
+class SampleStream::ReadAheadThread
+{
+public:
+	ReadAheadThread() :
+		m_thread{[this] { run(); }}
+	{
+	}
+
+	~ReadAheadThread()
+	{
+		{
+			const auto lock = std::lock_guard{m_mutex};
+			m_quit = true;
+		}
+		m_wake.notify_one();
+		m_thread.join();
+
+		// Streams still open when the program exits may be closed later, so only the closed ones are deleted
+		std::move(m_added.begin(), m_added.end(), std::back_inserter(m_streams));
+		for (auto& stream : m_streams)
+		{
+			if (!stream->m_closed.load(std::memory_order_acquire)) { stream.release(); }
+		}
+	}
+
+	void add(std::unique_ptr<SampleStream> stream)
+	{
+		const auto lock = std::lock_guard{m_mutex};
+		m_added.push_back(std::move(stream));
+	}
+
+	void prefetch(const SampleStream& stream, f_cnt_t frame, bool backwards)
+	{
+		auto lock = std::unique_lock{m_mutex};
+		++m_prefetches;
+		m_wake.notify_one();
+		m_passDone.wait_for(lock, PrefetchTimeout,
+			[&] { return stream.isReadAhead(frame, backwards, MaxFramesPerPass); });
+		--m_prefetches;
+	}
+
+private:
+	void run()
+	{
+		auto lock = std::unique_lock{m_mutex};
+		while (!m_quit)
+		{
+			std::move(m_added.begin(), m_added.end(), std::back_inserter(m_streams));
+			m_added.clear();
+
+			// Reading the streams doesn't need the lock, so opening and prefetching streams never waits for the disk
+			lock.unlock();
+			std::erase_if(m_streams,
+				[](const auto& stream) { return stream->m_closed.load(std::memory_order_acquire); });
+			for (auto& stream : m_streams) { stream->readAhead(); }
+			lock.lock();
+
+			m_passDone.notify_all();
+			m_wake.wait_for(lock, ReadAheadInterval, [this] { return m_quit || m_prefetches > 0; });
+		}
+	}
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_passDone;
+	bool m_quit = false;
+	int m_prefetches = 0;
+	//! Streams opened since the last pass
+	std::vector<std::unique_ptr<SampleStream>> m_added;
+	//! Only used by the I/O thread
+	std::vector<std::unique_ptr<SampleStream>> m_streams;
+	std::thread m_thread;
+};
+
+
+
+
+SampleStream::SampleStream(std::shared_ptr<const SampleBuffer> buffer) :
+	m_buffer(std::move(buffer)),
+	m_ring(std::make_unique<SampleFrame[]>(Capacity))
+{
+}
+
+
+
+
+auto SampleStream::readAheadThread() -> ReadAheadThread&
+{
+	// Started by the first stream and stopped when the program exits
+	static auto s_thread = ReadAheadThread{};
+	return s_thread;
+}
+
+
+
+
+auto SampleStream::open(std::shared_ptr<const SampleBuffer> buffer, f_cnt_t frame, bool backwards) -> SampleStream*
+{
+	auto& thread = readAheadThread();
+
+	auto stream = std::unique_ptr<SampleStream>{new SampleStream(std::move(buffer))};
+	stream->setPosition(frame, backwards);
+	while (!stream->isReadAhead(frame, backwards, Capacity)) { stream->readAhead(); }
+
+	const auto result = stream.get();
+	thread.add(std::move(stream));
+	return result;
+}
+
+
+
+
+void SampleStream::close()
+{
+	m_closed.store(true, std::memory_order_release);
+}
+
+
+
+
+void SampleStream::prefetch(f_cnt_t frame, bool backwards)
+{
+	setPosition(frame, backwards);
+	readAheadThread().prefetch(*this, frame, backwards);
+}
+
+
+
+
+void SampleStream::readAhead()
+{
+	const auto size = static_cast<f_cnt_t>(m_buffer->size());
+	const auto backwards = m_backwards.load(std::memory_order_relaxed);
+	const auto anchor = anchorFrame(m_position.load(std::memory_order_acquire), backwards, size);
+
+	auto begin = m_begin.load(std::memory_order_relaxed);
+	auto end = m_end.load(std::memory_order_relaxed);
+
+	if (anchor < begin || anchor > end)
+	{
+		// Playback jumped, restart the window at the new position. The odd sequence number is published before any
+		// frame of the old window is replaced.
+		m_sequence.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		begin = end = anchor;
+		m_begin.store(begin, std::memory_order_relaxed);
+		m_end.store(end, std::memory_order_relaxed);
+		m_sequence.fetch_add(1, std::memory_order_release);
+	}
+
+	if (!backwards)
+	{
+		const auto newEnd = std::min({size, anchor + Capacity, end + MaxFramesPerPass});
+		if (newEnd <= end) { return; }
+
+		// Drop the frames about to be replaced from the window first, see View::complete()
+		const auto newBegin = std::max(begin, newEnd > Capacity ? newEnd - Capacity : 0);
+		m_begin.store(newBegin, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		copyToRing(end, newEnd);
+		m_end.store(newEnd, std::memory_order_release);
+	}
+	else
+	{
+		const auto target = anchor > Capacity ? anchor - Capacity : 0;
+		const auto newBegin = std::max(target, begin > MaxFramesPerPass ? begin - MaxFramesPerPass : 0);
+		if (newBegin >= begin) { return; }
+
+		const auto newEnd = std::min(end, newBegin + Capacity);
+		m_end.store(newEnd, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		copyToRing(newBegin, begin);
+		m_begin.store(newBegin, std::memory_order_release);
+	}
+}
+
+
+
+
+void SampleStream::copyToRing(f_cnt_t begin, f_cnt_t end)
+{
+	// Reading the mapping is where the I/O thread waits for the disk
+	const auto source = m_buffer->data();
+	while (begin < end)
+	{
+		const auto slot = begin % Capacity;
+		const auto frames = std::min(end - begin, Capacity - slot);
+		std::memcpy(&m_ring[slot], source + begin, frames * sizeof(SampleFrame));
+		begin += frames;
+	}
+}
+
+
+
+
+auto SampleStream::isReadAhead(f_cnt_t position, bool backwards, f_cnt_t frames) const -> bool
+{
+	const auto size = static_cast<f_cnt_t>(m_buffer->size());
+	const auto anchor = anchorFrame(position, backwards, size);
+	if (m_sequence.load(std::memory_order_acquire) % 2 != 0) { return false; }
+
+	const auto begin = m_begin.load(std::memory_order_acquire);
+	const auto end = m_end.load(std::memory_order_acquire);
+	return backwards
+		? end >= anchor && begin <= (anchor > frames ? anchor - frames : 0)
+		: begin <= anchor && end >= std::min(size, anchor + frames);
+}
+
+
+
+
+SampleStream::View::View(const SampleStream& stream) :
+	m_stream(stream),
+	m_ring(stream.m_ring.get()),
+	m_sequence(stream.m_sequence.load(std::memory_order_acquire)),
+	m_begin(stream.m_begin.load(std::memory_order_acquire)),
+	m_end(stream.m_end.load(std::memory_order_acquire)),
+	m_firstRead(std::numeric_limits<f_cnt_t>::max())
+{
+	if (m_sequence % 2 != 0) { m_begin = m_end = 0; }
+}
+
+
+
+
+auto SampleStream::View::complete() const -> bool
+{
+	// The I/O thread shrinks the window before replacing frames, so if the frames read are still in it, they were
+	// not replaced while reading them
+	std::atomic_thread_fence(std::memory_order_acquire);
+	const auto untouched = m_firstRead > m_lastRead
+		|| (m_stream.m_sequence.load(std::memory_order_relaxed) == m_sequence
+			&& m_stream.m_begin.load(std::memory_order_relaxed) <= m_firstRead
+			&& m_stream.m_end.load(std::memory_order_relaxed) > m_lastRead);
+
+	if (untouched && !m_missed) { return true; }
+	m_stream.m_underruns.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+} // namespace lmms
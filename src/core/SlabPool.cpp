@@ -0,0 +1,203 @@
+/*
+ * SlabPool.cpp - realtime-safe pool of fixed-size elements which grows in the background
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SlabPool.h"
+
+#include <cassert>
+
+#include "LocklessAllocator.h"
+
+namespace lmms
+{
+
+SlabPool::SlabPool(std::size_t slabSize) :
+	m_slabSize(slabSize),
+	m_lowWaterMark(slabSize / 4)
+{
+}
+
+
+
+
+SlabPool::~SlabPool()
+{
+	destroy();
+}
+
+
+
+
+void SlabPool::create(std::size_t elementSize, std::size_t alignment)
+{
+	{
+		const auto lock = std::lock_guard{m_slabMutex};
+
+		clear();
+		m_elementSize = elementSize;
+		m_alignment = alignment;
+		m_inUse = 0;
+		m_highWaterMark = 0;
+		m_failedAllocations = 0;
+		++m_generation;
+		addSlab();
+	}
+
+	if (!m_grower.joinable())
+	{
+		m_quit = false;
+		m_grower = std::thread{[this] { runGrower(); }};
+	}
+}
+
+
+
+
+void SlabPool::destroy()
+{
+	if (m_grower.joinable())
+	{
+		m_quit = true;
+		m_growRequest.post();
+		m_grower.join();
+	}
+
+	const auto lock = std::lock_guard{m_slabMutex};
+	clear();
+}
+
+
+
+
+void* SlabPool::allocate()
+{
+	void* element = nullptr;
+
+	const auto count = m_slabCount.load(std::memory_order_acquire);
+	for (std::size_t i = 0; i < count && !element; ++i)
+	{
+		auto* slab = m_slabs[i].load(std::memory_order_acquire);
+		element = slab->tryAlloc();
+		if (element && i == count - 1 && slab->available() < m_lowWaterMark) { requestGrowth(); }
+	}
+
+	if (!element)
+	{
+		// The pool is exhausted, which should only happen if it couldn't grow fast enough
+		requestGrowth();
+		m_failedAllocations.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	const auto inUse = m_inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+	auto peak = m_highWaterMark.load(std::memory_order_relaxed);
+	while (inUse > peak && !m_highWaterMark.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {}
+
+	return element;
+}
+
+
+
+
+void SlabPool::deallocate(void* element)
+{
+	m_inUse.fetch_sub(1, std::memory_order_relaxed);
+
+	const auto count = m_slabCount.load(std::memory_order_acquire);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		auto* slab = m_slabs[i].load(std::memory_order_acquire);
+		if (slab->contains(element))
+		{
+			slab->free(element);
+			return;
+		}
+	}
+	assert(false && "element was not allocated from this pool");
+}
+
+
+
+
+SlabPool::Statistics SlabPool::statistics() const
+{
+	return {
+		.capacity = m_slabCount.load(std::memory_order_acquire) * m_slabSize,
+		.inUse = m_inUse.load(std::memory_order_relaxed),
+		.highWaterMark = m_highWaterMark.load(std::memory_order_relaxed),
+		.failedAllocations = m_failedAllocations.load(std::memory_order_relaxed)
+	};
+}
+
+
+
+
+//! Must be called with m_slabMutex locked
+void SlabPool::addSlab()
+{
+	const auto count = m_slabCount.load(std::memory_order_relaxed);
+	if (count == MaxSlabs) { return; }
+
+	m_slabs[count].store(new LocklessAllocator{m_slabSize, m_elementSize, m_alignment}, std::memory_order_release);
+	m_slabCount.store(count + 1, std::memory_order_release);
+}
+
+
+
+
+//! Must be called with m_slabMutex locked
+void SlabPool::clear()
+{
+	const auto count = m_slabCount.exchange(0, std::memory_order_acq_rel);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		delete m_slabs[i].exchange(nullptr, std::memory_order_acq_rel);
+	}
+}
+
+
+
+
+//! Realtime-safe: only posts a semaphore, and only once per growth
+void SlabPool::requestGrowth()
+{
+	if (!m_growthRequested.exchange(true, std::memory_order_acq_rel)) { m_growRequest.post(); }
+}
+
+
+
+
+void SlabPool::runGrower()
+{
+	while (true)
+	{
+		m_growRequest.wait();
+		if (m_quit) { return; }
+
+		const auto lock = std::lock_guard{m_slabMutex};
+		addSlab();
+		m_growthRequested.store(false, std::memory_order_release);
+	}
+}
+
+} // namespace lmms
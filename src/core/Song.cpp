@@ -28,6 +28,7 @@
 #include <QDebug>
 #include <QFile>
 #include <QMessageBox>
+#include <QProgressDialog>
 
 #include <algorithm>
 #include <cmath>
@@ -44,6 +45,7 @@
 #include "ExportFilter.h"
 #include "InstrumentTrack.h"
 #include "Keymap.h"
+#include "MainWindow.h"
 #include "NotePlayHandle.h"
 #include "MidiClip.h"
 #include "PatternEditor.h"
@@ -52,9 +54,11 @@
 #include "PianoRoll.h"
 #include "ProjectJournal.h"
 #include "ProjectNotes.h"
+#include "ProjectPrefetcher.h"
 #include "Scale.h"
 #include "SongEditor.h"
 #include "PeakController.h"
+#include "Tracer.h"
 
 
 namespace lmms
@@ -209,6 +213,8 @@ void Song::processNextBuffer()
 	// If nothing is playing, there is nothing to do
 	if (!m_playing) { return; }
 
+	Tracer::Scope traceScope("Song");
+
 	// At the beginning of the song, we have to reset the LFOs
 	if (m_playMode == PlayMode::Song && getPlayPos() == 0)
 	{
@@ -1066,6 +1072,10 @@ void Song::loadProject( const QString & fileName )
 
 	clearErrors();
 
+	// Start decoding samples and reading other referenced files in the background, so restoring the tracks below
+	// mostly picks up finished work instead of loading every file one after the other
+	ProjectPrefetcher prefetcher{dataFile.content()};
+
 	Engine::audioEngine()->requestChangeInModel();
 
 	// get the header information from the DOM
@@ -1175,6 +1185,22 @@ void Song::loadProject( const QString & fileName )
 	// resolve all IDs so that autoModels are automated
 	AutomationClip::resolveAllIDs();
 
+	// Don't hand the project to the audio engine before all its files are loaded
+	if (getGUI() != nullptr && !prefetcher.waitFor(std::chrono::milliseconds{50}))
+	{
+		QProgressDialog pd(tr("Loading samples..."), QString{}, 0, static_cast<int>(prefetcher.total()),
+			getGUI()->mainWindow());
+		pd.setWindowModality(Qt::ApplicationModal);
+		pd.setWindowTitle(tr("Please wait..."));
+		pd.show();
+
+		while (!prefetcher.waitFor(std::chrono::milliseconds{50}))
+		{
+			pd.setValue(static_cast<int>(prefetcher.done()));
+			QCoreApplication::instance()->processEvents(QEventLoop::AllEvents, 50);
+		}
+	}
+	prefetcher.wait();
 
 	Engine::audioEngine()->doneChangeInModel();
 
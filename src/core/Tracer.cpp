@@ -0,0 +1,220 @@
+/*
+ * Tracer.cpp - records render events for viewing them in a trace viewer
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Tracer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <QFile>
+#include <QString>
+#include <QTextStream>
+#include <QThread>
+
+
+namespace lmms
+{
+
+namespace
+{
+
+//! Events per thread, older ones get overwritten
+constexpr auto EVENTS_PER_THREAD = std::size_t{1} << 16;
+
+//! Threads besides the worker threads that may record events (audio device, renderer, encoder, GUI, ...)
+constexpr auto EXTRA_THREADS = std::size_t{8};
+
+constexpr auto THREAD_NAME_SIZE = std::size_t{32};
+
+struct Event
+{
+	const char* name;
+	const char* detail;
+	std::int64_t begin;
+	std::int64_t end;
+};
+
+struct ThreadEvents
+{
+	std::array<char, THREAD_NAME_SIZE> threadName{};
+	std::vector<Event> events = std::vector<Event>(EVENTS_PER_THREAD);
+	//! number of events recorded so far, written by the owning thread only
+	std::atomic<std::size_t> count = 0;
+};
+
+std::vector<std::unique_ptr<ThreadEvents>> s_threads;
+//! number of entries of s_threads claimed by threads
+std::atomic<std::size_t> s_claimedThreads = 0;
+//! incremented by each start(), so threads know when their claimed buffer is stale
+std::atomic<unsigned> s_session = 0;
+
+thread_local ThreadEvents* t_events = nullptr;
+thread_local unsigned t_session = 0;
+thread_local std::array<char, THREAD_NAME_SIZE> t_threadName{};
+
+
+ThreadEvents* threadEvents()
+{
+	const auto session = s_session.load(std::memory_order_acquire);
+	if (t_session != session)
+	{
+		t_session = session;
+		const auto index = s_claimedThreads.fetch_add(1, std::memory_order_relaxed);
+		t_events = index < s_threads.size() ? s_threads[index].get() : nullptr;
+		if (t_events) { t_events->threadName = t_threadName; }
+	}
+	return t_events;
+}
+
+
+void writeString(QTextStream& out, const char* string)
+{
+	// event names are plain identifiers, only escape what would break the JSON
+	out << '"';
+	for (auto c = string; *c; ++c)
+	{
+		if (*c == '"' || *c == '\\') { out << '\\'; }
+		if (static_cast<unsigned char>(*c) >= 0x20) { out << *c; }
+	}
+	out << '"';
+}
+
+} // namespace
+
+
+std::atomic<bool> Tracer::s_recording = false;
+
+
+
+
+void Tracer::start()
+{
+	s_recording = false;
+
+	const auto threadCount = static_cast<std::size_t>(QThread::idealThreadCount()) + EXTRA_THREADS;
+	s_threads.clear();
+	for (std::size_t i = 0; i < threadCount; ++i)
+	{
+		s_threads.push_back(std::make_unique<ThreadEvents>());
+	}
+	s_claimedThreads = 0;
+	s_session.fetch_add(1, std::memory_order_release);
+
+	s_recording = true;
+}
+
+
+
+
+bool Tracer::stop(const QString& fileName)
+{
+	s_recording = false;
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) { return false; }
+
+	QTextStream out(&file);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	auto first = true;
+	const auto threadCount = std::min(s_claimedThreads.load(), s_threads.size());
+	for (std::size_t tid = 0; tid < threadCount; ++tid)
+	{
+		const auto& thread = *s_threads[tid];
+
+		if (thread.threadName[0])
+		{
+			out << (first ? "\n" : ",\n") << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+				<< ",\"name\":\"thread_name\",\"args\":{\"name\":";
+			writeString(out, thread.threadName.data());
+			out << "}}";
+			first = false;
+		}
+
+		// only the last EVENTS_PER_THREAD events are still there
+		const auto count = thread.count.load(std::memory_order_acquire);
+		const auto begin = count > EVENTS_PER_THREAD ? count - EVENTS_PER_THREAD : 0;
+		for (auto i = begin; i < count; ++i)
+		{
+			const auto& event = thread.events[i % EVENTS_PER_THREAD];
+			out << (first ? "\n" : ",\n") << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"name\":";
+			writeString(out, event.name);
+			out << ",\"ts\":" << QString::number(event.begin / 1000.0, 'f', 3)
+				<< ",\"dur\":" << QString::number((event.end - event.begin) / 1000.0, 'f', 3);
+			if (event.detail)
+			{
+				out << ",\"args\":{\"name\":";
+				writeString(out, event.detail);
+				out << "}";
+			}
+			out << "}";
+			first = false;
+		}
+	}
+
+	out << "\n]}\n";
+	out.flush();
+
+	// the buffers are kept until the next start(), as a thread may still finish an event
+	return file.error() == QFile::NoError;
+}
+
+
+
+
+void Tracer::setThreadName(const char* name, int index)
+{
+	if (index < 0) { std::snprintf(t_threadName.data(), t_threadName.size(), "%s", name); }
+	else { std::snprintf(t_threadName.data(), t_threadName.size(), "%s %d", name, index); }
+
+	if (t_events && t_session == s_session.load(std::memory_order_acquire)) { t_events->threadName = t_threadName; }
+}
+
+
+
+
+std::int64_t Tracer::now()
+{
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+
+void Tracer::record(const char* name, const char* detail, std::int64_t begin, std::int64_t end)
+{
+	const auto events = threadEvents();
+	if (!events) { return; }
+
+	const auto count = events->count.load(std::memory_order_relaxed);
+	events->events[count % EVENTS_PER_THREAD] = Event{name, detail, begin, end};
+	events->count.store(count + 1, std::memory_order_release);
+}
+
+
+} // namespace lmms
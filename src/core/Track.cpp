@@ -34,6 +34,7 @@
 
 #include "AutomationClip.h"
 #include "AutomationTrack.h"
+#include "ClipSchedule.h"
 #include "ConfigManager.h"
 #include "Engine.h"
 #include "InstrumentTrack.h"
@@ -63,7 +64,8 @@ Track::Track( Type type, TrackContainer * tc ) :
 	m_name(),                       /*!< The track's name */
 	m_mutedModel( false, this, tr( "Mute" ) ), /*!< For controlling track muting */
 	m_soloModel( false, this, tr( "Solo" ) ), /*!< For controlling track soloing */
-	m_clips()        /*!< The clips (segments) */
+	m_clips(),        /*!< The clips (segments) */
+	m_clipSchedule(std::make_unique<ClipSchedule>(m_clips))
 {	
 	m_trackContainer->addTrack( this );
 	m_height = -1;
@@ -78,6 +80,8 @@ Track::Track( Type type, TrackContainer * tc ) :
  */
 Track::~Track()
 {
+	// the audio engine is locked first, like the audio thread does before locking tracks
+	beginClipScheduleBatch();
 	lock();
 	emit destroyedTrack();
 
@@ -88,6 +92,7 @@ Track::~Track()
 
 	m_trackContainer->removeTrack( this );
 	unlock();
+	endClipScheduleBatch();
 }
 
 
@@ -276,10 +281,9 @@ void Track::loadTrack(const QDomElement& element, bool presetMode)
 		return;
 	}
 
-	{
-		auto guard = Engine::audioEngine()->requestChangesGuard();
-		deleteClips();
-	}
+	// the clip schedule is only rebuilt once all clips have been loaded
+	beginClipScheduleBatch();
+	deleteClips();
 
 	QDomNode node = element.firstChild();
 	while( !node.isNull() )
@@ -301,6 +305,7 @@ void Track::loadTrack(const QDomElement& element, bool presetMode)
 		}
 		node = node.nextSibling();
 	}
+	endClipScheduleBatch();
 
 	int storedHeight = element.attribute( "trackheight" ).toInt();
 	if( storedHeight >= MINIMAL_TRACK_HEIGHT )
@@ -342,6 +347,10 @@ Clip * Track::addClip( Clip * clip )
 {
 	m_clips.push_back( clip );
 
+	connect(clip, &Clip::positionChanged, this, &Track::invalidateClipSchedule);
+	connect(clip, &Clip::lengthChanged, this, &Track::invalidateClipSchedule);
+	invalidateClipSchedule();
+
 	emit clipAdded( clip );
 
 	return clip; // just for convenience
@@ -360,6 +369,8 @@ void Track::removeClip( Clip * clip )
 	if( it != m_clips.end() )
 	{
 		m_clips.erase( it );
+		disconnect(clip, nullptr, this, nullptr);
+		invalidateClipSchedule();
 		if( Engine::getSong() )
 		{
 			Engine::getSong()->updateLength();
@@ -372,10 +383,12 @@ void Track::removeClip( Clip * clip )
 /*! \brief Remove all Clips from this track */
 void Track::deleteClips()
 {
+	beginClipScheduleBatch();
 	while (!m_clips.empty())
 	{
 		delete m_clips.front();
 	}
+	endClipScheduleBatch();
 }
 
 
@@ -456,18 +469,56 @@ int Track::getClipNum( const Clip * clip )
 void Track::getClipsInRange( clipVector & clipV, const TimePos & start,
 							const TimePos & end )
 {
-	for( Clip* clip : m_clips )
-	{
-		int s = clip->startPosition();
-		int e = clip->endPosition();
-		if( ( s <= end ) && ( e >= start ) )
-		{
-			// Clip is within given range
-			// Insert sorted by Clip's position
-			clipV.insert(std::upper_bound(clipV.begin(), clipV.end(), clip, Clip::comparePosition),
-						clip);
-		}
-	}
+	m_clipSchedule->clipsInRange(clipV, start, end);
+}
+
+
+
+
+void Track::invalidateClipSchedule()
+{
+	m_clipScheduleDirty = true;
+	if (m_clipScheduleBatchDepth == 0) { updateClipSchedule(); }
+}
+
+
+
+
+/*! \brief Replace the clip schedule used for playback
+ *
+ *  The new schedule is built first, so the audio engine is only locked
+ *  for swapping it in. The old one is freed outside the audio thread.
+ */
+void Track::updateClipSchedule()
+{
+	if (!m_clipScheduleDirty) { return; }
+	m_clipScheduleDirty = false;
+
+	auto schedule = std::make_unique<const ClipSchedule>(m_clips);
+
+	// the audio engine is already gone when the song's remaining tracks are destroyed
+	const auto audioEngine = Engine::audioEngine();
+	if (audioEngine) { audioEngine->requestChangeInModel(); }
+	m_clipSchedule.swap(schedule);
+	if (audioEngine) { audioEngine->doneChangeInModel(); }
+}
+
+
+
+
+void Track::beginClipScheduleBatch()
+{
+	if (const auto audioEngine = Engine::audioEngine()) { audioEngine->requestChangeInModel(); }
+	++m_clipScheduleBatchDepth;
+}
+
+
+
+
+void Track::endClipScheduleBatch()
+{
+	if (--m_clipScheduleBatchDepth == 0) { updateClipSchedule(); }
+	if (const auto audioEngine = Engine::audioEngine()) { audioEngine->doneChangeInModel(); }
 }
 
 
@@ -518,6 +569,7 @@ void Track::insertBar( const TimePos & pos )
 {
 	// we'll increase the position of every Clip, positioned behind pos, by
 	// one bar
+	beginClipScheduleBatch();
 	for (const auto& clip : m_clips)
 	{
 		if (clip->startPosition() >= pos)
@@ -525,6 +577,7 @@ void Track::insertBar( const TimePos & pos )
 			clip->movePosition(clip->startPosition() + TimePos::ticksPerBar());
 		}
 	}
+	endClipScheduleBatch();
 }
 
 
@@ -538,6 +591,7 @@ void Track::removeBar( const TimePos & pos )
 {
 	// we'll decrease the position of every Clip, positioned behind pos, by
 	// one bar
+	beginClipScheduleBatch();
 	for (const auto& clip : m_clips)
 	{
 		if (clip->startPosition() >= pos)
@@ -545,6 +599,7 @@ void Track::removeBar( const TimePos & pos )
 			clip->movePosition(clip->startPosition() - TimePos::ticksPerBar());
 		}
 	}
+	endClipScheduleBatch();
 }
 
 
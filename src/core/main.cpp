@@ -56,6 +56,7 @@
 #include <csignal>  // To register the signal handler
 
 #include "MainApplication.h"
+#include "BatchRenderer.h"
 #include "ConfigManager.h"
 #include "DataFile.h"
 #include "NotePlayHandle.h"
@@ -67,9 +68,11 @@
 #include "MainWindow.h"
 #include "MixHelpers.h"
 #include "OutputSettings.h"
+#include "ProjectArchive.h"
 #include "ProjectRenderer.h"
 #include "RenderManager.h"
 #include "Song.h"
+#include "Tracer.h"
 
 #ifdef LMMS_DEBUG_FPE
 #include <fenv.h> // For feenableexcept
@@ -165,6 +168,12 @@ void printHelp()
 		"  compress <in>                         Compress file <in>\n"
 		"  render <project> [options...]         Render given project file\n"
 		"  rendertracks <project> [options...]   Render each track to a different file\n"
+		"  batch <jobs> [options...]             Render all jobs listed in file <jobs>\n"
+		"                                        (\"-\" for standard in) one after\n"
+		"                                        another. Each line contains the tab\n"
+		"                                        separated fields <project> [<output>\n"
+		"                                        [<format> [<samplerate>]]]. The\n"
+		"                                        options are used for omitted fields\n"
 		"  upgrade <in> [out]                    Upgrade file <in> and save as <out>\n"
 		"                                        Standard out is used if no output file\n"
 		"                                        is specified\n"
@@ -183,7 +192,7 @@ void printHelp()
 		"          geometry is <xsizexysize+xoffset+yoffsety>.\n"
 		"      --import <in> [-e]         Import MIDI or Hydrogen file <in>.\n"
 		"          If -e is specified lmms exits after importing the file.\n"
-		"\nOptions for \"render\" and \"rendertracks\":\n"
+		"\nOptions for \"render\", \"rendertracks\" and \"batch\":\n"
 		"  -a, --float                    Use 32bit float bit depth\n"
 		"  -b, --bitrate <bitrate>        Specify output bitrate in KBit/s\n"
 		"          Default: 160.\n"
@@ -201,7 +210,12 @@ void printHelp()
 		"          For \"rendertracks\", provide a directory path\n"
 		"          If not specified, render will overwrite the input file\n"
 		"          For \"rendertracks\", this might be required\n"
+		"      --pre-mixer                For \"rendertracks\", render the output of the\n"
+		"          tracks themselves, without mixer and master effects.\n"
+		"          All tracks are rendered in a single pass.\n"
 		"  -p, --profile <out>            Dump profiling information to file <out>\n"
+		"  -t, --trace <out>              Write a trace of the rendering to file <out>\n"
+		"          in Chrome trace format (viewable with Perfetto)\n"
 		"  -s, --samplerate <samplerate>  Specify output samplerate in Hz\n"
 		"          Range: 44100 (default) to 192000\n"
 		"          Possible values: 1, 2, 4, 8\n"
@@ -230,6 +244,14 @@ void fileCheck( QString &file )
 	}
 }
 
+void writeTrace(const QString& file)
+{
+	if (!Tracer::stop(file))
+	{
+		fprintf(stderr, "Could not write trace to %s\n", file.toUtf8().constData());
+	}
+}
+
 int usageError(const QString& message)
 {
 	qCritical().noquote() << QString("\n%1.\n\nTry \"%2 --help\" for more information.\n\n")
@@ -253,7 +275,8 @@ int main( int argc, char * * argv )
 	bool allowRoot = false;
 	bool renderLoop = false;
 	bool renderTracks = false;
-	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, configFile;
+	bool renderPreMixer = false;
+	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, traceOutputFile, configFile, batchJobs;
 
 	// first of two command-line parsing stages
 	for (int i = 1; i < argc; ++i)
@@ -279,6 +302,10 @@ int main( int argc, char * * argv )
 			coreOnly = true;
 			renderTracks = true;
 		}
+		else if (arg == "batch" || arg == "--batch")
+		{
+			coreOnly = true;
+		}
 		else if (arg == "--allowroot")
 		{
 			allowRoot = true;
@@ -447,7 +474,16 @@ int main( int argc, char * * argv )
 
 			QFile f( QString::fromLocal8Bit( argv[i] ) );
 			f.open( QIODevice::ReadOnly );
-			QString d = qUncompress( f.readAll() );
+			QString d;
+			if (ProjectArchive::isArchive(f))
+			{
+				const auto archive = ProjectArchive::open(f.fileName());
+				d = archive ? archive->read(ProjectArchive::DocumentChunk) : QByteArray{};
+			}
+			else
+			{
+				d = qUncompress( f.readAll() );
+			}
 			printf( "%s\n", d.toUtf8().constData() );
 
 			return EXIT_SUCCESS;
@@ -482,10 +518,25 @@ int main( int argc, char * * argv )
 			fileToLoad = QString::fromLocal8Bit( argv[i] );
 			renderOut = fileToLoad;
 		}
+		else if (arg == "batch" || arg == "--batch")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No job list specified");
+			}
+
+			batchJobs = QString::fromLocal8Bit(argv[i]);
+		}
 		else if( arg == "--loop" || arg == "-l" )
 		{
 			renderLoop = true;
 		}
+		else if (arg == "--pre-mixer")
+		{
+			renderPreMixer = true;
+		}
 		else if( arg == "--output" || arg == "-o" )
 		{
 			++i;
@@ -638,6 +689,17 @@ int main( int argc, char * * argv )
 
 			profilerOutputFile = QString::fromLocal8Bit( argv[i] );
 		}
+		else if (arg == "--trace" || arg == "-t")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No trace file specified");
+			}
+
+			traceOutputFile = QString::fromLocal8Bit(argv[i]);
+		}
 		else if( arg == "--config" || arg == "-c" )
 		{
 			++i;
@@ -705,9 +767,42 @@ int main( int argc, char * * argv )
 
 	bool destroyEngine = false;
 
+	// render all given jobs without restarting, keeping the engine
+	// and the plugin caches around
+	if (!batchJobs.isEmpty())
+	{
+		QFile jobFile(batchJobs);
+		const auto mode = QIODevice::ReadOnly | QIODevice::Text;
+		if (!(batchJobs == "-" ? jobFile.open(stdin, mode) : jobFile.open(mode)))
+		{
+			return usageError(QString("Could not open job list %1").arg(batchJobs));
+		}
+
+		Engine::init( true );
+		destroyEngine = true;
+
+		QTextStream jobStream(&jobFile);
+		auto batch = new BatchRenderer(jobStream, BatchRenderer::Job{{}, {}, eff, os, renderLoop});
+		QObject::connect(batch, &BatchRenderer::finished, [batch] {
+			QCoreApplication::exit(batch->failedJobs() > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+		});
+
+		if (!profilerOutputFile.isEmpty())
+		{
+			Engine::audioEngine()->profiler().setOutputFile(profilerOutputFile);
+		}
+
+		if (!traceOutputFile.isEmpty())
+		{
+			Tracer::start();
+			QObject::connect(batch, &BatchRenderer::finished, [traceOutputFile] { writeTrace(traceOutputFile); });
+		}
+
+		batch->start();
+	}
 	// if we have an output file for rendering, just render the song
 	// without starting the GUI
-	if( !renderOut.isEmpty() )
+	else if( !renderOut.isEmpty() )
 	{
 		Engine::init( true );
 		destroyEngine = true;
@@ -733,6 +828,7 @@ int main( int argc, char * * argv )
 
 		// create renderer
 		auto r = new RenderManager(os, eff, renderOut);
+		QObject::connect(r, &RenderManager::finished, r, &RenderManager::printStatistics);
 		QCoreApplication::instance()->connect( r,
 				SIGNAL(finished()), SLOT(quit()));
 
@@ -747,10 +843,16 @@ int main( int argc, char * * argv )
 			Engine::audioEngine()->profiler().setOutputFile( profilerOutputFile );
 		}
 
+		if (!traceOutputFile.isEmpty())
+		{
+			Tracer::start();
+			QObject::connect(r, &RenderManager::finished, [traceOutputFile] { writeTrace(traceOutputFile); });
+		}
+
 		// start now!
 		if ( renderTracks )
 		{
-			r->renderTracks();
+			r->renderTracks(renderPreMixer ? RenderManager::StemSource::Track : RenderManager::StemSource::Master);
 		}
 		else
 		{
@@ -811,7 +811,7 @@ void FileBrowserTreeWidget::previewFileItem(FileItem* file)
 			embed::getIconPixmap("sample_file", 24, 24), 0);
 		// TODO: this can be removed once we do this outside the event thread
 		qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-		if (auto buffer = SampleBuffer::fromFile(fileName))
+		if (auto buffer = SampleBuffer::fromFile(fileName, true))
 		{
 			auto s = new SamplePlayHandle(new lmms::Sample{std::move(buffer)});
 			s->setDoneMayReturnTrue(false);
@@ -1239,7 +1239,7 @@ void FileItem::determineFileType()
 	m_handling = FileHandling::NotSupported;
 
 	const QString ext = extension();
-	if( ext == "mmp" || ext == "mpt" || ext == "mmpz" )
+	if( ext == "mmp" || ext == "mpt" || ext == "mmpz" || ext == "mmpc" )
 	{
 		m_type = FileType::Project;
 		m_handling = FileHandling::LoadAsProject;
@@ -1323,7 +1323,7 @@ QString FileItem::extension(const QString & file )
 
 QString FileItem::defaultFilters()
 {
-	const auto projectFilters = QStringList{"*.mmp", "*.mpt", "*.mmpz"};
+	const auto projectFilters = QStringList{"*.mmp", "*.mpt", "*.mmpz", "*.mmpc"};
 	const auto presetFilters = QStringList{"*.xpf", "*.xml", "*.xiz", "*.lv2"};
 	const auto soundFontFilters = QStringList{"*.sf2", "*.sf3"};
 	const auto patchFilters = QStringList{"*.pat"};
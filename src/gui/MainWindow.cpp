@@ -115,7 +115,7 @@ MainWindow::MainWindow() :
 		embed::getIconPixmap("star").transformed(QTransform().rotate(90)), splitter, false, "", ""));
 
 	sideBar->appendTab(new FileBrowser(FileBrowser::Type::Normal,
-		confMgr->userProjectsDir() + "*" + confMgr->factoryProjectsDir(), "*.mmp *.mmpz *.xml *.mid *.mpt",
+		confMgr->userProjectsDir() + "*" + confMgr->factoryProjectsDir(), "*.mmp *.mmpz *.mmpc *.xml *.mid *.mpt",
 		tr("My Projects"), embed::getIconPixmap("project_file").transformed(QTransform().rotate(90)), splitter, false,
 		confMgr->userProjectsDir(), confMgr->factoryProjectsDir()));
 
@@ -746,7 +746,7 @@ void MainWindow::openProject()
 {
 	if( mayChangeProject(false) )
 	{
-		FileDialog ofd( this, tr( "Open Project" ), "", tr( "LMMS (*.mmp *.mmpz)" ) );
+		FileDialog ofd( this, tr( "Open Project" ), "", tr( "LMMS (*.mmp *.mmpz *.mmpc)" ) );
 
 		ofd.setDirectory( ConfigManager::inst()->userProjectsDir() );
 		ofd.setFileMode( FileDialog::ExistingFiles );
@@ -791,6 +791,7 @@ bool MainWindow::saveProjectAs()
 	auto optionsWidget = new SaveOptionsWidget(Engine::getSong()->getSaveOptions());
 	VersionedSaveDialog sfd( this, optionsWidget, tr( "Save Project" ), "",
 			tr( "LMMS Project" ) + " (*.mmpz *.mmp);;" +
+				tr( "LMMS Project Archive" ) + " (*.mmpc);;" +
 				tr( "LMMS Project Template" ) + " (*.mpt)" );
 	QString f = Engine::getSong()->projectFileName();
 	if( f != "" )
@@ -827,6 +828,19 @@ bool MainWindow::saveProjectAs()
 				}
 			}
 		}
+		else if( sfd.selectedNameFilter().contains( "(*.mmpc)" ) )
+		{
+			// Remove the default suffix
+			fname.remove( "." + suffix );
+			if( !sfd.selectedFiles()[0].endsWith( ".mmpc" ) )
+			{
+				if( VersionedSaveDialog::fileExistsQuery( fname + ".mmpc",
+						tr( "Save project" ) ) )
+				{
+					fname += ".mmpc";
+				}
+			}
+		}
 		if( this->guiSaveProjectAs( fname ) )
 		{
 			if( getSession() == SessionState::Recover )
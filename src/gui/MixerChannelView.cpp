@@ -283,7 +283,7 @@ void MixerChannelView::renameFinished()
 	const auto mc = mixerChannel();
 	if (!newName.isEmpty() && mc->m_name != newName)
 	{
-		mc->m_name = newName;
+		mc->setName(newName);
 		m_renameLineEdit->setText(elideName(newName));
 		Engine::getSong()->setModified();
 	}
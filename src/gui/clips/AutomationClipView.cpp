@@ -475,6 +475,7 @@ void AutomationClipView::scaleTimemapToFit( float oldMin, float oldMax )
 	// only the inValue is being considered and the outValue is being reset to the inValue (so discrete jumps
 	// are discarded). Possibly later we will want discrete jumps to be maintained so we will need to upgrade
 	// the logic to account for them.
+	m_clip->beginCurveUpdateBatch();
 	for( AutomationClip::timeMap::iterator it = m_clip->m_timeMap.begin();
 		it != m_clip->m_timeMap.end(); ++it )
 	{
@@ -495,6 +496,7 @@ void AutomationClipView::scaleTimemapToFit( float oldMin, float oldMax )
 	}
 
 	m_clip->generateTangents();
+	m_clip->endCurveUpdateBatch();
 }
 
 } // namespace lmms::gui
@@ -194,7 +194,7 @@ void SampleClipView::mouseDoubleClickEvent( QMouseEvent * )
 	
 	if (!m_clip->hasSampleFileLoaded(selectedAudioFile))
 	{
-		auto sampleBuffer = SampleBuffer::fromFile(selectedAudioFile);
+		auto sampleBuffer = SampleBuffer::fromFile(selectedAudioFile, true);
 		if (sampleBuffer != SampleBuffer::emptyBuffer())
 		{
 			m_clip->setSampleBuffer(sampleBuffer);
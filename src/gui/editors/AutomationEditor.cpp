@@ -359,6 +359,7 @@ bool AutomationEditor::fineTuneValue(timeMap::iterator node, bool editingOutValu
 	if (!ok) { return false; }
 
 	// Set the new inValue/outValue
+	m_clip->beginCurveUpdateBatch();
 	if (editingOutValue)
 	{
 		node.value().setOutValue(value);
@@ -373,6 +374,7 @@ bool AutomationEditor::fineTuneValue(timeMap::iterator node, bool editingOutValu
 		}
 		node.value().setInValue(value);
 	}
+	m_clip->endCurveUpdateBatch();
 
 	// Notify listeners (e.g. PianoRoll) that clip data changed
 	emit m_clip->dataChanged();
@@ -892,6 +894,7 @@ void AutomationEditor::mouseMoveEvent(QMouseEvent * mouseEvent )
 					{
 						it.value().setInTangent(newTangent);
 					}
+					m_clip->updateCurve();
 				}
 				else if (m_mouseDownRight && m_action == Action::ResetTangents)
 				{
@@ -69,6 +69,7 @@ ExportProjectDialog::ExportProjectDialog(const QString& path, Mode mode, QWidget
 	, m_fileFormatSettingsLayout(new QFormLayout(m_fileFormatSettingsGroupBox))
 	, m_exportAsLoopBox(new QCheckBox(tr("Export as loop (remove extra bar)")))
 	, m_exportBetweenLoopMarkersBox(new QCheckBox(tr("Export between loop markers")))
+	, m_preMixerTracksBox(new QCheckBox(tr("Export tracks without mixer effects (faster)")))
 	, m_loopRepeatLabel(new QLabel(tr("Render looped section:")))
 	, m_loopRepeatBox(new QSpinBox())
 	, m_startButton(new QPushButton(tr("Start")))
@@ -162,6 +163,8 @@ ExportProjectDialog::ExportProjectDialog(const QString& path, Mode mode, QWidget
 	exportSettingsLayout->addWidget(m_exportAsLoopBox);
 	exportSettingsLayout->addWidget(m_exportBetweenLoopMarkersBox);
 	exportSettingsLayout->addLayout(loopRepeatLayout);
+	exportSettingsLayout->addWidget(m_preMixerTracksBox);
+	m_preMixerTracksBox->setVisible(m_mode == Mode::ExportTracks);
 
 	m_fileFormatSettingsLayout->addRow(m_fileFormatLabel, m_fileFormatComboBox);
 
@@ -270,7 +273,8 @@ void ExportProjectDialog::onStartButtonClicked()
 		m_renderManager->renderProject();
 		break;
 	case Mode::ExportTracks:
-		m_renderManager->renderTracks();
+		m_renderManager->renderTracks(m_preMixerTracksBox->isChecked()
+			? RenderManager::StemSource::Track : RenderManager::StemSource::Master);
 		break;
 	}
 }
@@ -98,13 +98,25 @@ void CPULoadWidget::updateCpuLoad()
 	if (new_load != m_currentLoad)
 	{
 		auto engine = Engine::audioEngine();
-		setToolTip(
+		auto toolTip =
 			tr("DSP total: %1%").arg(new_load) + "\n"
 			+ tr(" - Notes and setup: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::NoteSetup)) + "\n"
 			+ tr(" - Instruments: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Instruments)) + "\n"
 			+ tr(" - Effects: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Effects)) + "\n"
-			+ tr(" - Mixing: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Mixing))
-		);
+			+ tr(" - Mixing: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Mixing));
+
+		// list the nodes with the highest peak load, they are the most likely cause of xruns
+		const auto nodeLoads = engine->profiler().nodeLoads();
+		const auto heaviest = std::min<std::size_t>(nodeLoads.size(), 3);
+		if (heaviest > 0 && nodeLoads[0].max > 0.f) { toolTip += "\n" + tr("Highest peak load:"); }
+		for (std::size_t i = 0; i < heaviest && nodeLoads[i].max > 0.f; ++i)
+		{
+			toolTip += "\n" + tr(" - %1: %2% (average %3%)")
+				.arg(nodeLoads[i].name)
+				.arg(static_cast<int>(nodeLoads[i].max))
+				.arg(nodeLoads[i].average, 0, 'f', 1);
+		}
+		setToolTip(toolTip);
 		m_currentLoad = new_load;
 		m_changed = true;
 		update();
@@ -750,43 +750,22 @@ bool InstrumentTrack::play( const TimePos & _start, const f_cnt_t _frames,
 			cur_start -= c->startPosition() + c->startTimeOffset();
 		}
 
-		// get all notes from the given clip...
-		const NoteVector & notes = c->notes();
-		// ...and set our index to zero
-		auto nit = notes.begin();
+		const TimePos clipEnd = c->length() - c->startTimeOffset();
+		if (cur_start >= clipEnd) { continue; }
 
-		// very effective algorithm for playing notes that are
-		// posated within the current sample-frame
-
-		if( cur_start > 0 )
+		const auto playNote = [&](const Note* note)
 		{
-			// skip notes which end before start-bar
-			while( nit != notes.end() && ( *nit )->endPos() < cur_start )
-			{
-				++nit;
-			}
-		}
-
-		while (nit != notes.end() && (*nit)->pos() < c->length() - c->startTimeOffset())
-		{
-			const auto currentNote = *nit;
-			// Skip any notes note at the current time pos or not overlapping with the start.
-			if (!(currentNote->pos() == cur_start
-				|| (cur_start == -c->startTimeOffset() && (*nit)->pos() < cur_start && (*nit)->endPos() > cur_start)))
-			{
-				++nit;
-				continue;
-			}
-
 			// Calculate the overlap of the note over the clip end.
-			const auto noteOverlap = std::max(0, currentNote->endPos() - (c->length() - c->startTimeOffset()));
+			const auto noteOverlap = std::max(0, note->endPos() - clipEnd);
 			// If the note is a Step Note, frames will be 0 so the NotePlayHandle
 			// plays for the whole length of the sample
-			const auto noteFrames = currentNote->type() == Note::Type::Step
+			const auto noteFrames = note->type() == Note::Type::Step
 				? 0
-				: (currentNote->endPos() - cur_start - noteOverlap) * frames_per_tick;
+				: (note->endPos() - cur_start - noteOverlap) * frames_per_tick;
+
+			NotePlayHandle* notePlayHandle = NotePlayHandleManager::acquire(this, _offset, noteFrames, *note);
+			if (!notePlayHandle) { return; }
 
-			NotePlayHandle* notePlayHandle = NotePlayHandleManager::acquire(this, _offset, noteFrames, *currentNote);
 			notePlayHandle->setPatternTrack(pattern_track);
 			// are we playing global song?
 			if( _clip_num < 0 )
@@ -798,7 +777,22 @@ bool InstrumentTrack::play( const TimePos & _start, const f_cnt_t _frames,
 
 			Engine::audioEngine()->addPlayHandle( notePlayHandle );
 			played_a_note = true;
-			++nit;
+		};
+
+		// At the beginning of the clip, also play the notes which started before it
+		// (i.e. were cut off by the start time offset) and are still sounding
+		if (cur_start == -c->startTimeOffset())
+		{
+			for (const auto note : c->notesStartingBefore(cur_start))
+			{
+				if (note->endPos() > cur_start) { playNote(note); }
+			}
+		}
+
+		// The index only yields the notes starting right now, so the cost doesn't grow with the clip's size
+		for (const auto note : c->notesStartingAt(cur_start))
+		{
+			playNote(note);
 		}
 	}
 	unlock();
@@ -65,6 +65,7 @@ MidiClip::MidiClip( const MidiClip& other ) :
 	{
 		m_notes.push_back(note->clone());
 	}
+	updateStartIndex();
 
 	init();
 }
@@ -74,6 +75,11 @@ MidiClip::~MidiClip()
 {
 	emit destroyedMidiClip( this );
 
+	instrumentTrack()->lock();
+	m_startIndexNotes.clear();
+	m_startIndexPositions.clear();
+	instrumentTrack()->unlock();
+
 	for (const auto& note : m_notes)
 	{
 		delete note;
@@ -113,6 +119,8 @@ void MidiClip::resizeToFirstTrack()
 void MidiClip::init()
 {
 	connect(Engine::getSong(), &Song::timeSignatureChanged, this, &MidiClip::changeTimeSignature);
+	// notes may also have been moved or resized in place
+	connect(this, &MidiClip::dataChanged, this, &MidiClip::updateStartIndex);
 	if (getTrack()->trackContainer() != Engine::patternStore())
 	{
 		saveJournallingState(false);
@@ -188,11 +196,12 @@ Note * MidiClip::addNote( const Note & _new_note, const bool _quant_pos )
 	instrumentTrack()->lock();
 	m_notes.insert(std::upper_bound(m_notes.begin(), m_notes.end(), new_note, Note::lessThan), new_note);
 	instrumentTrack()->unlock();
+	insertIntoStartIndex(new_note);
 
 	checkType();
 	updateLength();
 
-	emit dataChanged();
+	emitDataChangedKeepingStartIndex();
 
 	return new_note;
 }
@@ -203,6 +212,7 @@ Note * MidiClip::addNote( const Note & _new_note, const bool _quant_pos )
 NoteVector::const_iterator MidiClip::removeNote(NoteVector::const_iterator it)
 {
 	instrumentTrack()->lock();
+	removeFromStartIndex(*it);
 	delete *it;
 	auto new_it = m_notes.erase(it);
 	instrumentTrack()->unlock();
@@ -210,7 +220,7 @@ NoteVector::const_iterator MidiClip::removeNote(NoteVector::const_iterator it)
 	checkType();
 	updateLength();
 
-	emit dataChanged();
+	emitDataChangedKeepingStartIndex();
 	return new_it;
 }
 
@@ -221,6 +231,7 @@ NoteVector::const_iterator MidiClip::removeNote(Note* note)
 	auto it = std::find(m_notes.begin(), m_notes.end(), note);
 	if (it != m_notes.end())
 	{
+		removeFromStartIndex(*it);
 		delete *it;
 		it = m_notes.erase(it);
 	}
@@ -230,7 +241,7 @@ NoteVector::const_iterator MidiClip::removeNote(Note* note)
 	checkType();
 	updateLength();
 
-	emit dataChanged();
+	emitDataChangedKeepingStartIndex();
 	return it;
 }
 
@@ -267,6 +278,10 @@ void MidiClip::clearNotes()
 		delete note;
 	}
 	m_notes.clear();
+	// keeps the capacity, the index is rebuilt on dataChanged
+	m_startIndexNotes.clear();
+	m_startIndexPositions.clear();
+	m_startIndexCursor = 0;
 	instrumentTrack()->unlock();
 
 	checkType();
@@ -277,6 +292,29 @@ void MidiClip::clearNotes()
 
 
 
+std::span<Note* const> MidiClip::notesStartingAt(TimePos pos) const
+{
+	const auto first = seekStartIndex(pos.getTicks());
+	auto last = first;
+	while (last < m_startIndexPositions.size() && m_startIndexPositions[last] == pos.getTicks()) { ++last; }
+
+	m_startIndexCursor = last;
+	return {m_startIndexNotes.data() + first, last - first};
+}
+
+
+
+
+std::span<Note* const> MidiClip::notesStartingBefore(TimePos pos) const
+{
+	const auto& positions = m_startIndexPositions;
+	const auto count = std::lower_bound(positions.begin(), positions.end(), pos.getTicks()) - positions.begin();
+	return {m_startIndexNotes.data(), static_cast<std::size_t>(count)};
+}
+
+
+
+
 Note * MidiClip::addStepNote( int step )
 {
 	Note stepNote = Note(TimePos(DefaultTicksPerBar / 16), TimePos::stepPosition(step));
@@ -537,6 +575,117 @@ void MidiClip::loadSettings( const QDomElement & _this )
 
 
 
+void MidiClip::updateStartIndex()
+{
+	if (m_startIndexUpToDate) { return; }
+
+	// The index is built without holding the lock, so the audio thread neither allocates
+	// nor waits for the sort. Only the editing thread changes the notes, so they can be
+	// read here without the lock.
+	auto notes = m_notes;
+	std::stable_sort(notes.begin(), notes.end(),
+		[](const Note* lhs, const Note* rhs) { return lhs->pos() < rhs->pos(); });
+
+	auto positions = std::vector<tick_t>(notes.size());
+	std::transform(notes.begin(), notes.end(), positions.begin(),
+		[](const Note* note) { return note->pos().getTicks(); });
+
+	instrumentTrack()->lock();
+	m_startIndexNotes.swap(notes);
+	m_startIndexPositions.swap(positions);
+	m_startIndexCursor = 0;
+	instrumentTrack()->unlock();
+
+	// the previous index is freed here, after the lock has been released
+}
+
+
+
+
+void MidiClip::insertIntoStartIndex(Note* note)
+{
+	// notes at the same position keep the order they were added in
+	const auto pos = note->pos().getTicks();
+	const auto index = std::upper_bound(m_startIndexPositions.begin(), m_startIndexPositions.end(), pos)
+		- m_startIndexPositions.begin();
+
+	if (m_startIndexNotes.size() < m_startIndexNotes.capacity()
+		&& m_startIndexPositions.size() < m_startIndexPositions.capacity())
+	{
+		// there is enough room, so inserting doesn't allocate and can be done under the lock
+		instrumentTrack()->lock();
+		m_startIndexNotes.insert(m_startIndexNotes.begin() + index, note);
+		m_startIndexPositions.insert(m_startIndexPositions.begin() + index, pos);
+		m_startIndexCursor = 0;
+		instrumentTrack()->unlock();
+		return;
+	}
+
+	// Otherwise grow a copy without holding the lock, like updateStartIndex() does. The
+	// capacity is doubled, so adding many notes in a row only reallocates a few times.
+	const auto capacity = std::max<std::size_t>(16, 2 * m_startIndexNotes.size());
+
+	auto notes = NoteVector{};
+	notes.reserve(capacity);
+	notes.insert(notes.end(), m_startIndexNotes.begin(), m_startIndexNotes.end());
+	notes.insert(notes.begin() + index, note);
+
+	auto positions = std::vector<tick_t>{};
+	positions.reserve(capacity);
+	positions.insert(positions.end(), m_startIndexPositions.begin(), m_startIndexPositions.end());
+	positions.insert(positions.begin() + index, pos);
+
+	instrumentTrack()->lock();
+	m_startIndexNotes.swap(notes);
+	m_startIndexPositions.swap(positions);
+	m_startIndexCursor = 0;
+	instrumentTrack()->unlock();
+}
+
+
+
+
+void MidiClip::removeFromStartIndex(const Note* note)
+{
+	// erasing doesn't allocate, so this can be done under the lock
+	const auto it = std::find(m_startIndexNotes.begin(), m_startIndexNotes.end(), note);
+	if (it == m_startIndexNotes.end()) { return; }
+
+	m_startIndexPositions.erase(m_startIndexPositions.begin() + (it - m_startIndexNotes.begin()));
+	m_startIndexNotes.erase(it);
+	m_startIndexCursor = 0;
+}
+
+
+
+
+void MidiClip::emitDataChangedKeepingStartIndex()
+{
+	// updateStartIndex() is connected to dataChanged(), since notes may also be changed in place.
+	// If the connection is queued, the index is rebuilt anyway, which is harmless.
+	m_startIndexUpToDate = true;
+	emit dataChanged();
+	m_startIndexUpToDate = false;
+}
+
+
+
+
+std::size_t MidiClip::seekStartIndex(tick_t pos) const
+{
+	const auto begin = m_startIndexPositions.begin();
+	const auto cursor = begin + m_startIndexCursor;
+
+	// during playback the position only moves forward, except when jumping or looping
+	const auto it = cursor == begin || *(cursor - 1) < pos
+		? std::lower_bound(cursor, m_startIndexPositions.end(), pos)
+		: std::lower_bound(begin, cursor, pos);
+	return it - begin;
+}
+
+
+
+
 MidiClip *  MidiClip::previousMidiClip() const
 {
 	return adjacentMidiClipByOffset(-1);
@@ -0,0 +1,124 @@
+/*
+ * DataFileUpgradeBenchmark.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QDir>
+#include <QDirIterator>
+#include <QDomDocument>
+#include <QFile>
+#include <QtTest>
+
+#include <vector>
+
+#include "ConfigManager.h"
+#include "DataFile.h"
+#include "../core/DataFileTestAccess.h"
+
+//! Compares upgrading old projects with all element upgrades in a single traversal
+//! of the document against one traversal per upgrade
+class DataFileUpgradeBenchmark : public QObject
+{
+	Q_OBJECT
+private:
+	static constexpr int LargeProjectTracks = 500;
+
+	std::vector<QByteArray> m_legacyProjects;
+	QByteArray m_largeProject;
+	std::vector<QByteArray> m_factoryProjects;
+
+	static auto readFiles(const QString& dir) -> std::vector<QByteArray>
+	{
+		auto result = std::vector<QByteArray>{};
+		auto it = QDirIterator{dir, {"*.mmp", "*.mmpz", "*.mpt"}, QDir::Files, QDirIterator::Subdirectories};
+		while (it.hasNext())
+		{
+			auto file = QFile{it.next()};
+			if (file.open(QIODevice::ReadOnly)) { result.push_back(file.readAll()); }
+		}
+		return result;
+	}
+
+	static void traversalData()
+	{
+		QTest::addColumn<bool>("perUpgrade");
+		QTest::newRow("combined") << false;
+		QTest::newRow("per upgrade") << true;
+	}
+
+	static void upgrade(const std::vector<QByteArray>& projects)
+	{
+		using namespace lmms;
+		QFETCH(bool, perUpgrade);
+		QBENCHMARK
+		{
+			for (const auto& project : projects)
+			{
+				const auto file = perUpgrade ? DataFileTestAccess::loadUpgradingPerRoutine(project) : DataFile{project};
+				QVERIFY(!file.documentElement().isNull());
+			}
+		}
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+
+		const auto legacyDir = QFINDTESTDATA("../../projects/legacy");
+		QVERIFY(!legacyDir.isEmpty());
+		m_legacyProjects = readFiles(legacyDir);
+		QVERIFY(!m_legacyProjects.empty());
+
+		m_factoryProjects = readFiles(ConfigManager::inst()->factoryProjectsDir());
+		QVERIFY(!m_factoryProjects.empty());
+
+		// An old project with many tracks, where the number of traversals of the document matters most
+		auto file = QFile{QFINDTESTDATA("../../projects/legacy/0.2.0-channeltracks.mmp")};
+		QVERIFY(file.open(QIODevice::ReadOnly));
+		auto large = QDomDocument{};
+		QVERIFY(large.setContent(file.readAll()));
+		auto trackContainer = large.elementsByTagName("trackcontainer").item(0);
+		const auto tracks = trackContainer.childNodes();
+		const auto count = tracks.size();
+		for (int i = 0; trackContainer.childNodes().size() < LargeProjectTracks; i = (i + 1) % count)
+		{
+			trackContainer.appendChild(tracks.item(i).cloneNode());
+		}
+		m_largeProject = large.toByteArray();
+	}
+
+	//! The small hand-written projects from all eras in tests/projects/legacy
+	void benchmarkLegacyProjects_data() { traversalData(); }
+	void benchmarkLegacyProjects() { upgrade(m_legacyProjects); }
+
+	//! The oldest of them with its tracks repeated
+	void benchmarkLargeProject_data() { traversalData(); }
+	void benchmarkLargeProject() { upgrade({m_largeProject}); }
+
+	//! All factory projects at once, as `lmms upgrade` would go through a batch of them
+	void benchmarkFactoryProjects_data() { traversalData(); }
+	void benchmarkFactoryProjects() { upgrade(m_factoryProjects); }
+};
+
+QTEST_GUILESS_MAIN(DataFileUpgradeBenchmark)
+#include "DataFileUpgradeBenchmark.moc"
@@ -0,0 +1,114 @@
+/*
+ * MixHelpersBenchmark.cpp - benchmark for the MixHelpers with every supported instruction set
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include <vector>
+
+#include "MixHelpers.h"
+#include "SampleFrame.h"
+#include "ValueBuffer.h"
+
+Q_DECLARE_METATYPE(lmms::MixHelpers::Implementation)
+
+class MixHelpersBenchmark : public QObject
+{
+	Q_OBJECT
+private:
+	//! A typical period size
+	static constexpr int Frames = 256;
+
+	std::vector<lmms::SampleFrame> m_dst = std::vector<lmms::SampleFrame>(Frames, lmms::SampleFrame{0.1f, -0.1f});
+	std::vector<lmms::SampleFrame> m_src = std::vector<lmms::SampleFrame>(Frames, lmms::SampleFrame{0.2f, 0.3f});
+	lmms::ValueBuffer m_coeffs = lmms::ValueBuffer{Frames};
+	lmms::MixHelpers::Implementation m_defaultImplementation = lmms::MixHelpers::Implementation::Scalar;
+
+	//! Adds a row for every implementation supported by the CPU
+	static void implementationData()
+	{
+		using namespace lmms;
+		QTest::addColumn<MixHelpers::Implementation>("implementation");
+		for (const auto impl : MixHelpers::supportedImplementations())
+		{
+			static constexpr const char* names[] = {"Scalar", "SSE2", "AVX2", "AVX512", "NEON"};
+			QTest::newRow(names[static_cast<int>(impl)]) << impl;
+		}
+	}
+
+	static void selectImplementation()
+	{
+		using namespace lmms;
+		QFETCH(MixHelpers::Implementation, implementation);
+		QVERIFY(MixHelpers::setImplementation(implementation));
+	}
+
+private slots:
+	void initTestCase()
+	{
+		m_defaultImplementation = lmms::MixHelpers::implementation();
+		m_coeffs.fill(0.5f);
+	}
+
+	void cleanupTestCase()
+	{
+		lmms::MixHelpers::setImplementation(m_defaultImplementation);
+	}
+
+	void benchmarkAdd_data() { implementationData(); }
+	void benchmarkAdd()
+	{
+		using namespace lmms;
+		selectImplementation();
+		QBENCHMARK { MixHelpers::add(m_dst.data(), m_src.data(), Frames); }
+	}
+
+	void benchmarkAddMultiplied_data() { implementationData(); }
+	void benchmarkAddMultiplied()
+	{
+		using namespace lmms;
+		selectImplementation();
+		QBENCHMARK { MixHelpers::addMultiplied(m_dst.data(), m_src.data(), 0.5f, Frames); }
+	}
+
+	void benchmarkAddMultipliedByBuffer_data() { implementationData(); }
+	void benchmarkAddMultipliedByBuffer()
+	{
+		using namespace lmms;
+		selectImplementation();
+		QBENCHMARK { MixHelpers::addMultipliedByBuffer(m_dst.data(), m_src.data(), 0.5f, &m_coeffs, Frames); }
+	}
+
+	void benchmarkIsSilent_data() { implementationData(); }
+	void benchmarkIsSilent()
+	{
+		using namespace lmms;
+		selectImplementation();
+		// the worst case: all samples have to be checked
+		const auto silence = std::vector<SampleFrame>(Frames);
+		QBENCHMARK { QVERIFY(MixHelpers::isSilent(silence.data(), Frames)); }
+	}
+};
+
+QTEST_GUILESS_MAIN(MixHelpersBenchmark)
+#include "MixHelpersBenchmark.moc"
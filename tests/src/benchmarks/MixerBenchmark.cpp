@@ -0,0 +1,98 @@
+/*
+ * MixerBenchmark.cpp - benchmark for the processing graph of the mixer
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtTest>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "Mixer.h"
+
+class MixerBenchmark : public QObject
+{
+	Q_OBJECT
+private:
+	static constexpr int ChannelCount = 128;
+
+	//! Replace the default send to master of every channel but the first one with a send to @p target
+	static void routeChannels(auto target)
+	{
+		using namespace lmms;
+		Mixer* mixer = Engine::mixer();
+		for (int i = 2; i <= ChannelCount; ++i)
+		{
+			mixer->deleteChannelSend(i, 0);
+			mixer->createChannelSend(i, target(i));
+		}
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void init()
+	{
+		using namespace lmms;
+		Mixer* mixer = Engine::mixer();
+		mixer->clear();
+		for (int i = 0; i < ChannelCount; ++i)
+		{
+			mixer->createChannel();
+		}
+	}
+
+	//! All channels send to master directly
+	void benchmarkFlat()
+	{
+		using namespace lmms;
+		QBENCHMARK { Engine::audioEngine()->renderNextPeriod(); }
+	}
+
+	//! Every channel sends to the channel with half its index, forming a binary tree of depth 7
+	void benchmarkTree()
+	{
+		using namespace lmms;
+		routeChannels([](int i) { return i / 2; });
+		QBENCHMARK { Engine::audioEngine()->renderNextPeriod(); }
+	}
+
+	//! Every channel sends to the previous one, forming a single chain through all channels
+	void benchmarkChain()
+	{
+		using namespace lmms;
+		routeChannels([](int i) { return i - 1; });
+		QBENCHMARK { Engine::audioEngine()->renderNextPeriod(); }
+	}
+};
+
+QTEST_GUILESS_MAIN(MixerBenchmark)
+#include "MixerBenchmark.moc"
@@ -0,0 +1,147 @@
+/*
+ * OscillatorBenchmark.cpp - measures the Oscillator kernels per wave shape and modulation
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include <QtTest>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <vector>
+
+#include "AudioEngine.h"
+#include "AutomatableModel.h"
+#include "Engine.h"
+#include "Oscillator.h"
+#include "SampleBuffer.h"
+#include "SampleFrame.h"
+
+class OscillatorBenchmark : public QObject
+{
+	Q_OBJECT
+private:
+	//! A typical period size
+	static constexpr int Frames = 256;
+	static constexpr int Periods = 2000;
+	//! `modulationAlgo` of the rows without sub oscillator
+	static constexpr int NoSubOscillator = -1;
+
+	std::shared_ptr<const lmms::SampleBuffer> m_userWave;
+	std::shared_ptr<const lmms::OscillatorConstants::waveform_t> m_userWaveTable;
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+		// the table rows are meant to measure the band-limited path
+		Oscillator::waitForWaveTables();
+
+		// one period of a sine as user-defined wave
+		auto data = std::vector<SampleFrame>(1024);
+		for (std::size_t i = 0; i < data.size(); ++i)
+		{
+			const auto value = std::sin(2 * std::numbers::pi_v<float> * i / data.size());
+			data[i] = SampleFrame{value, value};
+		}
+		m_userWave = std::make_shared<SampleBuffer>(std::move(data), 44100);
+		m_userWaveTable = Oscillator::generateAntiAliasUserWaveTable(m_userWave.get());
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		m_userWaveTable.reset();
+		m_userWave.reset();
+		Engine::destroy();
+	}
+
+	void benchmarkUpdate_data()
+	{
+		using namespace lmms;
+		QTest::addColumn<int>("waveShape");
+		QTest::addColumn<int>("modulationAlgo");
+		QTest::addColumn<bool>("useWaveTable");
+
+		static constexpr const char* shapes[] = {
+			"Sine", "Triangle", "Saw", "Square", "MoogSaw", "Exponential", "WhiteNoise", "UserDefined"};
+		static constexpr const char* algos[] = {"PM", "AM", "Mix", "Sync", "FM"};
+		static_assert(std::size(shapes) == Oscillator::NumWaveShapes);
+		static_assert(std::size(algos) == Oscillator::NumModulationAlgos);
+
+		for (int shape = 0; shape < static_cast<int>(Oscillator::NumWaveShapes); ++shape)
+		{
+			for (int algo = NoSubOscillator; algo < static_cast<int>(Oscillator::NumModulationAlgos); ++algo)
+			{
+				for (const bool useWaveTable : {false, true})
+				{
+					const auto name = QString{"%1/%2/%3"}
+						.arg(shapes[shape], algo == NoSubOscillator ? "None" : algos[algo], useWaveTable ? "Table" : "Plain");
+					QTest::newRow(name.toUtf8().constData()) << shape << algo << useWaveTable;
+				}
+			}
+		}
+	}
+
+	//! Reports the time per sample, including the sub oscillator for modulated rows
+	void benchmarkUpdate()
+	{
+		using namespace lmms;
+		QFETCH(int, waveShape);
+		QFETCH(int, modulationAlgo);
+		QFETCH(bool, useWaveTable);
+
+		const auto shapeModel = IntModel{waveShape, 0, static_cast<int>(Oscillator::NumWaveShapes) - 1};
+		const auto algoModel = IntModel{std::max(modulationAlgo, 0), 0, static_cast<int>(Oscillator::NumModulationAlgos) - 1};
+		const auto sineModel = IntModel{static_cast<int>(Oscillator::WaveShape::Sine), 0, 0};
+
+		const float freq = 440.f;
+		const float detuning = 1.f / Engine::audioEngine()->outputSampleRate();
+		const float phaseOffset = 0.f;
+		const float volume = 1.f;
+
+		auto subOsc = Oscillator{&sineModel, &algoModel, freq, detuning, phaseOffset, volume};
+		auto osc = Oscillator{&shapeModel, &algoModel, freq, detuning, phaseOffset, volume,
+			modulationAlgo == NoSubOscillator ? nullptr : &subOsc};
+		osc.setUseWaveTable(useWaveTable);
+		osc.setUserWave(m_userWave);
+		osc.setUserAntiAliasWaveTable(m_userWaveTable);
+
+		auto buffer = std::vector<SampleFrame>(Frames);
+
+		const auto start = std::chrono::steady_clock::now();
+		for (int period = 0; period < Periods; ++period)
+		{
+			osc.update(buffer.data(), Frames, 0);
+		}
+		const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+		QTest::setBenchmarkResult(elapsed.count() / (Frames * Periods), QTest::WalltimeNanoseconds);
+	}
+};
+
+QTEST_GUILESS_MAIN(OscillatorBenchmark)
+#include "OscillatorBenchmark.moc"
@@ -0,0 +1,115 @@
+/*
+ * ProjectLoadBenchmark.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include <random>
+#include <vector>
+
+#include "DataFile.h"
+#include "SampleBuffer.h"
+#include "SampleFrame.h"
+
+//! Compares loading a project with embedded samples from .mmp, .mmpz and .mmpc (ProjectArchive) files
+class ProjectLoadBenchmark : public QObject
+{
+	Q_OBJECT
+private:
+	static constexpr int Clips = 8;
+	static constexpr int SampleRate = 44100;
+	static constexpr int FramesPerClip = 5 * SampleRate;
+
+	QTemporaryDir m_dir;
+
+	void formatData()
+	{
+		QTest::addColumn<QString>("path");
+		for (const auto extension : {"mmp", "mmpz", "mmpc"})
+		{
+			QTest::newRow(extension) << m_dir.filePath(QString{"project.%1"}.arg(extension));
+		}
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		QVERIFY(m_dir.isValid());
+
+		// Noise, which compresses about as badly as recorded audio
+		auto generator = std::minstd_rand{};
+		auto distribution = std::uniform_real_distribution<float>{-1.f, 1.f};
+		auto frames = std::vector<SampleFrame>(FramesPerClip);
+
+		auto project = DataFile{DataFile::Type::SongProject};
+		auto track = project.createElement("track");
+		project.content().appendChild(track);
+		for (int i = 0; i < Clips; ++i)
+		{
+			for (auto& frame : frames) { frame = SampleFrame{distribution(generator), distribution(generator)}; }
+
+			auto clip = project.createElement("sampleclip");
+			clip.setAttribute("pos", i * 192);
+			clip.setAttribute("data", SampleBuffer{frames.data(), frames.size(), SampleRate}.toBase64());
+			clip.setAttribute("sample_rate", SampleRate);
+			track.appendChild(clip);
+		}
+
+		for (const auto extension : {"mmp", "mmpz", "mmpc"})
+		{
+			QVERIFY(project.writeFile(m_dir.filePath(QString{"project.%1"}.arg(extension))));
+		}
+	}
+
+	//! Reading the file and building the DOM
+	void benchmarkOpen_data() { formatData(); }
+	void benchmarkOpen()
+	{
+		using namespace lmms;
+		QFETCH(QString, path);
+		QBENCHMARK { QVERIFY(!DataFile{path}.content().isNull()); }
+	}
+
+	//! Additionally restoring all samples, as Song::loadProject() does
+	void benchmarkLoad_data() { formatData(); }
+	void benchmarkLoad()
+	{
+		using namespace lmms;
+		QFETCH(QString, path);
+		QBENCHMARK
+		{
+			auto project = DataFile{path};
+			const auto clips = project.elementsByTagName("sampleclip");
+			for (int i = 0; i < clips.length(); ++i)
+			{
+				const auto buffer = SampleBuffer::fromAttribute(clips.item(i).toElement(), "data", SampleRate);
+				QCOMPARE(buffer->size(), std::size_t{FramesPerClip});
+			}
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(ProjectLoadBenchmark)
+#include "ProjectLoadBenchmark.moc"
@@ -749,6 +749,50 @@ private slots:
 		QCOMPARE(ab.silenceFlags()[2], true);  // updated!
 		QCOMPARE(ab.silenceFlags()[3], true);  // updated!
 	}
+
+	//! Verifies that writes to the 1st channel group made by this class
+	//! mark the interleaved buffer as out of sync
+	void InterleavedInSync_ResetByChangesToFirstGroup()
+	{
+		auto ab = AudioBuffer{10, 2};
+		ab.enableSilenceTracking(true);
+		ab.allocateInterleavedBuffer();
+		QCOMPARE(ab.interleavedInSync(), false);
+
+		// Add a 2nd stereo group
+		QVERIFY(ab.addGroup(2) != nullptr);
+
+		ab.setInterleavedInSync(true);
+		QCOMPARE(ab.interleavedInSync(), true);
+
+		// Changes to the 2nd channel group don't affect the interleaved buffer
+		ab.group(1).buffer(0)[5] = std::numeric_limits<float>::infinity();
+		ab.assumeNonSilent(2);
+		ab.sanitize(0b1111);
+		QCOMPARE(ab.interleavedInSync(), true);
+
+		// Neither does sanitizing or silencing channels that need no changes
+		ab.group(0).buffer(0)[5] = 1.f;
+		ab.assumeNonSilent(0);
+		ab.sanitize(0b0011);
+		ab.silenceChannels(0b0010);
+		QCOMPARE(ab.interleavedInSync(), true);
+
+		// Silencing a non-silent channel of the 1st channel group does
+		ab.silenceChannels(0b0001);
+		QCOMPARE(ab.interleavedInSync(), false);
+
+		// So does sanitizing one
+		ab.setInterleavedInSync(true);
+		ab.group(0).buffer(1)[5] = std::numeric_limits<float>::quiet_NaN();
+		ab.assumeNonSilent(1);
+		ab.sanitize(0b0010);
+		QCOMPARE(ab.interleavedInSync(), false);
+
+		ab.setInterleavedInSync(true);
+		ab.silenceAllChannels();
+		QCOMPARE(ab.interleavedInSync(), false);
+	}
 };
 
 QTEST_GUILESS_MAIN(AudioBufferTest)
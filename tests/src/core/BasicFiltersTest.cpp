@@ -0,0 +1,131 @@
+/*
+ * BasicFiltersTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QObject>
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "BasicFilters.h"
+
+class BasicFiltersTest : public QObject
+{
+	Q_OBJECT
+
+	using Filter = lmms::BasicFilters<2>;
+
+	static constexpr auto SampleRate = 44100;
+	static constexpr auto Frames = 4096;
+
+	static std::vector<lmms::SampleFrame> input()
+	{
+		auto frames = std::vector<lmms::SampleFrame>(Frames);
+		for (std::size_t i = 0; i < frames.size(); ++i)
+		{
+			frames[i] = lmms::SampleFrame{0.4f * std::sin(i * 0.37f), 0.4f * std::cos(i * 0.11f)};
+		}
+		return frames;
+	}
+
+private slots:
+	void process_data()
+	{
+		QTest::addColumn<int>("type");
+		for (int type = 0; type <= static_cast<int>(Filter::FilterType::Tripole); ++type)
+		{
+			QTest::addRow("%d", type) << type;
+		}
+	}
+
+	//! Processing a block must give the same result as updating each sample
+	void process()
+	{
+		QFETCH(int, type);
+
+		auto reference = Filter{SampleRate};
+		auto filter = Filter{SampleRate};
+		reference.setFilterType(static_cast<Filter::FilterType>(type));
+		filter.setFilterType(static_cast<Filter::FilterType>(type));
+		reference.calcFilterCoeffs(1000.f, 0.7f);
+		filter.calcFilterCoeffs(1000.f, 0.7f);
+
+		const auto in = input();
+		auto out = in;
+		filter.process(out.data(), out.size());
+
+		for (std::size_t i = 0; i < in.size(); ++i)
+		{
+			QCOMPARE(out[i][0], reference.update(in[i][0], 0));
+			QCOMPARE(out[i][1], reference.update(in[i][1], 1));
+		}
+	}
+
+	void processModulated_data()
+	{
+		process_data();
+	}
+
+	//! Interpolating the coefficients of a sweep must stay close to recomputing them for each sample
+	void processModulated()
+	{
+		QFETCH(int, type);
+
+		auto reference = Filter{SampleRate};
+		auto filter = Filter{SampleRate};
+		reference.setFilterType(static_cast<Filter::FilterType>(type));
+		filter.setFilterType(static_cast<Filter::FilterType>(type));
+
+		auto freq = std::vector<float>(Frames);
+		auto q = std::vector<float>(Frames);
+		for (std::size_t i = 0; i < freq.size(); ++i)
+		{
+			freq[i] = 200.f + 5000.f * i / Frames;
+			q[i] = 0.2f + 0.3f * i / Frames;
+		}
+
+		const auto in = input();
+		auto out = in;
+		filter.process(out.data(), out.size(), freq.data(), q.data());
+
+		auto peak = 0.f;
+		auto maxError = 0.f;
+		for (std::size_t i = 0; i < in.size(); ++i)
+		{
+			reference.calcFilterCoeffs(freq[i], q[i]);
+			for (lmms::ch_cnt_t ch = 0; ch < 2; ++ch)
+			{
+				const auto expected = reference.update(in[i][ch], ch);
+				peak = std::max(peak, std::abs(expected));
+				maxError = std::max(maxError, std::abs(out[i][ch] - expected));
+			}
+		}
+
+		QVERIFY(maxError <= 0.05f * peak);
+	}
+};
+
+QTEST_GUILESS_MAIN(BasicFiltersTest)
+#include "BasicFiltersTest.moc"
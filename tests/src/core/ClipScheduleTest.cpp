@@ -0,0 +1,235 @@
+/*
+ * ClipScheduleTest.cpp - tests the lookup of playing clips
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ClipSchedule.h"
+
+#include <QtTest>
+
+#include <algorithm>
+#include <vector>
+
+#include "Engine.h"
+#include "InstrumentTrack.h"
+#include "MidiClip.h"
+#include "Song.h"
+
+class ClipScheduleTest : public QObject
+{
+	Q_OBJECT
+private:
+	static lmms::Clip* createClip(lmms::InstrumentTrack& track, lmms::tick_t start, lmms::tick_t length)
+	{
+		using namespace lmms;
+
+		// owned by the track
+		auto clip = new MidiClip(&track);
+		clip->movePosition(TimePos(start));
+		clip->changeLength(TimePos(length));
+		return clip;
+	}
+
+	//! The lookup Track::getClipsInRange() did before using the schedule
+	static void linearScan(std::vector<lmms::Clip*>& clips, const std::vector<lmms::Clip*>& trackClips,
+		const lmms::TimePos& start, const lmms::TimePos& end)
+	{
+		using namespace lmms;
+
+		for (Clip* clip : trackClips)
+		{
+			int s = clip->startPosition();
+			int e = clip->endPosition();
+			if ((s <= end) && (e >= start))
+			{
+				clips.insert(std::upper_bound(clips.begin(), clips.end(), clip, Clip::comparePosition), clip);
+			}
+		}
+	}
+
+	static std::vector<lmms::Clip*> clipsInRange(const lmms::ClipSchedule& schedule, lmms::tick_t start,
+		lmms::tick_t end)
+	{
+		auto clips = std::vector<lmms::Clip*>{};
+		schedule.clipsInRange(clips, lmms::TimePos(start), lmms::TimePos(end));
+		return clips;
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testSortedInsertion()
+	{
+		using namespace lmms;
+
+		InstrumentTrack track(Engine::getSong());
+		Clip* c = createClip(track, 384, 192);
+		Clip* a = createClip(track, 0, 192);
+		Clip* b = createClip(track, 192, 192);
+		const auto schedule = ClipSchedule({c, a, b});
+
+		QCOMPARE(clipsInRange(schedule, 0, 1000), (std::vector<Clip*>{a, b, c}));
+
+		// the clips of other tracks already in the result stay sorted as well
+		InstrumentTrack otherTrack(Engine::getSong());
+		Clip* other = createClip(otherTrack, 100, 192);
+		auto clips = std::vector<Clip*>{other};
+		schedule.clipsInRange(clips, TimePos(0), TimePos(1000));
+		QCOMPARE(clips, (std::vector<Clip*>{a, other, b, c}));
+	}
+
+	void testRangeBoundaries()
+	{
+		using namespace lmms;
+
+		InstrumentTrack track(Engine::getSong());
+		Clip* a = createClip(track, 0, 192);
+		Clip* b = createClip(track, 384, 192);
+		const auto schedule = ClipSchedule({a, b});
+
+		// the range and the clips include both of their ends
+		QCOMPARE(clipsInRange(schedule, 192, 192), (std::vector<Clip*>{a}));
+		QCOMPARE(clipsInRange(schedule, 384, 384), (std::vector<Clip*>{b}));
+		QCOMPARE(clipsInRange(schedule, 192, 384), (std::vector<Clip*>{a, b}));
+		QVERIFY(clipsInRange(schedule, 193, 383).empty());
+		QVERIFY(clipsInRange(schedule, 577, 1000).empty());
+	}
+
+	void testOverlappingClips()
+	{
+		using namespace lmms;
+
+		InstrumentTrack track(Engine::getSong());
+		Clip* a = createClip(track, 0, 300);
+		Clip* b = createClip(track, 100, 300);
+		Clip* c = createClip(track, 200, 50);
+		const auto schedule = ClipSchedule({a, b, c});
+
+		QCOMPARE(clipsInRange(schedule, 220, 230), (std::vector<Clip*>{a, b, c}));
+		QCOMPARE(clipsInRange(schedule, 260, 280), (std::vector<Clip*>{a, b}));
+		QCOMPARE(clipsInRange(schedule, 350, 360), (std::vector<Clip*>{b}));
+	}
+
+	void testLongSpanningClip()
+	{
+		using namespace lmms;
+
+		// The long clip starts first, so it is found through the maximum end of all previous clips,
+		// which keeps the search from stopping at the short clips ending before the range
+		InstrumentTrack track(Engine::getSong());
+		Clip* spanning = createClip(track, 0, 100000);
+		auto clips = std::vector<Clip*>{spanning};
+		for (tick_t start = 192; start < 96000; start += 192)
+		{
+			clips.push_back(createClip(track, start, 96));
+		}
+		const auto schedule = ClipSchedule(clips);
+
+		// between the short clips [49920, 50016] and [50112, 50208]
+		const auto found = clipsInRange(schedule, 50017, 50100);
+		QCOMPARE(found.size(), std::size_t{1});
+		QCOMPARE(found.front(), spanning);
+
+		QCOMPARE(clipsInRange(schedule, 99000, 200000), (std::vector<Clip*>{spanning}));
+		QVERIFY(clipsInRange(schedule, 100001, 200000).empty());
+	}
+
+	void testEarlyExit()
+	{
+		using namespace lmms;
+
+		// None of the clips before the range reaches it, so only the last one may be returned
+		InstrumentTrack track(Engine::getSong());
+		auto clips = std::vector<Clip*>{};
+		for (tick_t start = 0; start < 19200; start += 192)
+		{
+			clips.push_back(createClip(track, start, 96));
+		}
+		const auto schedule = ClipSchedule(clips);
+
+		QCOMPARE(clipsInRange(schedule, 19008, 19010), (std::vector<Clip*>{clips.back()}));
+		QCOMPARE(clipsInRange(schedule, 18900, 19010), (std::vector<Clip*>{clips[clips.size() - 2], clips.back()}));
+		QVERIFY(clipsInRange(schedule, 19105, 19200).empty());
+	}
+
+	void testZeroLengthClips()
+	{
+		using namespace lmms;
+
+		InstrumentTrack track(Engine::getSong());
+		Clip* a = createClip(track, 100, 0);
+		Clip* b = createClip(track, 100, 0);
+		Clip* c = createClip(track, 200, 0);
+		const auto schedule = ClipSchedule({c, a, b});
+
+		QCOMPARE(clipsInRange(schedule, 100, 100), (std::vector<Clip*>{a, b}));
+		QCOMPARE(clipsInRange(schedule, 0, 100), (std::vector<Clip*>{a, b}));
+		QCOMPARE(clipsInRange(schedule, 100, 200), (std::vector<Clip*>{a, b, c}));
+		QVERIFY(clipsInRange(schedule, 101, 199).empty());
+	}
+
+	void testMatchesLinearScan()
+	{
+		using namespace lmms;
+
+		InstrumentTrack track(Engine::getSong());
+
+		// deterministic pseudo-random clips of all kinds: overlapping, nested, long and empty ones
+		unsigned state = 12345;
+		const auto random = [&state](unsigned max) {
+			state = state * 1103515245 + 12345;
+			return static_cast<tick_t>((state >> 8) % max);
+		};
+
+		auto clips = std::vector<Clip*>{};
+		for (int i = 0; i < 300; ++i)
+		{
+			const auto length = i % 10 == 0 ? 0 : i % 25 == 0 ? random(20000) : random(800);
+			clips.push_back(createClip(track, random(20000), length));
+		}
+		const auto schedule = ClipSchedule(clips);
+
+		for (int i = 0; i < 2000; ++i)
+		{
+			const auto start = random(22000);
+			const auto end = start + (i % 3 == 0 ? 0 : random(1000));
+
+			auto expected = std::vector<Clip*>{};
+			linearScan(expected, clips, TimePos(start), TimePos(end));
+
+			QCOMPARE(clipsInRange(schedule, start, end), expected);
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(ClipScheduleTest)
+#include "ClipScheduleTest.moc"
@@ -0,0 +1,80 @@
+/*
+ * DataFileTestAccess.h - upgrades projects like DataFile did before the upgrades shared a traversal
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_DATA_FILE_TEST_ACCESS_H
+#define LMMS_DATA_FILE_TEST_ACCESS_H
+
+#include <QByteArray>
+#include <cstddef>
+
+#include "DataFile.h"
+#include "DeprecationHelper.h"
+
+namespace lmms
+{
+
+//! Befriended by DataFile when building the tests
+struct DataFileTestAccess
+{
+	/**
+	 * Loads the project in @p data like the DataFile constructors, but runs every element upgrade over the
+	 * whole document on its own instead of letting consecutive ones share a traversal, as DataFile::upgrade()
+	 * does. Archives are not supported.
+	 */
+	static auto loadUpgradingPerRoutine(const QByteArray& data) -> DataFile
+	{
+		auto file = DataFile{DataFile::Type::Unknown};
+		if (!setContent(file, data) && !setContent(file, qUncompress(data))) { return file; }
+
+		// As in DataFile::loadData()
+		const auto root = file.documentElement();
+		file.m_type = DataFile::type(root.attribute("type"));
+		file.m_head = root.elementsByTagName("head").item(0).toElement();
+		file.m_fileVersion = !root.hasAttribute("version") || root.attribute("version") == "1.0"
+			? file.legacyFileVersion()
+			: root.attribute("version").toUInt();
+
+		const auto upgrades = DataFile::UPGRADE_METHODS.size();
+		if (file.m_fileVersion < upgrades)
+		{
+			for (auto i = std::size_t{file.m_fileVersion}; i < upgrades; ++i)
+			{
+				const auto& upgrade = DataFile::UPGRADE_METHODS[i];
+				if (upgrade.documentMethod) { (file.*upgrade.documentMethod)(); }
+				else { file.upgradeElements(i, i); }
+			}
+
+			// Nothing is left to upgrade, so this only updates the meta data
+			file.m_fileVersion = upgrades;
+			file.upgrade();
+		}
+
+		file.m_content = root.elementsByTagName(DataFile::typeName(file.m_type)).item(0).toElement();
+		return file;
+	}
+};
+
+} // namespace lmms
+
+#endif // LMMS_DATA_FILE_TEST_ACCESS_H
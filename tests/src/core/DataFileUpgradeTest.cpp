@@ -0,0 +1,255 @@
+/*
+ * DataFileUpgradeTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QObject>
+#include <QtTest>
+
+#include "ConfigManager.h"
+#include "DataFile.h"
+#include "DataFileTestAccess.h"
+#include "Note.h"
+
+class DataFileUpgradeTest : public QObject
+{
+	Q_OBJECT
+private:
+	static auto legacyProject(const QString& name) -> QString
+	{
+		return QFINDTESTDATA("../../projects/legacy/" + name);
+	}
+
+	static auto firstElement(const lmms::DataFile& project, const QString& tagName) -> QDomElement
+	{
+		return project.elementsByTagName(tagName).item(0).toElement();
+	}
+
+	//! Describes the first difference between two element trees, or returns an empty string if
+	//! they match. Attributes are compared as sets, since QDom doesn't keep their order.
+	static auto difference(const QDomElement& actual, const QDomElement& expected, const QString& path) -> QString
+	{
+		const auto here = path + "/" + expected.tagName();
+		if (actual.tagName() != expected.tagName())
+		{
+			return QString{"%1: found <%2>"}.arg(here, actual.tagName());
+		}
+
+		const auto actualAttributes = attributes(actual);
+		const auto expectedAttributes = attributes(expected);
+		for (auto it = expectedAttributes.begin(); it != expectedAttributes.end(); ++it)
+		{
+			if (!actualAttributes.contains(it.key()))
+			{
+				return QString{"%1: missing attribute %2=\"%3\""}.arg(here, it.key(), it.value());
+			}
+			if (actualAttributes[it.key()] != it.value())
+			{
+				return QString{"%1: attribute %2 is \"%3\", expected \"%4\""}
+					.arg(here, it.key(), actualAttributes[it.key()], it.value());
+			}
+		}
+		for (auto it = actualAttributes.begin(); it != actualAttributes.end(); ++it)
+		{
+			if (!expectedAttributes.contains(it.key()))
+			{
+				return QString{"%1: unexpected attribute %2=\"%3\""}.arg(here, it.key(), it.value());
+			}
+		}
+
+		auto actualChild = actual.firstChildElement();
+		auto expectedChild = expected.firstChildElement();
+		for (int i = 0; !actualChild.isNull() && !expectedChild.isNull(); ++i)
+		{
+			const auto childDifference = difference(actualChild, expectedChild, QString{"%1[%2]"}.arg(here).arg(i));
+			if (!childDifference.isEmpty()) { return childDifference; }
+			actualChild = actualChild.nextSiblingElement();
+			expectedChild = expectedChild.nextSiblingElement();
+		}
+		if (!actualChild.isNull()) { return QString{"%1: unexpected child <%2>"}.arg(here, actualChild.tagName()); }
+		if (!expectedChild.isNull()) { return QString{"%1: missing child <%2>"}.arg(here, expectedChild.tagName()); }
+		return QString{};
+	}
+
+	static auto attributes(const QDomElement& element) -> QMap<QString, QString>
+	{
+		auto result = QMap<QString, QString>{};
+		const auto nodes = element.attributes();
+		for (int i = 0; i < nodes.length(); ++i)
+		{
+			result[nodes.item(i).nodeName()] = nodes.item(i).nodeValue();
+		}
+		return result;
+	}
+
+private slots:
+	//! Running the element upgrades in a single traversal must give the same
+	//! result as running each of them over the whole document
+	void combinedTraversalMatchesPerUpgrade_data()
+	{
+		using namespace lmms;
+
+		QTest::addColumn<QString>("path");
+
+		const auto legacyDir = QFINDTESTDATA("../../projects/legacy");
+		QVERIFY(!legacyDir.isEmpty());
+		const auto dirs = QStringList{legacyDir, ConfigManager::inst()->factoryProjectsDir()};
+		for (const auto& dir : dirs)
+		{
+			auto it = QDirIterator{dir, {"*.mmp", "*.mmpz", "*.mpt"}, QDir::Files, QDirIterator::Subdirectories};
+			while (it.hasNext())
+			{
+				const auto path = it.next();
+				QTest::newRow(qPrintable(QDir{dir}.relativeFilePath(path))) << path;
+			}
+		}
+	}
+
+	void combinedTraversalMatchesPerUpgrade()
+	{
+		using namespace lmms;
+
+		QFETCH(QString, path);
+
+		auto file = QFile{path};
+		QVERIFY(file.open(QIODevice::ReadOnly));
+		const auto expected = DataFileTestAccess::loadUpgradingPerRoutine(file.readAll()).toString();
+		const auto actual = DataFile{path}.toString();
+
+		QVERIFY(!expected.isEmpty());
+		QCOMPARE(actual, expected);
+	}
+
+	//! Each project of the legacy corpus must upgrade to the document in legacy/expected. These
+	//! were recorded with the per-routine upgrades that predate the single traversal.
+	void upgradesToExpectedDocuments_data()
+	{
+		QTest::addColumn<QString>("path");
+
+		const auto legacyDir = QFINDTESTDATA("../../projects/legacy");
+		QVERIFY(!legacyDir.isEmpty());
+		for (const auto& name : QDir{legacyDir}.entryList({"*.mmp"}, QDir::Files))
+		{
+			QTest::newRow(qPrintable(name)) << QDir{legacyDir}.filePath(name);
+		}
+	}
+
+	void upgradesToExpectedDocuments()
+	{
+		using namespace lmms;
+
+		QFETCH(QString, path);
+
+		auto expectedFile = QFile{QFileInfo{path}.dir().filePath("expected/" + QFileInfo{path}.completeBaseName() + ".xml")};
+		QVERIFY2(expectedFile.open(QIODevice::ReadOnly), qPrintable(expectedFile.fileName()));
+		auto expected = QDomDocument{};
+		QVERIFY(expected.setContent(&expectedFile));
+
+		const auto project = DataFile{path};
+		auto actual = project.documentElement();
+		QVERIFY(!actual.isNull());
+
+		// These depend on the build that upgraded the project
+		for (const auto name : {"creatorversion", "creatorplatform", "creatorplatformtype"})
+		{
+			QVERIFY(actual.hasAttribute(name));
+			actual.removeAttribute(name);
+		}
+
+		const auto mismatch = difference(actual, expected.documentElement(), QString{});
+		QVERIFY2(mismatch.isEmpty(), qPrintable(mismatch));
+	}
+
+	void upgradesEarlyProjects()
+	{
+		using namespace lmms;
+
+		const auto project = DataFile{legacyProject("0.2.0-channeltracks.mmp")};
+
+		const auto head = project.documentElement().firstChildElement("head");
+		QCOMPARE(head.attribute("bpm"), QString{"128"});
+		QCOMPARE(head.attribute("masterpitch"), QString{"-2"});
+		QVERIFY(head.firstChildElement().isNull());
+
+		const auto track = firstElement(project, "instrumenttrack");
+		QCOMPARE(track.attribute("vol"), QString{"47"});
+		QCOMPARE(track.firstChildElement("instrument").firstChildElement().tagName(), QString{"vibedstrings"});
+		QCOMPARE(track.firstChildElement("arpeggiator").attribute("arpdir"), QString{"0"});
+		QVERIFY(!track.firstChildElement("chordcreator").isNull());
+		QVERIFY(!track.firstChildElement("midiport").isNull());
+
+		const auto fxchain = track.firstChildElement("fxchain");
+		QCOMPARE(fxchain.attribute("enabled"), QString{"1"});
+		QCOMPARE(fxchain.attribute("numofeffects"), QString{"1"});
+		QVERIFY(fxchain.firstChildElement("rack").isNull());
+		QCOMPARE(fxchain.firstChildElement("effect").firstChildElement("ladspacontrols").attribute("port01link"), QString{"1"});
+
+		const auto stepNote = firstElement(project, "midiclip").firstChildElement("note").nextSiblingElement("note");
+		QCOMPARE(stepNote.attribute("pos"), QString{"48"});
+		QCOMPARE(stepNote.attribute("len"), QString{"12"});
+		QCOMPARE(stepNote.attribute("type"), QString::number(static_cast<int>(Note::Type::Step)));
+
+		QCOMPARE(firstElement(project, "sampletrack").attribute("vol"), QString{"75"});
+		QCOMPARE(firstElement(project, "sampleclip").attribute("src"), QString{"bassloops/briff01 - 140 BPM.ogg"});
+		QCOMPARE(firstElement(project, "lb302").attribute("shape"), QString{"1"});
+		QCOMPARE(firstElement(project, "audiofileprocessor").attribute("src"), QString{"drumsynth/r_n_b/kick.ds"});
+		QCOMPARE(firstElement(project, "timeline").attribute("lp1pos"), QString{"192"});
+	}
+
+	void upgradesRenamedPlugins()
+	{
+		using namespace lmms;
+
+		const auto project = DataFile{legacyProject("1.1.3-plugins.mmp")};
+
+		const auto instruments = project.elementsByTagName("instrument");
+		QCOMPARE(instruments.item(0).toElement().attribute("name"), QString{"freeboy"});
+		QVERIFY(!instruments.item(0).firstChildElement("freeboy").isNull());
+		QCOMPARE(instruments.item(1).toElement().attribute("name"), QString{"opulenz"});
+
+		QCOMPARE(firstElement(project, "arpeggiator").attribute("arpdir"), QString{"3"});
+		QCOMPARE(firstElement(project, "crossoevereqcontrols").attribute("mute1"), QString{"1"});
+		QCOMPARE(firstElement(project, "crossoevereqcontrols").attribute("mute2"), QString{"0"});
+		QCOMPARE(firstElement(project, "instrumenttrack").attribute("mixch"), QString{"1"});
+		QVERIFY(!firstElement(project, "instrumenttrack").hasAttribute("fxch"));
+		QCOMPARE(project.elementsByTagName("mixerchannel").size(), 3);
+		QVERIFY(project.elementsByTagName("fxmixer").isEmpty());
+
+		const auto lfos = project.elementsByTagName("lfocontroller");
+		QCOMPARE(lfos.item(0).toElement().attribute("speed"), QString{"0.01"});
+		QCOMPARE(lfos.item(1).toElement().attribute("speed"), QString{"0.5"});
+		QCOMPARE(firstElement(project, "Midicontroller").attribute("inputcontroller"), QString{"6"});
+
+		QCOMPARE(firstElement(project, "sampleclip").attribute("src"), QString{"beats/break01 - 168 BPM.ogg"});
+		QCOMPARE(firstElement(project, "audiofileprocessor").attribute("src"),
+			QString{"/usr/share/lmms/samples/bassloops/techno_bass01.ogg"});
+		QCOMPARE(firstElement(project, "patterntrack").parentNode().toElement().attribute("name"), QString{"Pattern 0"});
+	}
+};
+
+QTEST_GUILESS_MAIN(DataFileUpgradeTest)
+#include "DataFileUpgradeTest.moc"
@@ -0,0 +1,286 @@
+/*
+ * MixHelpersTest.cpp - compares the vectorized MixHelpers with the scalar implementation
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QObject>
+#include <QtTest>
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "MixHelpers.h"
+#include "SampleFrame.h"
+#include "ValueBuffer.h"
+
+class MixHelpersTest : public QObject
+{
+	Q_OBJECT
+private:
+	using Implementation = lmms::MixHelpers::Implementation;
+
+	//! Longer than the widest vector plus a remainder, in frames
+	static constexpr int MaxFrames = 67;
+	//! Start offsets, in frames, to cover unaligned buffers
+	static constexpr int MaxOffset = 3;
+
+	std::mt19937 m_random{1234};
+	Implementation m_defaultImplementation = Implementation::Scalar;
+
+	auto randomSamples(std::size_t count) -> std::vector<float>
+	{
+		auto dist = std::uniform_real_distribution<float>{-2.f, 2.f};
+		auto result = std::vector<float>(count);
+		for (auto& sample : result) { sample = dist(m_random); }
+		return result;
+	}
+
+	auto randomFrames(int frames) -> std::vector<lmms::SampleFrame>
+	{
+		const auto samples = randomSamples(static_cast<std::size_t>(frames) * 2);
+		auto result = std::vector<lmms::SampleFrame>(frames);
+		std::memcpy(result.data(), samples.data(), samples.size() * sizeof(float));
+		return result;
+	}
+
+	/**
+		Runs @p op with the scalar implementation and every other supported one on copies
+		of the same random interleaved buffer and checks that the results are bit-exact.
+		@p op gets the destination and the number of frames to process.
+	*/
+	template<class Op>
+	void compareInterleaved(Op op)
+	{
+		using namespace lmms;
+		for (int frames = 1; frames <= MaxFrames; ++frames)
+		{
+			for (int offset = 0; offset <= MaxOffset; ++offset)
+			{
+				const auto input = randomFrames(frames + offset);
+
+				QVERIFY(MixHelpers::setImplementation(Implementation::Scalar));
+				auto expected = input;
+				op(expected.data() + offset, frames);
+
+				for (const auto impl : MixHelpers::supportedImplementations())
+				{
+					QVERIFY(MixHelpers::setImplementation(impl));
+					auto actual = input;
+					op(actual.data() + offset, frames);
+					QVERIFY2(std::memcmp(actual.data(), expected.data(), input.size() * sizeof(SampleFrame)) == 0,
+						qPrintable(QString{"implementation %1, %2 frames, offset %3"}
+							.arg(static_cast<int>(impl)).arg(frames).arg(offset)));
+				}
+			}
+		}
+	}
+
+	//! Same as compareInterleaved(), but for a planar stereo buffer
+	template<class Op>
+	void comparePlanar(Op op)
+	{
+		using namespace lmms;
+		for (int frames = 1; frames <= MaxFrames; ++frames)
+		{
+			for (int offset = 0; offset <= MaxOffset; ++offset)
+			{
+				const auto input = randomSamples(static_cast<std::size_t>(frames + offset) * 2);
+				const auto run = [&](std::vector<float>& buffer) {
+					auto channels = std::array{buffer.data() + offset, buffer.data() + frames + 2 * offset};
+					op(PlanarBufferView<sample_t>{channels.data(), 2, static_cast<f_cnt_t>(frames)});
+				};
+
+				QVERIFY(MixHelpers::setImplementation(Implementation::Scalar));
+				auto expected = input;
+				run(expected);
+
+				for (const auto impl : MixHelpers::supportedImplementations())
+				{
+					QVERIFY(MixHelpers::setImplementation(impl));
+					auto actual = input;
+					run(actual);
+					QVERIFY2(std::memcmp(actual.data(), expected.data(), input.size() * sizeof(float)) == 0,
+						qPrintable(QString{"implementation %1, %2 frames, offset %3"}
+							.arg(static_cast<int>(impl)).arg(frames).arg(offset)));
+				}
+			}
+		}
+	}
+
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		m_defaultImplementation = MixHelpers::implementation();
+
+		const auto supported = MixHelpers::supportedImplementations();
+		QCOMPARE(supported.front(), Implementation::Scalar);
+		QCOMPARE(supported.back(), m_defaultImplementation);
+		qInfo("Testing %d implementation(s)", static_cast<int>(supported.size()));
+	}
+
+	void cleanupTestCase()
+	{
+		lmms::MixHelpers::setImplementation(m_defaultImplementation);
+	}
+
+	void AddTest()
+	{
+		using namespace lmms;
+		const auto src = randomFrames(MaxFrames);
+		compareInterleaved([&](SampleFrame* dst, int frames) { MixHelpers::add(dst, src.data(), frames); });
+	}
+
+	void MultiplyTest()
+	{
+		using namespace lmms;
+		compareInterleaved([](SampleFrame* dst, int frames) { MixHelpers::multiply(dst, 0.7f, frames); });
+	}
+
+	void AddMultipliedTest()
+	{
+		using namespace lmms;
+		const auto src = randomFrames(MaxFrames);
+		compareInterleaved([&](SampleFrame* dst, int frames) {
+			MixHelpers::addMultiplied(dst, src.data(), 0.3f, frames);
+		});
+	}
+
+	void AddMultipliedByBufferTest()
+	{
+		using namespace lmms;
+		const auto src = randomFrames(MaxFrames);
+		auto coeffs = ValueBuffer{MaxFrames};
+		const auto values = randomSamples(MaxFrames);
+		std::copy(values.begin(), values.end(), coeffs.values());
+		compareInterleaved([&](SampleFrame* dst, int frames) {
+			MixHelpers::addMultipliedByBuffer(dst, src.data(), 1.3f, &coeffs, frames);
+		});
+	}
+
+	void AddMultipliedByBuffersTest()
+	{
+		using namespace lmms;
+		const auto src = randomFrames(MaxFrames);
+		auto coeffs1 = ValueBuffer{MaxFrames};
+		auto coeffs2 = ValueBuffer{MaxFrames};
+		const auto values1 = randomSamples(MaxFrames);
+		const auto values2 = randomSamples(MaxFrames);
+		std::copy(values1.begin(), values1.end(), coeffs1.values());
+		std::copy(values2.begin(), values2.end(), coeffs2.values());
+		compareInterleaved([&](SampleFrame* dst, int frames) {
+			MixHelpers::addMultipliedByBuffers(dst, src.data(), &coeffs1, &coeffs2, frames);
+		});
+	}
+
+	void PlanarAddTest()
+	{
+		using namespace lmms;
+		auto src = randomSamples(MaxFrames * 2);
+		auto channels = std::array<const sample_t*, 2>{src.data(), src.data() + MaxFrames};
+		comparePlanar([&](PlanarBufferView<sample_t> dst) {
+			MixHelpers::add(dst, PlanarBufferView<const sample_t>{channels.data(), 2, dst.frames()});
+		});
+	}
+
+	void PlanarMultiplyTest()
+	{
+		using namespace lmms;
+		comparePlanar([](PlanarBufferView<sample_t> dst) { MixHelpers::multiply(dst, -0.5f); });
+	}
+
+	void PlanarAddMultipliedTest()
+	{
+		using namespace lmms;
+		auto src = randomSamples(MaxFrames * 2);
+		auto channels = std::array<const sample_t*, 2>{src.data(), src.data() + MaxFrames};
+		comparePlanar([&](PlanarBufferView<sample_t> dst) {
+			MixHelpers::addMultiplied(dst, PlanarBufferView<const sample_t>{channels.data(), 2, dst.frames()}, 0.9f);
+		});
+	}
+
+	void PlanarAddMultipliedByBufferTest()
+	{
+		using namespace lmms;
+		auto src = randomSamples(MaxFrames * 2);
+		auto channels = std::array<const sample_t*, 2>{src.data(), src.data() + MaxFrames};
+		auto coeffs = ValueBuffer{MaxFrames};
+		const auto values = randomSamples(MaxFrames);
+		std::copy(values.begin(), values.end(), coeffs.values());
+		comparePlanar([&](PlanarBufferView<sample_t> dst) {
+			const auto srcView = PlanarBufferView<const sample_t>{channels.data(), 2, dst.frames()};
+			MixHelpers::addMultipliedByBuffer(dst, srcView, 0.8f, &coeffs);
+		});
+	}
+
+	void PlanarAddMultipliedByBuffersTest()
+	{
+		using namespace lmms;
+		auto src = randomSamples(MaxFrames * 2);
+		auto channels = std::array<const sample_t*, 2>{src.data(), src.data() + MaxFrames};
+		auto coeffs1 = ValueBuffer{MaxFrames};
+		auto coeffs2 = ValueBuffer{MaxFrames};
+		const auto values1 = randomSamples(MaxFrames);
+		const auto values2 = randomSamples(MaxFrames);
+		std::copy(values1.begin(), values1.end(), coeffs1.values());
+		std::copy(values2.begin(), values2.end(), coeffs2.values());
+		comparePlanar([&](PlanarBufferView<sample_t> dst) {
+			const auto srcView = PlanarBufferView<const sample_t>{channels.data(), 2, dst.frames()};
+			MixHelpers::addMultipliedByBuffers(dst, srcView, &coeffs1, &coeffs2);
+		});
+	}
+
+	void IsSilentTest()
+	{
+		using namespace lmms;
+		for (const auto impl : MixHelpers::supportedImplementations())
+		{
+			QVERIFY(MixHelpers::setImplementation(impl));
+			for (int frames = 1; frames <= MaxFrames; ++frames)
+			{
+				auto buffer = std::vector<SampleFrame>(frames, SampleFrame{0.0000009f, -0.0000009f});
+				QVERIFY(MixHelpers::isSilent(buffer.data(), frames));
+
+				// a single sample above the threshold must be found, wherever it is
+				for (int sample = 0; sample < frames * 2; ++sample)
+				{
+					auto loud = buffer;
+					loud[sample / 2][sample % 2] = sample % 3 == 0 ? -0.000001f : 0.5f;
+					QVERIFY(!MixHelpers::isSilent(loud.data(), frames));
+					QVERIFY(!MixHelpers::isSilent(std::span<const sample_t>{loud[0].data(),
+						static_cast<std::size_t>(frames) * 2}));
+				}
+
+				auto nan = buffer;
+				nan[frames - 1][1] = std::numeric_limits<float>::quiet_NaN();
+				QVERIFY(!MixHelpers::isSilent(nan.data(), frames));
+			}
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(MixHelpersTest)
+#include "MixHelpersTest.moc"
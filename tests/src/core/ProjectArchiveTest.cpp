@@ -0,0 +1,147 @@
+/*
+ * ProjectArchiveTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QBuffer>
+#include <QFile>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <cstring>
+#include <vector>
+
+#include "DataFile.h"
+#include "ProjectArchive.h"
+#include "SampleBuffer.h"
+#include "SampleFrame.h"
+
+class ProjectArchiveTest : public QObject
+{
+	Q_OBJECT
+private:
+	static auto frames() -> std::vector<lmms::SampleFrame>
+	{
+		auto frames = std::vector<lmms::SampleFrame>(1000);
+		for (std::size_t i = 0; i < frames.size(); ++i)
+		{
+			frames[i] = lmms::SampleFrame{i / 1000.f, -1.f + i / 1000.f};
+		}
+		return frames;
+	}
+
+	static auto toBase64(const std::vector<lmms::SampleFrame>& frames) -> QString
+	{
+		const auto bytes = QByteArray{reinterpret_cast<const char*>(frames.data()),
+			static_cast<int>(frames.size() * sizeof(lmms::SampleFrame))};
+		return bytes.toBase64();
+	}
+
+private slots:
+	void readsSingleChunks()
+	{
+		using namespace lmms;
+
+		const auto dir = QTemporaryDir{};
+		QVERIFY(dir.isValid());
+		const auto path = dir.filePath("chunks.mmpc");
+
+		auto file = QFile{path};
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		auto writer = ProjectArchive::Writer{file};
+		writer.add("plain", QByteArray(100, 'a'), ProjectArchive::Compression::None);
+		writer.add("compressed", QByteArray(100, 'b'), ProjectArchive::Compression::Zlib);
+		QVERIFY(writer.finish());
+		file.close();
+
+		const auto archive = ProjectArchive::open(path);
+		QVERIFY(archive != nullptr);
+		QCOMPARE(archive->chunks().size(), std::size_t{2});
+		QVERIFY(archive->find("compressed")->size < 100);
+		QCOMPARE(archive->read("plain"), QByteArray(100, 'a'));
+		QCOMPARE(archive->read("compressed"), QByteArray(100, 'b'));
+		QVERIFY(archive->read("missing").isEmpty());
+		QCOMPARE(ProjectArchive::open(path), archive);
+	}
+
+	void rejectsTruncatedArchives()
+	{
+		using namespace lmms;
+
+		const auto dir = QTemporaryDir{};
+		QVERIFY(dir.isValid());
+
+		auto buffer = QBuffer{};
+		buffer.open(QIODevice::WriteOnly);
+		auto writer = ProjectArchive::Writer{buffer};
+		writer.add("chunk", QByteArray(100, 'a'), ProjectArchive::Compression::None);
+		QVERIFY(writer.finish());
+
+		const auto path = dir.filePath("truncated.mmpc");
+		auto file = QFile{path};
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		file.write(buffer.data().left(buffer.data().size() - 4));
+		file.close();
+
+		QVERIFY(ProjectArchive::open(path) == nullptr);
+		QVERIFY(ProjectArchive::open(dir.filePath("missing.mmpc")) == nullptr);
+	}
+
+	void roundTripsProjects()
+	{
+		using namespace lmms;
+
+		const auto dir = QTemporaryDir{};
+		QVERIFY(dir.isValid());
+		const auto archivePath = dir.filePath("project.mmpc");
+		const auto exportPath = dir.filePath("project.mmp");
+		const auto data = toBase64(frames());
+
+		auto project = DataFile{DataFile::Type::SongProject};
+		auto clip = project.createElement("sampleclip");
+		clip.setAttribute("data", data);
+		clip.setAttribute("sample_rate", 44100);
+		project.content().appendChild(clip);
+		QVERIFY(project.writeFile(archivePath));
+
+		{
+			// The sample data stays in the archive until the sample is restored
+			auto archived = DataFile{archivePath};
+			const auto element = archived.content().firstChildElement("sampleclip");
+			QVERIFY(ProjectArchive::isChunkReference(element.attribute("data")));
+
+			const auto buffer = SampleBuffer::fromAttribute(element, "data", 44100);
+			QCOMPARE(buffer->size(), frames().size());
+			QVERIFY(std::memcmp(buffer->data(), frames().data(), frames().size() * sizeof(SampleFrame)) == 0);
+
+			QVERIFY(archived.writeFile(exportPath));
+		}
+
+		auto exported = DataFile{exportPath};
+		const auto element = exported.content().firstChildElement("sampleclip");
+		QCOMPARE(element.attribute("data"), data);
+		QVERIFY(!exported.documentElement().hasAttribute(ProjectArchive::PathAttribute));
+	}
+};
+
+QTEST_GUILESS_MAIN(ProjectArchiveTest)
+#include "ProjectArchiveTest.moc"
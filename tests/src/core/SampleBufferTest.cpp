@@ -0,0 +1,153 @@
+/*
+ * SampleBufferTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QDataStream>
+#include <QObject>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "ConfigManager.h"
+#include "SampleBuffer.h"
+#include "SampleDecoder.h"
+
+class SampleBufferTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		// Keeps the decoded sample cache out of the user's cache directory
+		QStandardPaths::setTestModeEnabled(true);
+	}
+
+	void sharesBuffersOfTheSameFile()
+	{
+		using namespace lmms;
+
+		const auto path = ConfigManager::inst()->factorySamplesDir() + "/drums/kick01.ogg";
+		const auto usageBefore = SampleBuffer::cachedMemoryUsage();
+
+		{
+			const auto first = SampleBuffer::fromFile(path);
+			QVERIFY(!first->empty());
+			QCOMPARE(SampleBuffer::fromFile(path), first);
+			// short files are never mapped, so sample clips share them with instruments
+			QCOMPARE(SampleBuffer::fromFile(path, true), first);
+			QCOMPARE(SampleBuffer::cachedMemoryUsage(), usageBefore + first->size() * sizeof(SampleFrame));
+		}
+
+		QCOMPARE(SampleBuffer::cachedMemoryUsage(), usageBefore);
+	}
+
+	void decodesConcurrentLoadsOnce()
+	{
+		using namespace lmms;
+
+		const auto path = ConfigManager::inst()->factorySamplesDir() + "/drums/snare01.ogg";
+		auto buffers = std::vector<std::shared_ptr<const SampleBuffer>>(8);
+		auto threads = std::vector<std::thread>{};
+		for (auto& buffer : buffers)
+		{
+			threads.emplace_back([&buffer, &path] { buffer = SampleBuffer::fromFile(path); });
+		}
+		for (auto& thread : threads) { thread.join(); }
+
+		QVERIFY(!buffers.front()->empty());
+		for (const auto& buffer : buffers) { QCOMPARE(buffer, buffers.front()); }
+	}
+
+	void reloadsChangedFiles()
+	{
+		using namespace lmms;
+
+		const auto dir = QTemporaryDir{};
+		QVERIFY(dir.isValid());
+		const auto path = dir.filePath("sample.ogg");
+		const auto samples = ConfigManager::inst()->factorySamplesDir() + "/drums/";
+
+		QVERIFY(QFile::copy(samples + "kick01.ogg", path));
+		const auto original = SampleBuffer::fromFile(path);
+		QVERIFY(!original->empty());
+
+		QVERIFY(QFile::remove(path));
+		QVERIFY(QFile::copy(samples + "crash01.ogg", path));
+		const auto changed = SampleBuffer::fromFile(path);
+		QVERIFY(changed != original);
+		QVERIFY(changed->size() != original->size());
+	}
+
+	void mapsLongFilesFromTheDecodedCache()
+	{
+		using namespace lmms;
+
+		const auto dir = QTemporaryDir{};
+		QVERIFY(dir.isValid());
+		const auto path = dir.filePath("long.wav");
+
+		// 8-bit mono frames decode to 8 bytes each, so this is just long enough to be memory-mapped
+		const auto frames = (std::uint32_t{64} << 20) / sizeof(SampleFrame) + 1000;
+		{
+			auto file = QFile{path};
+			QVERIFY(file.open(QIODevice::WriteOnly));
+			auto stream = QDataStream{&file};
+			stream.setByteOrder(QDataStream::LittleEndian);
+			stream.writeRawData("RIFF", 4);
+			stream << static_cast<quint32>(36 + frames);
+			stream.writeRawData("WAVEfmt ", 8);
+			stream << quint32{16} << quint16{1} << quint16{1} << quint32{44100} << quint32{44100} << quint16{1}
+				<< quint16{8};
+			stream.writeRawData("data", 4);
+			stream << static_cast<quint32>(frames);
+
+			auto data = QByteArray(frames, Qt::Uninitialized);
+			for (auto i = std::uint32_t{0}; i < frames; ++i) { data[i] = static_cast<char>(i * 7 % 251); }
+			QCOMPARE(file.write(data), static_cast<qint64>(frames));
+		}
+
+		const auto usageBefore = SampleBuffer::cachedMemoryUsage();
+		const auto mapped = SampleBuffer::fromFile(path, true);
+		QVERIFY(mapped->isMapped());
+		QCOMPARE(SampleBuffer::cachedMemoryUsage(), usageBefore);
+
+		// Instruments play a sample from many positions at once, so they get it in memory
+		const auto inMemory = SampleBuffer::fromFile(path);
+		QVERIFY(!inMemory->isMapped());
+		QCOMPARE(inMemory->size(), mapped->size());
+
+		const auto decoded = SampleDecoder::decode(path);
+		QVERIFY(decoded.has_value());
+		QCOMPARE(mapped->sampleRate(), static_cast<sample_rate_t>(decoded->sampleRate));
+		QCOMPARE(mapped->size(), decoded->data.size());
+		QVERIFY(std::equal(mapped->begin(), mapped->end(), decoded->data.begin(),
+			[](const SampleFrame& a, const SampleFrame& b) { return a.left() == b.left() && a.right() == b.right(); }));
+	}
+};
+
+QTEST_GUILESS_MAIN(SampleBufferTest)
+#include "SampleBufferTest.moc"
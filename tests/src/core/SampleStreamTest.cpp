@@ -0,0 +1,118 @@
+/*
+ * SampleStreamTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QObject>
+#include <QtTest>
+#include <memory>
+#include <vector>
+
+#include "SampleBuffer.h"
+#include "SampleStream.h"
+
+namespace {
+
+using lmms::SampleStream;
+
+//! A buffer of three windows, where each frame holds its own index
+auto makeBuffer() -> std::shared_ptr<const lmms::SampleBuffer>
+{
+	auto data = std::vector<lmms::SampleFrame>(3 * SampleStream::Capacity);
+	for (auto i = std::size_t{0}; i < data.size(); ++i)
+	{
+		data[i] = lmms::SampleFrame(static_cast<float>(i), -static_cast<float>(i));
+	}
+	return std::make_shared<const lmms::SampleBuffer>(std::move(data), 44100);
+}
+
+} // namespace
+
+class SampleStreamTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void fillsWindowWhenOpened()
+	{
+		const auto buffer = makeBuffer();
+		const auto stream = SampleStream::open(buffer, SampleStream::Capacity);
+
+		auto view = SampleStream::View{*stream};
+		for (auto frame = SampleStream::Capacity; frame < 2 * SampleStream::Capacity; ++frame)
+		{
+			QCOMPARE(view[frame].left(), static_cast<float>(frame));
+		}
+		QVERIFY(view.complete());
+		QCOMPARE(stream->underruns(), std::size_t{0});
+
+		stream->close();
+	}
+
+	void fillsWindowBackwards()
+	{
+		const auto buffer = makeBuffer();
+		const auto last = 3 * SampleStream::Capacity - 1;
+		const auto stream = SampleStream::open(buffer, last, true);
+
+		auto view = SampleStream::View{*stream};
+		for (auto frame = last; frame >= 2 * SampleStream::Capacity; --frame)
+		{
+			QCOMPARE(view[frame].right(), -static_cast<float>(frame));
+		}
+		QVERIFY(view.complete());
+
+		stream->close();
+	}
+
+	void rendersSilenceForFramesNotReadAhead()
+	{
+		const auto buffer = makeBuffer();
+		const auto stream = SampleStream::open(buffer);
+
+		auto view = SampleStream::View{*stream};
+		QCOMPARE(view[0].left(), 0.f);
+		QCOMPARE(view[2 * SampleStream::Capacity + 1].left(), 0.f);
+		QVERIFY(!view.complete());
+		QCOMPARE(stream->underruns(), std::size_t{1});
+
+		stream->close();
+	}
+
+	void followsPrefetchedPosition()
+	{
+		const auto buffer = makeBuffer();
+		const auto stream = SampleStream::open(buffer);
+		const auto position = 2 * SampleStream::Capacity + 100;
+
+		stream->prefetch(position, false);
+
+		auto view = SampleStream::View{*stream};
+		QCOMPARE(view[position].left(), static_cast<float>(position));
+		QCOMPARE(view[position + 1000].left(), static_cast<float>(position + 1000));
+		QVERIFY(view.complete());
+
+		stream->close();
+	}
+};
+
+QTEST_GUILESS_MAIN(SampleStreamTest)
+#include "SampleStreamTest.moc"
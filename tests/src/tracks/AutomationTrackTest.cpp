@@ -24,6 +24,9 @@
 
 #include <QtTest>
 
+#include <map>
+#include <vector>
+
 
 #include "AutomationClip.h"
 #include "AutomationTrack.h"
@@ -85,6 +88,56 @@ private slots:
 		QCOMPARE(c.valueAt(150), 1.0f);
 	}
 
+	void testClipLookupOrder()
+	{
+		using namespace lmms;
+
+		AutomationClip c(nullptr);
+		c.putValue(10, 0.2f, false);
+		c.putValues(40, 0.9f, 0.1f, false);
+		c.putValue(45, 0.5f, false);
+		c.putValue(100, 1.0f, false);
+
+		// Values computed by the node-map lookup AutomationClip::valueAt() did before using a curve
+		const int times[] = {0, 5, 10, 25, 39, 40, 42, 45, 70, 99, 100, 150};
+		const auto expected = std::map<AutomationClip::ProgressionType, std::vector<float>>{
+			{AutomationClip::ProgressionType::Discrete,
+				{0.f, 0.f, 0.2f, 0.2f, 0.2f, 0.9f, 0.1f, 0.5f, 0.5f, 0.5f, 1.f, 1.f}},
+			{AutomationClip::ProgressionType::Linear,
+				{0.f, 0.f, 0.2f, 0.55f, 0.876666665f, 0.9f, 0.25999999f, 0.5f, 0.727272749f, 0.9909091f, 1.f, 1.f}},
+			{AutomationClip::ProgressionType::CubicHermite,
+				{0.f, 0.f, 0.2f, 0.55f, 0.876666546f, 0.9f, 0.291199982f, 0.5f, 0.827573299f, 0.999777973f, 1.f, 1.f}},
+		};
+
+		for (const auto& [progressionType, values] : expected)
+		{
+			c.setProgressionType(progressionType);
+
+			// Playback looks values up in order, editors anywhere; both must give the same values
+			for (std::size_t i = 0; i < std::size(times); ++i)
+			{
+				QCOMPARE(c.valueAt(times[i]), values[i]);
+			}
+			for (std::size_t i = std::size(times); i-- > 0;)
+			{
+				QCOMPARE(c.valueAt(times[i]), values[i]);
+			}
+			for (std::size_t i = 0; i < std::size(times); ++i)
+			{
+				const auto j = (i * 5) % std::size(times);
+				QCOMPARE(c.valueAt(times[j]), values[j]);
+			}
+		}
+
+		// Edits must be visible to the next lookup
+		c.putValue(40, 0.3f, false);
+		QCOMPARE(c.valueAt(40), 0.3f);
+		c.setProgressionType(AutomationClip::ProgressionType::Discrete);
+		QCOMPARE(c.valueAt(42), 0.3f);
+		c.clear();
+		QCOMPARE(c.valueAt(42), 0.0f);
+	}
+
 	void testClips()
 	{
 		using namespace lmms;
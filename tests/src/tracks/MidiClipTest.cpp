@@ -0,0 +1,135 @@
+/*
+ * MidiClipTest.cpp - tests the note start index used for playback
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include <QtTest>
+
+#include <algorithm>
+
+#include "Engine.h"
+#include "InstrumentTrack.h"
+#include "MidiClip.h"
+#include "Song.h"
+
+class MidiClipTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		using namespace lmms;
+		Engine::init(true);
+	}
+
+	void cleanupTestCase()
+	{
+		using namespace lmms;
+		Engine::destroy();
+	}
+
+	void testNotesStartingAt()
+	{
+		using namespace lmms;
+
+		InstrumentTrack instrumentTrack(Engine::getSong());
+		MidiClip midiClip(&instrumentTrack);
+
+		Note* a = midiClip.addNote(Note(TimePos(48), TimePos(0)), false);
+		Note* b = midiClip.addNote(Note(TimePos(48), TimePos(96)), false);
+		Note* c = midiClip.addNote(Note(TimePos(24), TimePos(0)), false);
+		Note* d = midiClip.addNote(Note(TimePos(24), TimePos(48)), false);
+
+		QCOMPARE(midiClip.notesStartingAt(TimePos(0)).size(), std::size_t{2});
+		for (tick_t tick = 1; tick < 48; ++tick)
+		{
+			QVERIFY(midiClip.notesStartingAt(TimePos(tick)).empty());
+		}
+		QCOMPARE(midiClip.notesStartingAt(TimePos(48)).front(), d);
+		QCOMPARE(midiClip.notesStartingAt(TimePos(96)).front(), b);
+		QVERIFY(midiClip.notesStartingAt(TimePos(97)).empty());
+
+		// jumping back, e.g. when looping
+		const auto started = midiClip.notesStartingAt(TimePos(0));
+		QCOMPARE(started.size(), std::size_t{2});
+		QVERIFY(std::find(started.begin(), started.end(), a) != started.end());
+		QVERIFY(std::find(started.begin(), started.end(), c) != started.end());
+
+		QCOMPARE(midiClip.notesStartingBefore(TimePos(96)).size(), std::size_t{3});
+		QVERIFY(midiClip.notesStartingBefore(TimePos(0)).empty());
+	}
+
+	void testNotesStartingAtAfterEdit()
+	{
+		using namespace lmms;
+
+		InstrumentTrack instrumentTrack(Engine::getSong());
+		MidiClip midiClip(&instrumentTrack);
+
+		Note* a = midiClip.addNote(Note(TimePos(48), TimePos(0)), false);
+		Note* b = midiClip.addNote(Note(TimePos(48), TimePos(48)), false);
+		QCOMPARE(midiClip.notesStartingAt(TimePos(48)).size(), std::size_t{1});
+
+		// moved in place, like the piano roll does
+		a->setPos(TimePos(48));
+		midiClip.dataChanged();
+		QVERIFY(midiClip.notesStartingAt(TimePos(0)).empty());
+		QCOMPARE(midiClip.notesStartingAt(TimePos(48)).size(), std::size_t{2});
+
+		midiClip.removeNote(b);
+		const auto started = midiClip.notesStartingAt(TimePos(48));
+		QCOMPARE(started.size(), std::size_t{1});
+		QCOMPARE(started.front(), a);
+	}
+
+	void testNotesStartingAtManyNotes()
+	{
+		using namespace lmms;
+
+		InstrumentTrack instrumentTrack(Engine::getSong());
+		MidiClip midiClip(&instrumentTrack);
+
+		// added out of order and beyond the index' initial capacity, like when importing MIDI files
+		constexpr int NoteCount = 100;
+		for (int i = 0; i < NoteCount; ++i)
+		{
+			midiClip.addNote(Note(TimePos(12), TimePos((i * 37) % 50 * 12)), false);
+		}
+
+		std::size_t total = 0;
+		for (tick_t tick = 0; tick < 50 * 12; ++tick)
+		{
+			const auto started = midiClip.notesStartingAt(TimePos(tick));
+			const auto expected = std::count_if(midiClip.notes().begin(), midiClip.notes().end(),
+				[tick](const Note* note) { return note->pos().getTicks() == tick; });
+			QCOMPARE(started.size(), static_cast<std::size_t>(expected));
+			for (const auto note : started) { QCOMPARE(note->pos().getTicks(), tick); }
+			total += started.size();
+		}
+		QCOMPARE(total, std::size_t{NoteCount});
+		QCOMPARE(midiClip.notesStartingBefore(TimePos(50 * 12)).size(), std::size_t{NoteCount});
+	}
+};
+
+QTEST_GUILESS_MAIN(MidiClipTest)
+#include "MidiClipTest.moc"